@@ -175,11 +175,19 @@ static void align_worker(HitIterator* hit_it, Search::Config* cfg, int64_t next)
 				continue;
 			}
 
+			// Declared before the matches, which are allocated from these arenas.
+			Util::Memory::ThreadArenas arenas;
+			Util::Memory::ArenaScope arena_scope(&arenas);
 			vector<Extension::Match> matches =
 #ifdef WITH_DNA
 				align_mode.mode == AlignMode::blastn ? Dna::extend(*cfg, cfg->query->seqs()[h->query]) :
 #endif
 				Extension::extend(h->query, h->begin, h->end, *cfg, stat, parallel ? DP::Flags::PARALLEL : DP::Flags::NONE, pool);
+			if (cfg->match_callback) {
+				cfg->match_callback(h->query, matches, *cfg->target);
+				output_sink->push(h->query, nullptr);
+				continue;
+			}
 			TextBuffer* buf = cfg->blocked_processing ? Extension::generate_intermediate_output(matches, h->query, *cfg) : Extension::generate_output(matches, h->query, stat, *cfg);
 			if (!matches.empty() && cfg->track_aligned_queries) {
 				std::lock_guard<std::mutex> lock(query_aligned_mtx);
@@ -210,16 +218,21 @@ void align_queries(File* output_file, Search::Config& cfg)
 	if (!cfg.blocked_processing && !cfg.iterated())
 		cfg.db->init_random_access(cfg.current_query_block, 0, false);
 
-	uint64_t res_size = cfg.query->mem_size() + cfg.target->mem_size();
+	uint64_t res_size = cfg.query->mem_size() + cfg.target->mem_size() + cfg.reserved_mem;
 	cfg.seed_hit_buf->alloc_buffer();
-	cfg.seed_hit_buf->load(std::min(mem_limit - res_size - cfg.seed_hit_buf->next_bin_size() * (uint64_t)sizeof(Search::Hit), config.trace_pt_fetch_size));
+	auto load_budget = [&]() {
+		const int64_t avail = (int64_t)mem_limit - (int64_t)res_size - cfg.seed_hit_buf->resident_mem_size()
+			- (int64_t)cfg.seed_hit_buf->next_bin_size() * (int64_t)sizeof(Search::Hit);
+		return std::min((uint64_t)std::max(avail, (int64_t)0), config.trace_pt_fetch_size);
+	};
+	cfg.seed_hit_buf->load(load_budget());
 	bool goon = true;
 
 	while (goon) {
 		timer.go("Loading trace points");
 		tuple<Search::Hit*, int64_t, BlockId, BlockId> input = cfg.seed_hit_buf->retrieve();
 		statistics.inc(Statistics::TIME_LOAD_SEED_HITS, timer.microseconds());
-		goon = cfg.seed_hit_buf->load(std::min(mem_limit - res_size - cfg.seed_hit_buf->next_bin_size() * (int64_t)sizeof(Search::Hit), config.trace_pt_fetch_size));
+		goon = cfg.seed_hit_buf->load(load_budget());
 		timer.finish();
 		Search::Hit* hit_buf = get<0>(input);
 		const int64_t hit_count = get<1>(input);
@@ -230,7 +243,7 @@ void align_queries(File* output_file, Search::Config& cfg)
 		timer.go("Sorting trace points");
 #ifdef NDEBUG
 		//sort::sort_parallel_blocked_inplace(hit_buf, hit_buf + hit_count, std::less<Search::Hit>(), config.threads_);
-		ips4o::parallel::sort(hit_buf, hit_buf + hit_count, std::less<Search::Hit>(), config.threads_);
+		ips4o::parallel::sort(hit_buf, hit_buf + hit_count, std::less<Search::Hit>(), cfg.align_threads);
 #else
 		std::sort(hit_buf, hit_buf + hit_count);
 #endif
@@ -247,7 +260,7 @@ void align_queries(File* output_file, Search::Config& cfg)
 		if (config.verbosity >= 3 && config.load_balancing == Config::query_parallel && !config.swipe_all && config.heartbeat)
 			heartbeat.reset(new thread(heartbeat_worker, query_range.second, &cfg));
 		const int threads = config.load_balancing == Config::target_parallel || (config.swipe_all && (cfg.target->seqs().size() >= cfg.query->seqs().size())) ? 1
-			: (config.threads_align == 0 ? config.threads_ : config.threads_align);
+			: cfg.align_threads;
 		auto task = [&hit_it, &cfg](ThreadPool& tp, int64_t i) { return align_worker(&hit_it, &cfg, i); };
 		cfg.thread_pool.reset(config.swipe_all ? new ThreadPool(task, query_range.first, query_range.second) : new ThreadPool(task, 0, (int64_t)partition.size() - 1));
 		cfg.thread_pool->run(threads);
@@ -22,7 +22,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/sequence/sequence.h"
 #include "stats/hauser_correction.h"
 
-using std::list;
 using std::array;
 using std::vector;
 
@@ -102,12 +101,11 @@ static TargetVec recompute_alt_hsps(const Sequence* query_seq, const int query_s
 		const int8_t* cbs = ::Stats::CBS::hauser(config.comp_based_stats) ? query_cb[context].int8.data() : nullptr;
 		DP::Params params{ query_seq[context], "", Frame(context), query_source_len, cbs, DP::Flags::FULL_MATRIX, false, 0, -1,
 			v, stats, nullptr };
-		list<Hsp> hsp = DP::BandedSwipe::swipe(dp_targets[context], params);
-		while (!hsp.empty()) {
-			ActiveTarget& t = targets[hsp.front().swipe_target];
-			list<Hsp>& l = t.match->hsp;
-			l.splice(l.end(), hsp, hsp.begin());
-			std::fill(t.masked_seq[context] + l.back().subject_range.begin_, t.masked_seq[context] + l.back().subject_range.end_, SUPER_HARD_MASK);
+		HspVector hsp = DP::BandedSwipe::swipe(dp_targets[context], params);
+		for (Hsp& h : hsp) {
+			ActiveTarget& t = targets[h.swipe_target];
+			std::fill(t.masked_seq[context] + h.subject_range.begin_, t.masked_seq[context] + h.subject_range.end_, SUPER_HARD_MASK);
+			t.match->add_hit(std::move(h));
 			t.active |= 1 << context;
 		}
 	}
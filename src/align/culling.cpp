@@ -27,30 +27,33 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "culling.h"
 
 using std::vector;
-using std::list;
 
 namespace Extension {
 
-static void max_hsp_culling(list<Hsp>& hsps) {
+static void max_hsp_culling(HspVector& hsps) {
 	if (config.max_hsps > 0 && hsps.size() > config.max_hsps)
 		hsps.resize(config.max_hsps);
 }
 
-static void inner_culling(list<Hsp>& hsps) {
+// Culling by index: the HSPs that are kept are compacted to the front of the vector, each one is
+// tested against the kept HSPs of higher rank.
+static void inner_culling(HspVector& hsps) {
 	if (hsps.size() <= 1)
 		return;
-	hsps.sort();
+	std::stable_sort(hsps.begin(), hsps.end());
 	if (config.max_hsps == 1) {
 		hsps.resize(1);
 		return;
 	}
 	const double overlap = config.inner_culling_overlap / 100.0;
-	for (list<Hsp>::iterator i = hsps.begin(); i != hsps.end();) {
-		if (i->is_enveloped_by(hsps.begin(), i, overlap))
-			i = hsps.erase(i);
-		else
-			++i;
-	}
+	size_t n = 0;
+	for (size_t i = 0; i < hsps.size(); ++i)
+		if (!hsps[i].is_enveloped_by(hsps.cbegin(), hsps.cbegin() + n, overlap)) {
+			if (i != n)
+				hsps[n] = std::move(hsps[i]);
+			++n;
+		}
+	hsps.resize(n);
 	if (config.max_hsps > 0)
 		max_hsp_culling(hsps);
 }
@@ -58,22 +61,22 @@ static void inner_culling(list<Hsp>& hsps) {
 void Target::inner_culling() {
 	if (config.max_hsps == 1) {
 		for (int i = 0; i < MAX_CONTEXT; ++i)
-			if (i == best_context) {
-				hsp[i].sort();
+			if (i == best_context && !hsp[i].empty()) {
+				auto best = std::min_element(hsp[i].begin(), hsp[i].end());
+				if (best != hsp[i].begin())
+					hsp[i].front() = std::move(*best);
 				hsp[i].resize(1);
 			}
 			else
 				hsp[i].clear();
 		return;
 	}
-	list<Hsp> hsps;
+	HspVector hsps;
 	for (int frame = 0; frame < align_mode.query_contexts; ++frame)
-		hsps.splice(hsps.end(), hsp[frame]);
+		append(hsps, std::move(hsp[frame]));
 	Extension::inner_culling(hsps);
-	while (!hsps.empty()) {
-		auto& l = hsp[hsps.front().frame];
-		l.splice(l.end(), hsps, hsps.begin());
-	}
+	for (Hsp& h : hsps)
+		hsp[h.frame].push_back(std::move(h));
 }
 
 void Match::inner_culling()
@@ -174,12 +177,9 @@ void Match::apply_filters(int source_query_len, const char *query_title, const S
 	const Sequence seq = targets.seqs()[target_block_id];
 	const int len = seq.length();
 	const double self_aln = targets.has_self_aln() ? targets.self_aln_score(target_block_id) : 0.0;
-	for (list<Hsp>::iterator i = hsp.begin(); i != hsp.end();) {
-		if (filter_hsp(*i, source_query_len, query_title, len, title, query_seq, seq, query_self_aln_score, self_aln, output_format))
-			i = hsp.erase(i);
-		else
-			++i;
-	}
+	hsp.erase(std::remove_if(hsp.begin(), hsp.end(), [&](Hsp& h) {
+		return filter_hsp(h, source_query_len, query_title, len, title, query_seq, seq, query_self_aln_score, self_aln, output_format);
+		}), hsp.end());
 	filter_evalue = hsp.empty() ? DBL_MAX : hsp.front().evalue;
 	filter_score = hsp.empty() ? 0 : hsp.front().score;
 }
@@ -156,7 +156,7 @@ static vector<Match> seed_only_matches(BlockId query_id, const Search::Config& c
 		Match match(target_block_id, cfg.target->seqs()[target_block_id], nullptr, target_score.score, target_score.score, 0.0);
 		for (auto i = l.seed_hits.begin(target_score.target); i < l.seed_hits.end(target_score.target); ++i)
 			match.hsp.push_back(seed_only_hsp(*i, query_source_len));
-		match.hsp.sort();
+		std::stable_sort(match.hsp.begin(), match.hsp.end());
 		if (config.max_hsps > 0 && match.hsp.size() > config.max_hsps)
 			match.hsp.resize(config.max_hsps);
 		matches.push_back(std::move(match));
@@ -18,7 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #pragma once
-#include <list>
+#include <vector>
 #include <array>
 #include "basic/match.h"
 #include "basic/statistics.h"
@@ -41,8 +41,8 @@ struct Match {
 		filter_evalue(filter_evalue),
 		ungapped_score(ungapped_score)
 	{}
-	void add_hit(std::list<Hsp> &list, std::list<Hsp>::iterator it) {
-		hsp.splice(hsp.end(), list, it);
+	void add_hit(Hsp&& h) {
+		hsp.push_back(std::move(h));
 	}
 	static bool cmp_evalue(const Match& m, const Match& n) {
 		return m.filter_evalue < n.filter_evalue || (m.filter_evalue == n.filter_evalue && cmp_score(m, n));
@@ -50,7 +50,7 @@ struct Match {
 	static bool cmp_score(const Match& m, const Match& n) {
 		return m.filter_score > n.filter_score || (m.filter_score == n.filter_score && m.target_block_id < n.target_block_id);
 	}
-	Match(BlockId target_block_id, const Sequence& seq, std::unique_ptr<::Stats::TargetMatrix>&& matrix, std::array<std::list<Hsp>, MAX_CONTEXT> &hsp, int ungapped_score);
+	Match(BlockId target_block_id, const Sequence& seq, std::unique_ptr<::Stats::TargetMatrix>&& matrix, std::array<HspVector, MAX_CONTEXT> &hsp, int ungapped_score);
 	static Match self_match(BlockId query_id, Sequence query_seq);
 	void inner_culling();
 	void max_hsp_culling();
@@ -61,7 +61,7 @@ struct Match {
 	int filter_score;
 	double filter_evalue;
 	int ungapped_score;
-	std::list<Hsp> hsp;
+	HspVector hsp;
 };
 
 std::vector<Match> extend(BlockId query_id, Search::Hit* begin, Search::Hit* end, const Search::Config &cfg, Statistics &stat, DP::Flags flags, std::pmr::monotonic_buffer_resource& pool);
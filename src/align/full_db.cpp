@@ -21,7 +21,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "target.h"
 #include "dp/dp.h"
 
-using std::list;
 using std::map;
 using std::vector;
 
@@ -30,7 +29,7 @@ namespace Extension {
 vector<Target> full_db_align(const Sequence* query_seq, const HauserCorrection* query_cb, DP::Flags flags, const HspValues hsp_values, Statistics& stat, const Block& target_block) {
 	vector<DpTarget> v;
 	vector<Target> r;
-	list<Hsp> hsp;
+	HspVector hsp;
 	const SequenceSet& ref_seqs = target_block.seqs();
 
 	for (int frame = 0; frame < align_mode.query_contexts; ++frame) {
@@ -48,18 +47,19 @@ vector<Target> full_db_align(const Sequence* query_seq, const HauserCorrection*
 			stat,
 			nullptr
 		};
-		list<Hsp> frame_hsp = DP::BandedSwipe::swipe_set(ref_seqs.cbegin(), ref_seqs.cend(), params);
-		hsp.splice(hsp.begin(), frame_hsp, frame_hsp.begin(), frame_hsp.end());
+		HspVector frame_hsp = DP::BandedSwipe::swipe_set(ref_seqs.cbegin(), ref_seqs.cend(), params);
+		append(frame_hsp, std::move(hsp));
+		hsp = std::move(frame_hsp);
 	}
 
 	map<BlockId, BlockId> subject_idx;
-	while (!hsp.empty()) {
-		BlockId block_id = hsp.begin()->swipe_target;
+	for (Hsp& h : hsp) {
+		BlockId block_id = h.swipe_target;
 		const auto it = subject_idx.emplace(block_id, (BlockId)r.size());
 		if (it.second)
 			r.emplace_back(block_id, ref_seqs[block_id], 0, nullptr);
 		BlockId i = it.first->second;
-		r[i].add_hit(hsp, hsp.begin());
+		r[i].add_hit(std::move(h));
 	}
 
 	return r;
@@ -25,7 +25,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "def.h"
 
 using std::array;
-using std::list;
 using std::vector;
 
 namespace Extension {
@@ -137,9 +136,9 @@ vector<Match> align(vector<Target>& targets, const int64_t previous_matches, con
 				stat,
 				cfg.thread_pool.get()
 			};
-			list<Hsp> hsp = DP::BandedSwipe::swipe(dp_targets[frame], params);
-			while (!hsp.empty())
-				r[hsp.front().swipe_target].add_hit(hsp, hsp.begin());
+			HspVector hsp = DP::BandedSwipe::swipe(dp_targets[frame], params);
+			for (Hsp& h : hsp)
+				r[h.swipe_target].add_hit(std::move(h));
 		}
 
 		for (int64_t i = matches_begin; i < (int64_t)r.size(); ++i)
@@ -29,7 +29,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 using std::runtime_error;
 using std::vector;
 using std::array;
-using std::list;
 using std::map;
 using std::endl;
 using std::unique_ptr;
@@ -84,7 +83,7 @@ static int hsp_band(int base_band, int qlen, int tlen, const ApproxHsp& hsp) {
 	return base_band;
 }
 
-Match::Match(BlockId target_block_id, const Sequence& seq, unique_ptr<::Stats::TargetMatrix>&& matrix, array<list<Hsp>, MAX_CONTEXT>& hsps, int ungapped_score) :
+Match::Match(BlockId target_block_id, const Sequence& seq, unique_ptr<::Stats::TargetMatrix>&& matrix, array<HspVector, MAX_CONTEXT>& hsps, int ungapped_score) :
 	target_block_id(target_block_id),
 	seq(seq),
 	matrix(std::move(matrix)),
@@ -94,12 +93,14 @@ Match::Match(BlockId target_block_id, const Sequence& seq, unique_ptr<::Stats::T
 {
 	if (config.max_hsps != 1)
 		throw runtime_error("Match::Match max_hsps != 1.");
+	Hsp* best = nullptr;
 	for (int i = 0; i < align_mode.query_contexts; ++i)
-		hsp.splice(hsp.end(), hsps[i]);
-	if (hsp.empty())
+		for (Hsp& h : hsps[i])
+			if (best == nullptr || h < *best)
+				best = &h;
+	if (best == nullptr)
 		throw runtime_error("Match::Match hsp.empty()");
-	hsp.sort();
-	hsp.resize(1);
+	hsp.push_back(std::move(*best));
 	filter_evalue = hsp.front().evalue;
 	filter_score = hsp.front().score;
 }
@@ -227,10 +228,10 @@ vector<Target> align(vector<WorkTarget>& targets, const Sequence* query_seq, con
 		DP::AnchoredSwipe::Config acfg{ query_seq[frame],
 			::Stats::CBS::hauser(config.comp_based_stats) ? query_cb[frame].int8.data() : nullptr,
 			0, stat, &tp, config.comp_based_stats == Stats::CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST, cfg.extension_mode, false };
-		list<Hsp> hsp = config.anchored_swipe
+		HspVector hsp = config.anchored_swipe
 			? DP::BandedSwipe::anchored_swipe(dp_targets[frame], acfg, pool) : DP::BandedSwipe::swipe(dp_targets[frame], params);
-		while (!hsp.empty())
-			r[hsp.front().swipe_target].add_hit(hsp, hsp.begin());
+		for (Hsp& h : hsp)
+			r[h.swipe_target].add_hit(std::move(h));
 	}
 	
 	vector<Target> r2;
@@ -161,14 +161,11 @@ void Pipeline::run_swipe(bool score_only)
 	vector<DpTarget> vf, vr;
 	for (int64_t i = 0; i < n_targets(); ++i)
 		target(i).add(*this, vf, vr, (int)i);
-	list<Hsp> hsp;
-	hsp = banded_3frame_swipe(translated_query, FORWARD, vf.begin(), vf.end(), this->dp_stat, score_only, target_parallel);
-	hsp.splice(hsp.end(), banded_3frame_swipe(translated_query, REVERSE, vr.begin(), vr.end(), this->dp_stat, score_only, target_parallel));
+	HspVector hsp = banded_3frame_swipe(translated_query, FORWARD, vf.begin(), vf.end(), this->dp_stat, score_only, target_parallel);
+	append(hsp, banded_3frame_swipe(translated_query, REVERSE, vr.begin(), vr.end(), this->dp_stat, score_only, target_parallel));
 	
-	while (!hsp.empty()) {
-		list<Hsp> &l = target(hsp.begin()->swipe_target).hsps;
-		l.splice(l.end(), hsp, hsp.begin());
-	}
+	for (Hsp& h : hsp)
+		target(h.swipe_target).hsps.push_back(std::move(h));
 }
 
 void build_ranking_worker(PtrVector<::Target>::iterator begin, PtrVector<::Target>::iterator end, atomic<size_t> *next, vector<int32_t> *intervals) {
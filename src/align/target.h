@@ -67,7 +67,7 @@ struct SeedHit {
 };
 
 struct WorkTarget {
-	WorkTarget(BlockId block_id, const Sequence& seq, Sequence query, Loc query_len_true_aa, const ::Stats::Composition& query_comp, Loc max_target_len, Statistics& stats, std::pmr::monotonic_buffer_resource& pool);
+	WorkTarget(BlockId block_id, const Sequence& seq, const uint16_t* aa_counts, Sequence query, Loc query_len_true_aa, const ::Stats::Composition& query_comp, Loc max_target_len, Statistics& stats, std::pmr::monotonic_buffer_resource& pool);
 	BlockId block_id;
 	Sequence seq;
 	std::array<int, MAX_CONTEXT> ungapped_score;
@@ -94,17 +94,8 @@ struct Target {
 	}
 
 	void add_hit(Hsp&& hsp) {
-		if(hsp.evalue < filter_evalue) {
-			filter_evalue = hsp.evalue;
-			filter_score = hsp.score;
-			best_context = hsp.frame;
-		}
-		this->hsp[hsp.frame].push_back(std::move(hsp));
-	}
-
-	void add_hit(std::list<Hsp> &list, std::list<Hsp>::iterator it) {
-		std::list<Hsp> &l = hsp[it->frame];
-		l.splice(l.end(), list, it);
+		HspVector &l = this->hsp[hsp.frame];
+		l.push_back(std::move(hsp));
 		if (l.back().score > filter_score) { // should be evalue
 			filter_evalue = l.back().evalue;
 			filter_score = l.back().score;
@@ -138,7 +129,7 @@ struct Target {
 	double filter_evalue;
 	int best_context;
 	int ungapped_score;
-	std::array<std::list<Hsp>, MAX_CONTEXT> hsp;
+	std::array<HspVector, MAX_CONTEXT> hsp;
 	std::unique_ptr<::Stats::TargetMatrix> matrix;
 	bool done;
 };
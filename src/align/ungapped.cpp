@@ -41,15 +41,19 @@ using std::pair;
 
 namespace Extension {
 
-WorkTarget::WorkTarget(BlockId block_id, const Sequence& seq, Sequence query, Loc query_len_true_aa, const ::Stats::Composition& query_comp, Loc max_target_len, Statistics& stats, std::pmr::monotonic_buffer_resource& pool) :
+WorkTarget::WorkTarget(BlockId block_id, const Sequence& seq, const uint16_t* aa_counts, Sequence query, Loc query_len_true_aa, const ::Stats::Composition& query_comp, Loc max_target_len, Statistics& stats, std::pmr::monotonic_buffer_resource& pool) :
 	block_id(block_id),
 	seq(seq),
 	done(false)
 {
 	ungapped_score.fill(0);
-	Stats::EMatrixAdjustRule rule;
-	if (!config.anchored_swipe && (rule = ::Stats::adjust_matrix(query_comp, query_len_true_aa, config.comp_based_stats, seq)) != Stats::eDontAdjustMatrix) {
-		matrix.reset(new ::Stats::TargetMatrix(query_comp, query_len_true_aa, config.comp_based_stats, seq, stats, pool, rule));
+	if (config.anchored_swipe || !::Stats::CBS::matrix_adjust(config.comp_based_stats))
+		return;
+	const ::Stats::Composition target_comp = aa_counts ? ::Stats::composition(aa_counts) : ::Stats::composition(seq);
+	const Stats::EMatrixAdjustRule rule = ::Stats::adjust_matrix(query_comp, query_len_true_aa, config.comp_based_stats, seq.length(), target_comp);
+	if (rule != Stats::eDontAdjustMatrix) {
+		const int target_true_aa = aa_counts ? ::Stats::count_true_aa(aa_counts) : ::Stats::count_true_aa(seq);
+		matrix.reset(new ::Stats::TargetMatrix(query_comp, query_len_true_aa, config.comp_based_stats, target_comp, target_true_aa, stats, pool, rule));
 		/*if (config.anchored_swipe) {
 			TaskTimer timer;
 			profile = DP::make_profile16(query, *matrix, query.length() + max_target_len + 32);
@@ -65,7 +69,7 @@ WorkTarget ungapped_stage(FlatArray<SeedHit>::DataIterator begin, FlatArray<Seed
 	//const bool masking = config.comp_based_stats == ::Stats::CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST ? ::Stats::use_seg_masking(query_seq[0], ref_seqs_unmasked[block_id]) : true;
 	const bool masking = true;
 	const bool with_diag_filter = (config.hamming_ext || config.diag_filter_cov.present() || config.diag_filter_id.present()) && !config.mutual_cover.present() && align_mode.query_contexts == 1;
-	WorkTarget target(block_id, masking ? ref_seqs[block_id] : ref_seqs_unmasked[block_id], *query_seq, ::Stats::count_true_aa(query_seq[0]), query_comp, max_target_len, stats, pool);
+	WorkTarget target(block_id, masking ? ref_seqs[block_id] : ref_seqs_unmasked[block_id], masking ? targets.aa_counts(block_id) : nullptr, *query_seq, ::Stats::count_true_aa(query_seq[0]), query_comp, max_target_len, stats, pool);
 	
 	if (mode == Mode::FULL) {
 		for (FlatArray<SeedHit>::DataIterator hit = begin; hit < end; ++hit)
@@ -201,6 +201,8 @@ void Statistics::print() const
 	if (data_[MASKED_LAZY])
 		*log_stream << "Lazy maskings         = " << data_[MASKED_LAZY] << endl;
 	*log_stream << "Matrix adjusts        = " << data_[MATRIX_ADJUST_COUNT] << endl;
+	if (data_[MATRIX_ADJUST_CACHE_HITS] + data_[MATRIX_ADJUST_CACHE_MISSES] > 0)
+		*log_stream << "Matrix adjust cache   = " << data_[MATRIX_ADJUST_CACHE_HITS] << " hits, " << data_[MATRIX_ADJUST_CACHE_MISSES] << " misses" << endl;
 	*log_stream << "Comp. based stats     = " << data_[COMP_BASED_STATS_COUNT] << endl;
 	*log_stream << "Failed cbs            = " << data_[FAILED_COMP_BASED_STATS] << endl;
 	*log_stream << "Extensions (8 bit)    = " << data_[EXT8] << endl;
@@ -246,6 +248,8 @@ void Statistics::print() const
 	*log_stream << "Time (Load seed hits)        = " << (double)data_[TIME_LOAD_SEED_HITS] / 1e6 << "s (wall)" << endl;
 	*log_stream << "Time (Sort seed hits)        = " << (double)data_[TIME_SORT_SEED_HITS] / 1e6 << "s (wall)" << endl;
 	*log_stream << "Time (Extension)             = " << (double)data_[TIME_EXT] / 1e6 << "s (wall)" << endl;
+	*log_stream << "Time (Load dictionary)       = " << (double)data_[TIME_LOAD_DICT] / 1e6 << "s (wall)" << endl;
+	*log_stream << "Time (Join output blocks)    = " << (double)data_[TIME_JOIN] / 1e6 << "s (wall)" << endl;
 	//log_stream << "Time (greedy extension)      = " << data_[TIME_GREEDY_EXT]/1e9 << "s" << endl;
 	//log_stream << "Gapped hits = " << data_[GAPPED_HITS] << endl;
 	//log_stream << "Overlap hits = " << data_[DUPLICATES] << endl;
@@ -38,6 +38,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "basic/shape.h"
 #include "output/output_format.h"
 #include "data/sequence_file.h"
+#include "util/parallel/coordinator.h"
 
 using std::runtime_error;
 using std::thread;
@@ -83,7 +84,8 @@ const SEMap<Sensitivity> EnumTraits<Sensitivity>::from_string = {
 
 const SEMap<GraphAlgo> EnumTraits<GraphAlgo>::from_string = {
 	{ "gvc", GraphAlgo::GREEDY_VERTEX_COVER },
-	{ "len", GraphAlgo::LEN_SORTED }
+	{ "len", GraphAlgo::LEN_SORTED },
+	{ "pgvc", GraphAlgo::PARALLEL_GREEDY_VERTEX_COVER }
 };
 
 const EMap<Config::Algo> EnumTraits<Config::Algo>::to_string = { { Config::Algo::DOUBLE_INDEXED, "Double-indexed" }, { Config::Algo::QUERY_INDEXED, "Query-indexed"}, {Config::Algo::CTG_SEED, "Query-indexed with contiguous seed"} };
@@ -136,6 +138,19 @@ T set_string_option(const string& s, const string& name, const vector<pair<strin
 	throw std::runtime_error("Invalid argument for option " + name + ". Allowed values are:" + std::accumulate(values.begin(), values.end(), string(), [](const string& s, const pair<string, T>& v) { return s + ' ' + v.first; }));
 }
 
+// Picks the largest power of 2 tile size for which the fingerprints of a query and target tile plus
+// the hit field of the tile fill at most half of the L2 cache.
+static uint32_t auto_tile_size() {
+	const size_t l2 = l2_cache_size();
+	if (l2 == 0)
+		return 1024;
+	auto working_set = [](size_t t) { return 2 * t * 48 + t * t / 8; };
+	uint32_t t = 256;
+	while (t < 4096 && working_set(t * 2) <= l2 / 2)
+		t *= 2;
+	return t;
+}
+
 void Config::set_sens(Sensitivity sens) {
 	if (sensitivity != Sensitivity::DEFAULT)
 		throw runtime_error("Sensitivity switches are mutually exclusive.");
@@ -185,6 +200,7 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		.add_command("roc", "", roc)
 		.add_command("benchmark", "", benchmark)
 		.add_command("deepclust", "", DEEPCLUST)
+		.add_command("coordinator", "Run the coordinator process of a multi-process run", COORDINATOR)
 #ifdef EXTRA
 		.add_command("random-seqs", "", random_seqs)
 		.add_command("sort", "", sort)
@@ -236,7 +252,8 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
     string dbstring;
 	auto& makedb_opt = parser.add_group("Makedb options", { makedb, MERGE_DAA });
 	makedb_opt.add()
-		("in", 0, "input reference file in FASTA format/input DAA files for merge-daa", input_ref_file);
+		("in", 0, "input reference file in FASTA format/input DAA files for merge-daa", input_ref_file)
+		("accession-index", 0, "build an index of sequence accessions for --seqidlist and getseq", accession_index);
 
 	auto& makedb_tax_opt = parser.add_group("Makedb/taxon options", { makedb });
 	makedb_tax_opt.add()
@@ -244,7 +261,7 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("taxonnodes", 0, "taxonomy nodes.dmp from NCBI", nodesdmp)
 		("taxonnames", 0, "taxonomy names.dmp from NCBI", namesdmp);
 
-	auto& align_clust_realign = parser.add_group("Aligner/Clustering/Realign options", { blastp, blastx, cluster, RECLUSTER, CLUSTER_REASSIGN, DEEPCLUST, CLUSTER_REALIGN, LINCLUST });
+	auto& align_clust_realign = parser.add_group("Aligner/Clustering/Realign options", { blastp, blastx, cluster, RECLUSTER, CLUSTER_REASSIGN, DEEPCLUST, CLUSTER_REALIGN, LINCLUST, makeidx });
 	align_clust_realign.add()
 		("comp-based-stats", 0, "composition based statistics mode (0-4)", comp_based_stats, 1u)
 		("masking", 0, "masking algorithm (none, seg, tantan=default)", masking_)
@@ -284,6 +301,12 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("ultra-sensitive", 0, "enable ultra sensitive mode", mode_ultra_sensitive)
 		("shapes", 's', "number of seed shapes (default=all available)", shapes);
 
+	auto& aligner_idx = parser.add_group("Aligner/index options", { blastp, blastx, makeidx });
+	aligner_idx.add()
+		("block-size", 'b', "sequence block size in billions of letters (default=2.0)", chunk_size)
+		("fit-memory", 0, "choose block size and index chunks so that the estimated memory use fits the memory limit", fit_memory)
+		("seed-array-index", 0, "build/use a persistent reference seed array index", seed_array_index);
+
 	auto& aligner = parser.add_group("Aligner options", { blastp, blastx });
 	aligner.add()
 		("query", 'q', "input query file", query_file)
@@ -302,7 +325,6 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("swipe", 0, "exhaustive alignment against all database sequences", swipe_all)
 		("iterate", 0, "iterated search with increasing sensitivity", iterate, Option<vector<string>>(), 0)
 		("global-ranking", 'g', "number of targets for global ranking", global_ranking_targets)
-		("block-size", 'b', "sequence block size in billions of letters (default=2.0)", chunk_size)
 		("index-chunks", 'c', "number of chunks for index processing (default=4)", lowmem_)
 		("frameshift", 'F', "frame shift penalty (default=disabled)", frame_shift)
 		("long-reads", 0, "short for --range-culling --top 10 -F 15", long_reads)
@@ -311,7 +333,10 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("sallseqid", 0, "include all subject ids in DAA file", sallseqid)
 		("no-self-hits", 0, "suppress reporting of identical self hits", no_self_hits)
 		("taxonlist", 0, "restrict search to list of taxon ids (comma-separated)", taxonlist)
-		("taxon-exclude", 0, "exclude list of taxon ids (comma-separated)", taxon_exclude)
+		("taxon-exclude", 0, "exclude list of taxon ids (comma-separated)", taxon_exclude);
+
+	auto& seqidlist_opt = parser.add_group("Aligner/getseq options", { blastp, blastx, getseq });
+	seqidlist_opt.add()
 		("seqidlist", 0, "filter the database by list of accessions", seqidlist)
 		("skip-missing-seqids", 0, "ignore accessions missing in the database", skip_missing_seqids);
 
@@ -358,7 +383,7 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("aln-out", 0, "Output file for clustering alignments", aln_out)
 		("reps", 0, "Output file for representative sequences in FASTA format. Only includes id and sequence (no additional header data).", reps_out);
 
-	auto& memory_opt = parser.add_group("Memory options", { cluster, RECLUSTER, CLUSTER_REASSIGN, GREEDY_VERTEX_COVER, DEEPCLUST, LINCLUST, CLUSTER_REALIGN });
+	auto& memory_opt = parser.add_group("Memory options", { blastp, blastx, cluster, RECLUSTER, CLUSTER_REASSIGN, GREEDY_VERTEX_COVER, DEEPCLUST, LINCLUST, CLUSTER_REALIGN });
 	memory_opt.add()
 		("memory-limit", 'M', "Memory limit in GB (default = 16G)", memory_limit);
 
@@ -366,7 +391,8 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 	cluster_reassign_opt.add()
 		("member-cover", 0, "Minimum coverage% of the cluster member sequence (default=80.0)", member_cover)
 		("mutual-cover", 0, "Minimum mutual coverage% of the cluster member and representative sequence", mutual_cover)
-		("no-reassign", 0, "Do not reassign to closest representative", no_gvc_reassign);
+		("no-reassign", 0, "Do not reassign to closest representative", no_gvc_reassign)
+		("graph-algo", 0, "Vertex cover algorithm (gvc/pgvc=parallel, default=gvc)", graph_algo, string("gvc"));
 
 	auto& gvc_opt = parser.add_group("GVC options", { GREEDY_VERTEX_COVER });
 	gvc_opt.add()
@@ -391,6 +417,12 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("ignore-warnings", 0, "Ignore warnings", ignore_warnings)
 		("no-parse-seqids", 0, "Print raw seqids without parsing", no_parse_seqids);
 
+	auto& coordination = parser.add_group("Coordination options", { blastp, blastx, cluster, DEEPCLUST, LINCLUST, COORDINATOR });
+	coordination.add()
+		("coordinator", 0, "address of the coordinator process for multi-process runs (host:port or Unix socket path, :port for loopback)", coordinator)
+		("coordinator-token", 0, "shared secret of the coordinator and its clients (default: $DIAMOND_COORDINATOR_TOKEN)", coordinator_token)
+		("shutdown", 0, "stop the coordinator process running at --coordinator (coordinator command)", coordinator_shutdown);
+
 	auto& advanced_aln_cluster = parser.add_group("Advanced options aln/cluster", { blastp, blastx, blastn, CLUSTER_REASSIGN, regression_test, cluster, DEEPCLUST, LINCLUST, RECLUSTER });
 	advanced_aln_cluster.add()
 		("parallel-tmpdir", 0, "directory for temporary files used by multiprocessing", parallel_tmpdir)
@@ -406,6 +438,8 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("query-match-distance-threshold", 0, "Matrix adjust threshold", query_match_distance_threshold, -1.0)
 		("length-ratio-threshold", 0, "Matrix adjust threshold", length_ratio_threshold, -1.0)
 		("cbs-angle", 0, "Matrix adjust threshold", cbs_angle, -1.0)
+		("matrix-adjust-cache", 0, "cache adjusted matrices for up to this many composition signatures (default=0=off)", matrix_adjust_cache, (int64_t)0)
+		("matrix-adjust-cache-steps", 0, "quantization steps per unit of amino acid frequency for --matrix-adjust-cache (default=10000)", matrix_adjust_cache_steps, 10000)
 		("linclust-banded-ext", 0, "Use banded instead of full matrix DP for linear searches", linclust_banded_ext)
 		("hit-membuf", 0, "Buffer intermediate hits in memory", hit_membuf);
 
@@ -415,12 +449,17 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("min-orf", 'l', "ignore translated sequences without an open reading frame of at least this length", run_len)
 		("min-query-len", 0, "filter query sequences shorter than this length", min_query_len)
 		("load-threads", 0, "number of CPU threads for file I/O", load_threads, 16)
+		("pipeline", 0, "overlap seed search of the next reference block with alignment of the current block", pipeline)
+		("prefetch", 0, "load the next reference block in the background while the current block is processed", prefetch)
+		("hit-buffer-mem", 0, "keep seed hits compressed in memory up to this size before spilling to temporary files", hit_buffer_mem)
+		("serve", 0, "keep the database open and process query batches received on this Unix socket", serve)
+		("serve-query", 0, "send the query file to the --serve process on this socket and write its output", serve_query)
 		("minichunk", 0, "Mini chunk size for file I/O", minichunk, (size_t)262144)
 		("seed-cut", 0, "cutoff for seed complexity", seed_cut_)
 		("freq-masking", 0, "mask seeds based on frequency", freq_masking)
 		("freq-sd", 0, "number of standard deviations for ignoring frequent seeds", freq_sd_, 0.0)
 		("sketch-size", 0, "Subsample seeds based on minimizer sketch of the given size", sketch_size)
-		("tile-size", 0, "Loop tiling size (default=1024)", tile_size, (uint32_t)1024)
+		("tile-size", 0, "Loop tiling size (default=auto from L2 cache size)", tile_size, (uint32_t)0)
 		("id2", 0, "minimum number of identities for stage 1 hit", min_identities_)
 		("linsearch", 0, "only consider seed hits against longest target for identical seeds", lin_stage1_target)
 		("lin-stage1", 0, "only consider seed hits against longest query for identical seeds", lin_stage1_query)
@@ -640,7 +679,6 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		("classic-band", 0, "", classic_band)
 		("no_8bit_extension", 0, "", no_8bit_extension)
 		("no_chaining_merge_hsps", 0, "", no_chaining_merge_hsps)
-		("graph-algo", 0, "", graph_algo, string("gvc"))
 		("tsv-read-size", 0, "", tsv_read_size, int64_t(GIGABYTES))
 		("max-indirection", 0, "", max_indirection)
 		("promiscuous-seed-ratio", 0 , "", promiscuous_seed_ratio, 1000.0);
@@ -713,7 +751,7 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 		case Config::blastp:
 		case Config::blastx:
         case Config::blastn:
-			if (database == "")
+			if (database == "" && !serve_query)
 				throw runtime_error("Missing parameter: database file (--db/-d)");
 			if (daa_file.length() > 0) {
 				if (output_file.length() > 0)
@@ -779,6 +817,9 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 	*log_stream << "Assertions enabled." << endl;
 #endif
 	set_option(threads_, (int)std::thread::hardware_concurrency());
+	if (tile_size == 0)
+		tile_size = auto_tile_size();
+	*log_stream << "Tile size: " << tile_size << endl;
 
 	switch (command) {
 	case Config::makedb:
@@ -819,12 +860,18 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 	case Config::RECLUSTER:
 	case Config::MODEL_SEQS:
 	case Config::MAKE_SEED_TABLE:
+	case Config::makeidx:
 		if (frame_shift != 0 && command == Config::blastp)
 			throw runtime_error("Frameshift alignments are only supported for translated searches.");
 		if (query_range_culling && frame_shift == 0)
 			throw runtime_error("Query range culling is only supported in frameshift alignment mode (option -F).");
 		if (matrix_file == "") {
 			score_matrix = ScoreMatrix(to_upper_case(matrix), gap_open, gap_extend, frame_shift, stop_match_score, 0, cbs_matrix_scale);
+			if (matrix_adjust_cache > 0) {
+				if (matrix_adjust_cache_steps <= 0)
+					throw runtime_error("--matrix-adjust-cache-steps must be positive.");
+				score_matrix.init_matrix_adjust_cache(matrix_adjust_cache, matrix_adjust_cache_steps);
+			}
 			//blosum80 = ScoreMatrix("BLOSUM80", 11, 1, frame_shift, stop_match_score, 0, cbs_matrix_scale);
 			//pam70 = ScoreMatrix("PAM70", 11, 1, frame_shift, stop_match_score, 0, cbs_matrix_scale);
 			//pam30 = ScoreMatrix("PAM30", 10, 1, frame_shift, stop_match_score, 0, cbs_matrix_scale);
@@ -894,6 +941,9 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 	if (target_indexed && lowmem_ != 1)
 		throw runtime_error("--target-indexed requires -c1.");
 
+	if (seed_array_index && target_indexed)
+		throw runtime_error("--seed-array-index is not compatible with --target-indexed.");
+
 	if (swipe_all) {
 		algo = Algo::DOUBLE_INDEXED;
 	}
@@ -903,6 +953,12 @@ Config::Config(int argc, const char **argv, bool check_io, CommandLineParser& pa
 
 	if (multiprocessing && parallel_tmpdir.empty())
 		throw runtime_error("--multiprocessing requires setting --parallel-tmpdir");
+
+	if (!coordinator.empty() && command != COORDINATOR) {
+		if (mp_recover)
+			throw runtime_error("--mp-recover is not supported with --coordinator");
+		Coordinator::init(coordinator, Coordinator::token(coordinator_token));
+	}
 	
 	if (multiprocessing) {
 		// char * env_str = std::getenv("SLURM_JOBID");
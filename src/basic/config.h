@@ -44,7 +44,7 @@ template<> struct EnumTraits<DNAExtensionAlgo>{
     static const SEMap<DNAExtensionAlgo> from_string;
 };
 
-enum class GraphAlgo { GREEDY_VERTEX_COVER, LEN_SORTED };
+enum class GraphAlgo { GREEDY_VERTEX_COVER, LEN_SORTED, PARALLEL_GREEDY_VERTEX_COVER };
 
 template<> struct EnumTraits<GraphAlgo> {
 	static const SEMap<GraphAlgo> from_string;
@@ -75,6 +75,7 @@ struct Config
 	string compression;
 	unsigned		lowmem_;
 	double	chunk_size;
+	bool	fit_memory;
 	unsigned min_identities_;
 	unsigned min_identities2;
 	double ungapped_xdrop;
@@ -87,6 +88,9 @@ struct Config
 	double	max_seed_freq;
 	string	tmpdir;
 	string	parallel_tmpdir;
+	string	coordinator;
+	string	coordinator_token;
+	bool	coordinator_shutdown;
 	bool		long_mode;
 	double gapped_xdrop;
 	double	max_evalue;
@@ -245,6 +249,8 @@ struct Config
 	bool output_fp;
 	int family_cap;
 	int cbs_matrix_scale;
+	int64_t matrix_adjust_cache;
+	int matrix_adjust_cache_steps;
 	size_t query_count;
 	double cbs_err_tolerance;
 	int cbs_it_limit;
@@ -252,6 +258,12 @@ struct Config
 	double length_ratio_threshold;
 	bool hash_join_swap;
 	bool target_indexed;
+	bool seed_array_index;
+	bool accession_index;
+	bool pipeline;
+	bool prefetch;
+	string serve;
+	bool serve_query;
 	size_t deque_bucket_size;
 	bool mode_fast;
 	double log_evalue_scale;
@@ -358,6 +370,7 @@ struct Config
 	bool linclust_banded_ext;
 	Loc min_query_len;
 	bool hit_membuf;
+	string hit_buffer_mem;
 	size_t minichunk;
 	std::string aln_out;
 	std::string reps_out;
@@ -381,7 +394,7 @@ struct Config
 		smith_waterman = 26, cluster = 27, simulate_seqs = 31, split = 32, upgma = 33, upgma_mc = 34, regression_test = 35,
 		reverse_seqs = 36, compute_medoids = 37, mutate = 38, rocid = 40, makeidx = 41, find_shapes, prep_db, HASH_SEQS, LIST_SEEDS, CLUSTER_REALIGN,
 		GREEDY_VERTEX_COVER, CLUSTER_REASSIGN, blastn, RECLUSTER, MERGE_DAA, DEEPCLUST, LINCLUST, WORD_COUNT, CUT, MODEL_SEQS,
-		MAKE_SEED_TABLE
+		MAKE_SEED_TABLE, COORDINATOR
 	};
 
 	unsigned command;
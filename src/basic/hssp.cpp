@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "stats/stats.h"
 
 using std::list;
+using std::vector;
 using std::equal;
 using std::runtime_error;
 using std::pair;
@@ -235,9 +236,9 @@ bool Hsp::is_enveloped_by(const Hsp &hsp, double p) const
 	return query_source_range.overlap_factor(hsp.query_source_range) >= p || subject_range.overlap_factor(hsp.subject_range) >= p;
 }
 
-bool Hsp::is_enveloped_by(std::list<Hsp>::const_iterator begin, std::list<Hsp>::const_iterator end, double p) const
+bool Hsp::is_enveloped_by(HspVector::const_iterator begin, HspVector::const_iterator end, double p) const
 {
-	for (list<Hsp>::const_iterator i = begin; i != end; ++i)
+	for (HspVector::const_iterator i = begin; i != end; ++i)
 		if (is_enveloped_by(*i, p))
 			return true;
 	return false;
@@ -19,6 +19,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 #include <list>
+#include <vector>
+#include <iterator>
 #include "sequence.h"
 #include "value.h"
 #include "packed_transcript.h"
@@ -26,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/geo/diagonal_segment.h"
 #include "util/io/file.h"
 #include "util/hsp/approx_hsp.h"
+#include "util/memory/arena.h"
 
 inline Interval normalized_range(unsigned pos, int len, Strand strand)
 {
@@ -42,6 +45,12 @@ struct TargetMatrix;
 struct Blastn_Score;
 }
 
+struct Hsp;
+
+// HSPs of the extension path. Within an alignment task (Util::Memory::ArenaScope) they are stored in
+// the per-thread arenas of the task together with their transcripts.
+using HspVector = std::vector<Hsp, Util::Memory::ArenaAllocator<Hsp>>;
+
 struct Hsp
 {
 
@@ -243,7 +252,7 @@ struct Hsp
 	};
 
 	bool is_enveloped_by(const Hsp &hsp, double p) const;
-	bool is_enveloped_by(std::list<Hsp>::const_iterator begin, std::list<Hsp>::const_iterator end, double p) const;
+	bool is_enveloped_by(HspVector::const_iterator begin, HspVector::const_iterator end, double p) const;
 	bool query_range_enveloped_by(const Hsp& hsp, double p) const;
 	bool query_range_enveloped_by(std::list<Hsp>::const_iterator begin, std::list<Hsp>::const_iterator end, double p) const;
 	bool is_weakly_enveloped_by(std::list<Hsp>::const_iterator begin, std::list<Hsp>::const_iterator end, int cutoff) const;
@@ -278,6 +287,16 @@ struct Hsp
 	PackedTranscript transcript;
 };
 
+// Moves the HSPs of v to the end of out. HSPs of the extension path are kept in contiguous vectors that
+// are merged this way instead of by splicing list nodes.
+inline void append(HspVector& out, HspVector&& v) {
+	if (out.capacity() == 0)
+		out = std::move(v);
+	else
+		out.insert(out.end(), std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+	v.clear();
+}
+
 struct HspContext
 {
 	HspContext()
@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/binary_buffer.h"
 #include "basic/value.h"
 #include "sequence.h"
+#include "util/memory/arena.h"
 
 typedef enum { op_match = 0, op_insertion = 1, op_deletion = 2, op_substitution = 3, op_frameshift_forward = 4, op_frameshift_reverse = 5 } EditOperation;
 
@@ -99,6 +100,8 @@ struct CombinedOperation
 struct PackedTranscript
 {
 
+	using Data = std::vector<PackedOperation, Util::Memory::ArenaAllocator<PackedOperation>>;
+
 	struct ConstIterator
 	{
 		ConstIterator(const PackedOperation* op) :
@@ -149,7 +152,7 @@ struct PackedTranscript
 	ConstIterator begin() const
 	{ return ConstIterator(data_.data()); }
 
-	const std::vector<PackedOperation>& data() const
+	const Data& data() const
 	{ return data_; }
 
 	const PackedOperation* ptr() const
@@ -224,7 +227,7 @@ struct PackedTranscript
 
 private:
 
-	std::vector<PackedOperation> data_;
+	Data data_;
 
 	friend struct Hsp;
 
@@ -35,7 +35,7 @@ struct Statistics
 		TIME_LOAD_HIT_TARGETS, TIME_CHAINING, TIME_LOAD_SEED_HITS, TIME_SORT_SEED_HITS, TIME_SORT_TARGETS_BY_SCORE, TIME_TARGET_PARALLEL, TIME_TRACEBACK_SW, TIME_TRACEBACK, HARD_QUERIES, TIME_MATRIX_ADJUST,
 		MATRIX_ADJUST_COUNT, COMP_BASED_STATS_COUNT, FAILED_COMP_BASED_STATS, MASKED_LAZY, SWIPE_TASKS_TOTAL, SWIPE_TASKS_ASYNC, TRIVIAL_ALN, TIME_EXT_32, EXT_OVERFLOW_8, EXT_WASTED_16, DP_CELLS_8, DP_CELLS_16, DP_CELLS_32, TIME_PROFILE, TIME_ANCHORED_SWIPE,
 		TIME_ANCHORED_SWIPE_ALLOC, TIME_ANCHORED_SWIPE_SORT, TIME_ANCHORED_SWIPE_ADD, TIME_ANCHORED_SWIPE_OUTPUT, TIME_PROFILE_GENERATION, EXTENSIONS_RECOMPUTE,
-		TIME_SEARCH, SEEDS_HIT, COUNT
+		TIME_SEARCH, SEEDS_HIT, MATRIX_ADJUST_CACHE_HITS, MATRIX_ADJUST_CACHE_MISSES, TIME_LOAD_DICT, TIME_JOIN, COUNT
 	};
 
 	Statistics()
@@ -96,6 +96,16 @@ static inline __m256i letter_mask(__m256i x) {
 }
 #endif
 
+#ifdef __AVX512BW__
+static inline __m512i letter_mask(__m512i x) {
+#ifdef SEQ_MASK
+	return _mm512_and_si512(x, _mm512_set1_epi8(LETTER_MASK));
+#else
+	return x;
+#endif
+}
+#endif
+
 #ifdef __ARM_NEON
 static inline int8x16_t letter_mask(int8x16_t x) {
 #ifdef SEQ_MASK
@@ -35,10 +35,10 @@ struct Aligner
 	void backtrace(const size_t node, const int j_end, Hsp* out, ApproxHsp& t, const int score_max, const int score_min, const int max_shift, unsigned& next) const;
 	bool backtrace_old(size_t node, int j_end, Hsp* out, ApproxHsp& t, int score_max, int score_min, int max_shift, unsigned& next) const;
 	void backtrace(size_t top_node, Hsp* out, ApproxHsp& t, int max_shift, unsigned& next, int max_j) const;
-	int backtrace(size_t top_node, std::list<Hsp>& hsps, std::list<ApproxHsp>& ts, std::list<ApproxHsp>::iterator& t_begin, int cutoff, int max_shift) const;
-	int backtrace(std::list<Hsp>& hsps, std::list<ApproxHsp>& ts, int cutoff, int max_shift) const;
-	int run(std::list<Hsp>& hsps, std::list<ApproxHsp>& ts, double space_penalty, int cutoff, int max_shift);
-	int run(std::list<Hsp>& hsps, std::list<ApproxHsp>& ts, std::vector<DiagonalSegment>::const_iterator begin, std::vector<DiagonalSegment>::const_iterator end, int band);
+	int backtrace(size_t top_node, HspVector& hsps, std::list<ApproxHsp>& ts, std::list<ApproxHsp>::iterator& t_begin, int cutoff, int max_shift) const;
+	int backtrace(HspVector& hsps, std::list<ApproxHsp>& ts, int cutoff, int max_shift) const;
+	int run(HspVector& hsps, std::list<ApproxHsp>& ts, double space_penalty, int cutoff, int max_shift);
+	int run(HspVector& hsps, std::list<ApproxHsp>& ts, std::vector<DiagonalSegment>::const_iterator begin, std::vector<DiagonalSegment>::const_iterator end, int band);
 	Aligner(const Sequence& query, const Sequence& subject, bool log, unsigned frame);
 
 	const Sequence query, subject;
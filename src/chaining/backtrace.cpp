@@ -294,7 +294,7 @@ void Aligner::backtrace(size_t top_node, Hsp* out, ApproxHsp& t, int max_shift,
 	t = traits;
 }
 
-int Aligner::backtrace(size_t top_node, list<Hsp>& hsps, list<ApproxHsp>& ts, list<ApproxHsp>::iterator& t_begin, int cutoff, int max_shift) const
+int Aligner::backtrace(size_t top_node, HspVector& hsps, list<ApproxHsp>& ts, list<ApproxHsp>::iterator& t_begin, int cutoff, int max_shift) const
 {
 	unsigned next;
 	int max_score = 0, max_j = (int)subject.length();
@@ -317,7 +317,7 @@ int Aligner::backtrace(size_t top_node, list<Hsp>& hsps, list<ApproxHsp>& ts, li
 			else
 				ts.push_back(t);
 			if (hsp)
-				hsps.push_back(*hsp);
+				hsps.push_back(std::move(*hsp));
 			max_score = std::max(max_score, t.score);
 		}
 		delete hsp;
@@ -326,7 +326,7 @@ int Aligner::backtrace(size_t top_node, list<Hsp>& hsps, list<ApproxHsp>& ts, li
 	return max_score;
 }
 
-int Aligner::backtrace(list<Hsp>& hsps, list<ApproxHsp>& ts, int cutoff, int max_shift) const
+int Aligner::backtrace(HspVector& hsps, list<ApproxHsp>& ts, int cutoff, int max_shift) const
 {
 	vector<DiagonalNode*> top_nodes;
 	for (size_t i = 0; i < diags.nodes.size(); ++i) {
@@ -359,7 +359,7 @@ namespace Chaining {
 		}
 	}
 
-	int Aligner::run(list<Hsp> &hsps, list<ApproxHsp> &ts, double space_penalty, int cutoff, int max_shift)
+	int Aligner::run(HspVector &hsps, list<ApproxHsp> &ts, double space_penalty, int cutoff, int max_shift)
 	{
 		if (config.chaining_maxnodes > 0) {
 			std::sort(diags.nodes.begin(), diags.nodes.end(), DiagonalSegment::cmp_score);
@@ -388,8 +388,8 @@ namespace Chaining {
 		int max_score = backtrace(hsps, ts, cutoff, max_shift);
 
 		if (log) {
-			hsps.sort(Hsp::cmp_query_pos);
-			for (list<Hsp>::iterator i = hsps.begin(); i != hsps.end(); ++i)
+			std::stable_sort(hsps.begin(), hsps.end(), Hsp::cmp_query_pos);
+			for (HspVector::iterator i = hsps.begin(); i != hsps.end(); ++i)
 				print_hsp(*i, TranslatedSequence(query));
 			cout << endl << "Smith-Waterman:" << endl;
 			smith_waterman(query, subject, diags);
@@ -398,7 +398,7 @@ namespace Chaining {
 		return max_score;
 	}
 
-	int Aligner::run(list<Hsp> &hsps, list<ApproxHsp> &ts, vector<DiagonalSegment>::const_iterator begin, vector<DiagonalSegment>::const_iterator end, int band)
+	int Aligner::run(HspVector &hsps, list<ApproxHsp> &ts, vector<DiagonalSegment>::const_iterator begin, vector<DiagonalSegment>::const_iterator end, int band)
 	{
 		if (log)
 			cout << "***** Seed hit run " << begin->diag() << '\t' << (end - 1)->diag() << '\t' << (end - 1)->diag() - begin->diag() << endl;
@@ -488,7 +488,7 @@ std::pair<int, list<ApproxHsp>> run(Sequence query, Sequence subject, vector<Dia
 		return { begin->score, { { d, d, begin->score, (int)frame, begin->query_range(), begin->subject_range(), anchor}} };
 	}
 	Chaining::Aligner ga(query, subject, log, frame);
-	list<Hsp> hsps;
+	HspVector hsps;
 	list<ApproxHsp> ts;
 	int score = ga.run(hsps, ts, begin, end, band);
 	if (!config.no_chaining_merge_hsps)
@@ -496,8 +496,8 @@ std::pair<int, list<ApproxHsp>> run(Sequence query, Sequence subject, vector<Dia
 	return std::make_pair(score, std::move(ts));
 }
 
-list<Hsp> run(Sequence query, const std::vector<DpTarget>& targets) {
-	list<Hsp> out;
+HspVector run(Sequence query, const std::vector<DpTarget>& targets) {
+	HspVector out;
 	return out;
 }
 
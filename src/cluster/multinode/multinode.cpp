@@ -70,49 +70,66 @@ void Job::log(const ClusterStats& stats) {
 	//log("Alignments passing all filters: %" PRIu64, stats.hits_filtered);
 }
 
-static void run_block_combos(Job& job, const VolumedFile& volumes, const string& base_dir, const string& aln_path) {
-	int64_t r;
+// Lists the rows r of the block combo triangle of a linear round in the order in which the workers claim them.
+// A worker searches all combos (r, i), i <= r, of a row in turn, since the seed hit table for reference block r
+// carries over between them; handing out whole rows keeps the results independent of the timing of the workers.
+// The cost of a combo is estimated as size[r] * size[i] from the volume files, and rows are claimed in order of
+// decreasing total cost so that the largest rows are not left to the end of the round.
+static vector<int64_t> block_row_schedule(const VolumedFile& volumes) {
+	const int64_t n = (int64_t)volumes.size();
+	vector<double> size(n), row_cost(n);
+	for (int64_t r = 0; r < n; ++r)
+		size[r] = (double)file_size(volumes[r].path.c_str());
+	double prefix = 0.0;
+	for (int64_t r = 0; r < n; ++r) {
+		prefix += size[r];
+		row_cost[r] = size[r] * prefix;
+	}
+	vector<int64_t> rows(n);
+	for (int64_t r = 0; r < n; ++r)
+		rows[r] = r;
+	std::sort(rows.begin(), rows.end(), [&row_cost](int64_t x, int64_t y) {
+		return row_cost[x] > row_cost[y] || (row_cost[x] == row_cost[y] && x > y);
+	});
+	return rows;
+}
+
+static void run_block_combos(Job& job, const VolumedFile& volumes, const string& base_dir) {
+	using Clock = std::chrono::steady_clock;
+	const vector<int64_t> rows = block_row_schedule(volumes);
+	const int64_t n = (int64_t)rows.size();
 	Atomic q(base_dir + "queue", job);
 	Atomic finished(base_dir + "finished", job);
-	const int64_t n = (int64_t)volumes.size();
-	while (r = q.fetch_add(), r < n) {
+	const Clock::time_point start = Clock::now();
+	Clock::duration busy(0);
+	int64_t k, combo_count = 0;
+	while (k = q.fetch_add(), k < n) {
+		const int64_t r = rows[k];
 		unique_ptr<vector<BitVector>> seed_hit_table(new vector<BitVector>());
-		for (int i = 0; i <= r; ++i) {
+		const Clock::time_point t = Clock::now();
+		for (int64_t i = 0; i <= r; ++i) {
 			job.log("Searching blocks. Blocks=%lli,%lli", r + 1, i + 1);
-			/*if (!seed_hit_table->empty()) {
-				for (size_t i = 0; i < seed_hit_table->size(); ++i)
-					job.log("Seed hit table paired positions shape %zu: %zu/%zu", i, seed_hit_table->operator[](i).one_count(), seed_hit_table->operator[](i).size());
-			}*/
 			run_search(job, volumes, r, i, base_dir, seed_hit_table);
+			++combo_count;
 		}
+		busy += Clock::now() - t;
 		finished.fetch_add();
 	}
 	finished.await(n);
+	const double busy_s = std::chrono::duration<double>(busy).count(),
+		wall_s = std::chrono::duration<double>(Clock::now() - start).count();
+	job.log("Worker utilisation: block combos=%" PRId64 " busy=%.1fs wall=%.1fs (%.1f%%)", combo_count, busy_s, wall_s, wall_s > 0.0 ? busy_s / wall_s * 100.0 : 100.0);
+}
 
-	Atomic concat_lock(base_dir + "concat_lock", job);
-	Atomic concat_done(base_dir + "concat_done", job);
-	if (concat_lock.fetch_add() == 0) {
-		job.log("Concatenating alignment files");
-		ofstream out(aln_path);
-		for (uint64_t r = 0; r < volumes.size(); ++r) {
-			for (uint64_t i = 0; i <= r; ++i) {
-				const string src = base_dir + std::to_string(r) + "_" + std::to_string(i) + ".tsv";
-				std::ifstream in(src, std::ios::binary);
-				if (!in.good())
-					throw runtime_error("Error opening file " + src);
-				if (in.peek() != std::ifstream::traits_type::eof()) {
-					out << in.rdbuf();
-					if (!out) throw runtime_error("Error writing " + aln_path);
-				}
-				in.close();
-				remove_tmp_file(src);
-			}
-		}
-		out.close();
-		concat_done.fetch_add();
-	}
-	else
-		concat_done.await(1);
+// The edge files written by the search workers of this round, read directly by the greedy vertex cover.
+static vector<string> edge_files(const Job& job, const VolumedFile& volumes, const string& base_dir) {
+	if (!job.is_linear_round())
+		return { job.base_dir() + "alignments.bin" };
+	vector<string> files;
+	for (uint64_t r = 0; r < volumes.size(); ++r)
+		for (uint64_t i = 0; i <= r; ++i)
+			files.push_back(base_dir + std::to_string(r) + "_" + std::to_string(i) + ".bin");
+	return files;
 }
 
 static pair<string, uint64_t> run_round(Job& job, const VolumedFile& volumes) {
@@ -126,11 +143,10 @@ static pair<string, uint64_t> run_round(Job& job, const VolumedFile& volumes) {
 	job.set_round(volumes.sparse_records());
 	const int64_t BUF_SIZE = 4096;
 	const string base_dir = job.base_dir() + PATH_SEPARATOR + "alignments" + PATH_SEPARATOR;
-	const string aln_path = job.base_dir() + "alignments.tsv";
 	const bool mutual_cover = config.mutual_cover.present();
 	job.make_temp_dir(base_dir);
 	if(linear)
-		run_block_combos(job, volumes, base_dir, aln_path);
+		run_block_combos(job, volumes, base_dir);
 	else {
 		unique_ptr<vector<BitVector>> seed_hit_table;
 		run_search(job, volumes, -1, -1, base_dir, seed_hit_table);
@@ -147,15 +163,17 @@ static pair<string, uint64_t> run_round(Job& job, const VolumedFile& volumes) {
 		job.log("Running greedy vertex cover");		
 		const string acc_path = Cluster::gvc_input_rep_list(job.round(), job.root_dir(), &job, volumes.max_oid());
 		config.database = acc_path;
-		config.edges = aln_path;
+		config.edges.clear();
 		config.edge_format = mutual_cover ? "triplet" : "";
 		config.symmetric = mutual_cover;
 		config.output_file = job.base_dir() + PATH_SEPARATOR + "clusters.tsv";
 		GVC::Cfg cfg;
 		cfg.tmp_dir = job.base_dir();
+		cfg.edge_files = edge_files(job, volumes, base_dir);
 		GVC::greedy_vertex_cover(cfg);
 		remove_tmp_file(acc_path);
-		remove_tmp_file(aln_path);
+		for (const string& f : cfg.edge_files)
+			remove_tmp_file(f);
 		if (!job.last_round()) {
 			job.log("Writing representative ids");
 			ifstream cl(config.output_file);
@@ -52,7 +52,10 @@ struct Job {
 	{
 		register_temp_dir(base_dir_);
 		make_temp_dir(base_dir());
-		log_file_.reset(new FileStack(base_dir_ + PATH_SEPARATOR + "diamond_job.log", *this));
+		// The log is always written to disk, also with --coordinator.
+		const std::string log_file = base_dir_ + PATH_SEPARATOR + "diamond_job.log";
+		log_file_.reset(new FileStack(log_file, (Coordinator*)nullptr));
+		register_sync_file(log_file);
 		Atomic worker_id(base_dir_ + PATH_SEPARATOR + "worker_id", *this);
 		worker_id_ = worker_id.fetch_add();
 	}
@@ -61,7 +64,10 @@ struct Job {
 		//log("Cleaning up");
 		log_file_.reset();
 		for (const auto& file : sync_files_) {
-			remove_tmp_file(file);
+			if (file.second)
+				Coordinator::get()->erase(file.first);
+			else
+				remove_tmp_file(file.first);
 		}
 		for (auto it = temp_dirs_.rbegin(); it != temp_dirs_.rend(); ++it) {
 			rmdir(*it);
@@ -140,12 +146,13 @@ struct Job {
 		max_oid_ = max_oid;
 	}
 
-	void register_sync_file(const std::string& file_name) {
+	// Coordinated files are stacks kept on the coordinator (--coordinator) and are erased there by finish().
+	void register_sync_file(const std::string& file_name, bool coordinated = false) {
 		/*if (!ends_with(file_name, "diamond_job.log"))
 			log("Temp file: %s", file_name.c_str());
 		else
 			return;*/
-		sync_files_.push_back(file_name);
+		sync_files_.emplace_back(file_name, coordinated);
 	}
 
 	void register_temp_dir(const std::string& dir_name) {
@@ -170,7 +177,7 @@ private:
 	std::chrono::system_clock::time_point start_;
 	std::vector<uint64_t> input_count_;
 	ClusterStats stats_;
-	std::vector<std::string> sync_files_;
+	std::vector<std::pair<std::string, bool>> sync_files_;
 	std::vector<std::string> temp_dirs_;
 
 };
@@ -50,7 +50,7 @@ static double block_combo_chunk_size(const VolumedFile& volumes, int64_t r, int6
 static void run_all_vs_all(Job& job) {
 	job.log("Running all-vs-all search for round %d/%d", job.round() + 1, job.round_count());
 	const string base_dir = config.tmpdir + PATH_SEPARATOR + "round" + std::to_string(job.round()) + PATH_SEPARATOR;
-	config.output_file = base_dir + "alignments.tsv";	
+	config.output_file = base_dir + "alignments.bin";
 	config.self = true;
 	config.query_file.clear();
 	config.lin_stage1_query = false;
@@ -88,7 +88,7 @@ static void run_block_combo(Job& job, const VolumedFile& volumes, int64_t r, int
 	if (config.db_size == 0)
 		throw runtime_error("Database size must be set for cascaded linear search round.");
 	//config.comp_based_stats = 1; // TODO
-	config.output_file = base_dir + std::to_string(r) + "_" + std::to_string(i) + ".tsv";
+	config.output_file = base_dir + std::to_string(r) + "_" + std::to_string(i) + ".bin";
 	log_rss();
 	TaskTimer timer("Opening the database");
 	shared_ptr<SequenceFile> db;
@@ -119,7 +119,7 @@ void run_search(Job& job, const VolumedFile& volumes, int64_t r, int64_t i, stri
 		config.subject_cover = 0;
 		config.query_or_target_cover = round_cov_cutoff;
 	}
-	config.output_format = mutual_cover ? vector<string> { "tab", "qseqid", "sseqid", "corrected_bitscore" } : vector<string>{ "tab", "qseqid", "sseqid", "qcovhsp", "scovhsp", "corrected_bitscore" };
+	config.output_format = { "bin_edge" };
 	statistics.reset();
 	config.db_size = volumes.letter_count();
 	job.log("Database letter count: %" PRIu64, config.db_size);
@@ -35,7 +35,6 @@ using std::mutex;
 using std::lock_guard;
 using std::thread;
 using std::make_pair;
-using std::list;
 using std::lower_bound;
 using std::atomic;
 using std::shared_ptr;
@@ -82,11 +81,11 @@ static void align_centroid(CentroidId centroid, ReorderQueue<TextBuffer*, Cluste
 	const HauserCorrection cbs(centroid_seq);
 	const string centroid_seqid = cfg.lazy_titles ? cfg.db->seqid(centroid_oid, false, false) : cfg.centroid_block->ids()[centroid_id];
 	DP::Params p{ centroid_seq, centroid_seqid.c_str(), Frame(0), centroid_seq.length(), config.comp_based_stats == 1 ? cbs.int8.data() : nullptr, DP::Flags::FULL_MATRIX, false, 0, 0, cfg.hsp_values, stats, &tp };
-	list<Hsp> hsps = DP::BandedSwipe::swipe(dp_targets, p);
+	HspVector hsps = DP::BandedSwipe::swipe(dp_targets, p);
 
 	TextBuffer* buf = new TextBuffer;
 	const int replen = centroid_seq.length();
-	hsps.sort(Hsp::OrderBySwipeTarget());
+	std::stable_sort(hsps.begin(), hsps.end(), Hsp::OrderBySwipeTarget());
 	for (Hsp& hsp : hsps) {
 		const Loc memberlen = cfg.member_block->seqs().length(hsp.swipe_target);
 		if (Extension::filter_hsp(hsp, replen, nullptr, memberlen, nullptr, centroid_seq, Sequence(), 0, 0, nullptr))
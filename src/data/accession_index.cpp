@@ -0,0 +1,145 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <string.h>
+#include <stdio.h>
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include "mio/mmap.hpp"
+#include "accession_index.h"
+#include "util/io/file.h"
+#include "legacy/dmnd/io.h"
+#include "util/algo/external_sort.h"
+#include "util/io/temp_file.h"
+
+using std::string;
+using std::vector;
+using std::runtime_error;
+using std::to_string;
+
+AccessionIndex::AccessionIndex(const string& file_name, bool temporary):
+	mmap_(new mio::mmap_source(file_name)),
+	file_name_(file_name),
+	temporary_(temporary),
+	data_(mmap_->data()),
+	header_((const Header*)data_)
+{
+	const size_t size = mmap_->length();
+	if (size < sizeof(Header) || header_->magic != ACCESSION_INDEX_MAGIC_NUMBER)
+		throw runtime_error("Invalid accession index file: " + file_name);
+	if (header_->version != ACCESSION_INDEX_VERSION)
+		throw runtime_error("Invalid accession index file version.");
+	if (header_->entries_offset + header_->entry_count * sizeof(Entry) != size)
+		throw runtime_error("Accession index file is truncated: " + file_name);
+	entries_ = (const Entry*)(data_ + header_->entries_offset);
+}
+
+AccessionIndex::~AccessionIndex() {
+	mmap_.reset();
+	if (temporary_)
+		::remove(file_name_.c_str());
+}
+
+bool AccessionIndex::matches(uint64_t seqs, uint64_t letters) const {
+	return header_->seqs == seqs && header_->letters == letters;
+}
+
+vector<OId> AccessionIndex::find(const string& acc) const {
+	const char* key = acc.c_str();
+	const Entry* end = entries_ + header_->entry_count;
+	const Entry* it = std::lower_bound(entries_, end, key, [this](const Entry& e, const char* k) {
+		return strcmp(accession(e), k) < 0;
+	});
+	vector<OId> r;
+	if (it == end || strcmp(accession(*it), key) != 0)
+		return r;
+	// Entries of the same accession share its string offset.
+	for (const uint64_t offset = it->accession; it < end && it->accession == offset; ++it)
+		r.push_back(it->oid);
+	return r;
+}
+
+string AccessionIndex::file_name(const string& db_file) {
+	return db_file + ".acc_idx";
+}
+
+void AccessionIndex::build(OutputFile& out, ExternalSorter<T, std::less<T>>& accessions, uint64_t seqs, uint64_t letters) {
+	Header header{ ACCESSION_INDEX_MAGIC_NUMBER, ACCESSION_INDEX_VERSION, 0, seqs, letters, 0, 0 };
+	out.write(header);
+
+	TempFile entries;
+	string last;
+	uint64_t offset = 0, acc_offset = 0;
+	OId last_oid = 0;
+	for (accessions.init_read(); accessions.good(); ++accessions) {
+		const T& a = *accessions;
+		const bool new_acc = header.entry_count == 0 || a.first != last;
+		if (!new_acc && a.second == last_oid)
+			continue;
+		if (new_acc) {
+			acc_offset = offset;
+			out << a.first;
+			offset += a.first.length() + 1;
+			last = a.first;
+		}
+		entries.write(Entry{ acc_offset, a.second });
+		last_oid = a.second;
+		++header.entry_count;
+	}
+	const char padding[8] = { 0 };
+	out.write(padding, (8 - out.tell() % 8) % 8);
+	header.entries_offset = out.tell();
+
+	InputFile in(entries);
+	vector<char> buf(1 << 20);
+	size_t n;
+	while ((n = in.read_raw(buf.data(), buf.size())) > 0)
+		out.write(buf.data(), n);
+	in.close_and_delete();
+
+	out.seek(0);
+	out.write(header);
+	out.close();
+}
+
+void AccessionIndex::write(const string& file_name, ExternalSorter<T, std::less<T>>& accessions, uint64_t seqs, uint64_t letters) {
+	const string tmp_name = file_name + ".tmp." + to_string(getpid());
+	OutputFile out(tmp_name);
+	try {
+		build(out, accessions, seqs, letters);
+	}
+	catch (...) {
+		::remove(tmp_name.c_str());
+		throw;
+	}
+#ifdef WIN32
+	::remove(file_name.c_str());
+#endif
+	if (::rename(tmp_name.c_str(), file_name.c_str()) != 0) {
+		::remove(tmp_name.c_str());
+		throw runtime_error("Error renaming accession index file " + tmp_name + " to " + file_name);
+	}
+}
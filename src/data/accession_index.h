@@ -0,0 +1,84 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <stdint.h>
+#include "mio/forward.h"
+#include "basic/value.h"
+
+/* Persistent accession to OId index (makedb --accession-index, or built on first use).
+   File layout:
+     header:  magic (8), version (4), reserved (4), sequence count (8), letters (8), entry count (8),
+              entries offset (8)
+     strings: distinct accessions in sorted order (null-terminated), padding to 8 bytes
+     entries: Entry for each (accession, OId) pair, sorted by accession and OId */
+
+const uint64_t ACCESSION_INDEX_MAGIC_NUMBER = 0x41d99089ee7c3d3a;
+const uint32_t ACCESSION_INDEX_VERSION = 0;
+
+template<typename Type, typename Cmp>
+struct ExternalSorter;
+struct OutputFile;
+
+struct AccessionIndex {
+
+	typedef std::pair<std::string, OId> T;
+
+	struct Header {
+		uint64_t magic;
+		uint32_t version, reserved;
+		uint64_t seqs, letters, entry_count, entries_offset;
+	};
+
+	struct Entry {
+		uint64_t accession, oid;
+	};
+
+	AccessionIndex(const std::string& file_name, bool temporary = false);
+	~AccessionIndex();
+	bool matches(uint64_t seqs, uint64_t letters) const;
+	std::vector<OId> find(const std::string& accession) const;
+	uint64_t size() const {
+		return header_->entry_count;
+	}
+
+	static std::string file_name(const std::string& db_file);
+	static void build(OutputFile& out, ExternalSorter<T, std::less<T>>& accessions, uint64_t seqs, uint64_t letters);
+	// Builds the index into a temporary file in the same directory and renames it to file_name.
+	static void write(const std::string& file_name, ExternalSorter<T, std::less<T>>& accessions, uint64_t seqs, uint64_t letters);
+
+private:
+
+	const char* accession(const Entry& e) const {
+		return data_ + sizeof(Header) + e.accession;
+	}
+
+	std::unique_ptr<mio::mmap_source> mmap_;
+	const std::string file_name_;
+	const bool temporary_;
+	const char* data_;
+	const Header* header_;
+	const Entry* entries_;
+
+};
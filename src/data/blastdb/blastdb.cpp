@@ -361,36 +361,18 @@ void BlastDB::close()
 
 DbFilter* BlastDB::filter_by_accession(const string& file_name)
 {
-	DbFilter* v = new DbFilter(sequence_count().value());
-	File in(file_name, "rb", File::Flags::DETECT_COMPRESSION);
-	std::unordered_map<string, bool> accs;
-	const char* l;
-	while (l = in.getline(), !in.eof() || l[0] != '\0') {
-		accs.emplace(std::string(l), false);
-	}
-	in.close();
-
-	for (;;) {
-		pair<Block*, int64_t> b = load_parallel(1000000000, nullptr, &accs, Chunk(), false);
-		const BlockId n = b.first->oid_count();
-		for (BlockId i = 0; i < n; ++i) {
-			const OId oid = b.first->block_id2oid(i);
-			v->oid_filter.set(oid);
-			v->letter_count += seq_length(oid);
-		}
-		const bool end = b.first->raw_bytes() == 0;
-		delete b.first;
-		if (end)
-			break;
-	}
+	return filter_by_accession_index(file_name);
+}
 
-	if (!config.skip_missing_seqids) {
-		for (const auto& a : accs) {
-			if(!a.second)
-				throw runtime_error("Accession not found in database: " + a.first + ". Use --skip-missing-seqids to ignore.");
+void BlastDB::read_accessions(vector<string>& accessions)
+{
+	const vector<BlastDefLine> deflines = this->deflines(oid_++, true, false, false);
+	for (const BlastDefLine& d : deflines)
+		for (const SeqId& s : d.seqids) {
+			accessions.push_back(s.value);
+			if (s.version || s.chain)
+				accessions.push_back(format_seqid(s));
 		}
-	}
-	return v;
 }
 
 string BlastDB::file_name()
@@ -502,15 +484,6 @@ void BlastDB::end_random_access(bool dictionary)
 		free_dictionary();
 }
 
-vector<OId> BlastDB::accession_to_oid(const string& acc) const
-{
-	vector<int> r;
-	//db_->AccessionToOids(acc, r);
-	if(r.empty())
-		throw runtime_error("Accession not found in database: " + acc);
-	return vector<OId>(r.begin(), r.end());
-}
-
 BlastDB::~BlastDB()
 {
 	close();
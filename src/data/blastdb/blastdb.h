@@ -70,7 +70,6 @@ struct BlastDB : public SequenceFile {
 	virtual void seq_data(size_t oid, std::vector<Letter>& dst) override;
 	virtual Loc seq_length(size_t oid) override;
 	virtual void end_random_access(bool dictionary = true) override;
-	virtual std::vector<OId> accession_to_oid(const std::string& acc) const override;
 	virtual void init_write() override;
 	virtual void write_seq(const Sequence& seq, const std::string& id) override;
 	virtual ~BlastDB();
@@ -83,6 +82,10 @@ struct BlastDB : public SequenceFile {
 		return raw_chunk_no_;
 	}
 
+protected:
+
+	virtual void read_accessions(std::vector<std::string>& accessions) override;
+
 private:
 
 	std::string fetch_seqid(OId oid, bool all, bool fulL_titles);
@@ -47,6 +47,18 @@ Block::Block():
 {
 }
 
+Block::Block(const Block& b) = default;
+
+void Block::finish_reserve() {
+	seqs_.finish_reserve();
+	if (source_seqs_.size() > 0)
+		source_seqs_.finish_reserve();
+	if (ids_.size() > 0)
+		ids_.finish_reserve();
+	if (qual_.size() > 0)
+		qual_.finish_reserve();
+}
+
 bool Block::empty() const {
 	return seqs_.size() == 0;
 }
@@ -132,6 +144,8 @@ void Block::write_masked_seq(size_t block_id, const std::vector<Letter>& seq) {
 	if (masked_[block_id])
 		return;
 	std::copy(seq.begin(), seq.end(), seqs_.ptr(block_id));
+	if (!aa_counts_.empty())
+		count_aa(block_id);
 	masked_[block_id] = true;
 }
 
@@ -202,6 +216,35 @@ void Block::compute_self_aln() {
 		i.join();
 }
 
+void Block::count_aa(const size_t block_id) {
+	uint16_t* counts = &aa_counts_[block_id * TRUE_AA];
+	const Sequence s = seqs_[block_id];
+	std::fill(counts, counts + TRUE_AA, 0);
+	if (s.length() >= UINT16_MAX) {
+		counts[0] = UINT16_MAX;
+		return;
+	}
+	for (Loc i = 0; i < s.length(); ++i)
+		if ((size_t)s[i] < TRUE_AA)
+			++counts[(size_t)s[i]];
+}
+
+void Block::compute_aa_counts() {
+	aa_counts_.resize(seqs_.size() * TRUE_AA);
+	std::atomic_size_t next(0);
+	auto worker = [this, &next] {
+		const size_t n = this->seqs_.size();
+		size_t i;
+		while ((i = next++) < n)
+			this->count_aa(i);
+	};
+	vector<std::thread> t;
+	for (int i = 0; i < config.threads_; ++i)
+		t.emplace_back(worker);
+	for (auto& i : t)
+		i.join();
+}
+
 double Block::self_aln_score(const int64_t block_id) const {
 	return self_aln_score_[block_id];
 }
@@ -263,5 +306,6 @@ BlockId Block::source_seq_count() const {
 }
 
 int64_t Block::mem_size() const {
-	return seqs_.mem_size() + source_seqs_.mem_size() + unmasked_seqs_.mem_size() + ids_.mem_size() + qual_.mem_size() + block2oid_.size() * sizeof(OId) + soft_masking_table_.mem_size();
+	return seqs_.mem_size() + source_seqs_.mem_size() + unmasked_seqs_.mem_size() + ids_.mem_size() + qual_.mem_size() + block2oid_.size() * sizeof(OId) + soft_masking_table_.mem_size()
+		+ aa_counts_.size() * sizeof(uint16_t);
 }
\ No newline at end of file
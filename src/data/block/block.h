@@ -24,12 +24,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "search/seed_array/seed_histogram.h"
 #include "masking/masking.h"
 #include "output/output_format.h"
+#include "util/memory/copy_policy.h"
 
 struct SequenceFile;
 
 struct Block {
 
 	Block();
+	Block(const Block& b);
 	unsigned source_len(unsigned block_id) const;
 	TranslatedSequence translated(size_t block_id) const;
 	bool long_offsets() const;
@@ -95,8 +97,17 @@ struct Block {
 	bool has_self_aln() const {
 		return (BlockId)self_aln_score_.size() == seqs_.size();
 	}
+	void compute_aa_counts();
+	// Amino acid counts of a sequence (TRUE_AA entries), or nullptr if not tabulated.
+	const uint16_t* aa_counts(const BlockId block_id) const {
+		if (aa_counts_.empty())
+			return nullptr;
+		const uint16_t* p = &aa_counts_[(size_t)block_id * TRUE_AA];
+		return p[0] == UINT16_MAX ? nullptr : p;
+	}
 	int64_t push_back(const Sequence& seq, const char* id, const std::vector<char>* quals, const OId oid, const SequenceType seq_type, const int frame_mask, const bool dna_translation = true);
 	void append(const Block& b, bool remove_padding = false, bool append_seqs = true, bool append_ids = true, bool append_oids = true);
+	void finish_reserve();
 	SeqInfo seq_info(const BlockId id) const;
 	Block* length_sorted(int threads) const;
 	bool has_ids() const;
@@ -116,6 +127,8 @@ struct Block {
 
 private:
 
+	void count_aa(const size_t block_id);
+
 	SequenceSet seqs_, source_seqs_, unmasked_seqs_;
 	StringSet ids_;
 	StringSet qual_;
@@ -123,7 +136,8 @@ private:
 	std::vector<OId> block2oid_;
 	std::vector<bool> masked_;
 	std::vector<double> self_aln_score_;
-	std::mutex mask_lock_;
+	std::vector<uint16_t> aa_counts_;
+	Util::Memory::ResetOnCopy<std::mutex> mask_lock_;
 	MaskingTable soft_masking_table_;
 	bool soft_masked_;
 	uint64_t raw_bytes_;
@@ -24,11 +24,97 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "legacy/dmnd/dmnd.h"
 #include "basic/shape_config.h"
 #include "util/log_stream.h"
+#include "search/seed_array/seed_array.h"
+#include "search/seed_array/seed_array_index.h"
+
+using std::endl;
+using std::vector;
+
+static void make_seed_array_index() {
+	using SA = ARCH_GENERIC::SeedArray<PackedLoc>;
+	if (config.sensitivity >= Sensitivity::VERY_SENSITIVE)
+		::Config::set_option(config.chunk_size, 0.4);
+	else
+		::Config::set_option(config.chunk_size, 2.0);
+	config.algo = Config::Algo::DOUBLE_INDEXED;
+	std::unique_ptr<vector<BitVector>> target_seed_hits;
+	Search::Config cfg(target_seed_hits);
+	Search::setup_search(config.sensitivity, cfg);
+	cfg.seedp_bits = Search::seedp_bits(shapes[0].weight_, config.threads_, Search::sensitivity_traits.at(config.sensitivity).index_chunks);
+
+	TaskTimer timer("Opening the database");
+	DatabaseFile db(config.database);
+	db.flags() |= SequenceFile::Flags::SEQS;
+	OutputFile out(SeedArrayIndex::file_name(db.file_name()));
+	out.write(SEED_ARRAY_INDEX_MAGIC_NUMBER);
+	out.write(SEED_ARRAY_INDEX_VERSION);
+	out.write((int32_t)shapes.count());
+	out.write((int32_t)cfg.seedp_bits);
+	out.write((uint32_t)sizeof(SA::Entry));
+	out << SeedArrayIndex::signature(cfg);
+	const char padding[8] = { 0 };
+	out.write(padding, (8 - out.tell() % 8) % 8);
+	timer.finish();
+	*message_stream << "Block size = " << config.block_size() << endl;
+	*message_stream << "Seed partition bits = " << cfg.seedp_bits << endl;
+
+	const SeedPartitionRange range(0, (SeedPartition)seedp_count(cfg.seedp_bits));
+	vector<SeedArrayIndex::BlockInfo> blocks;
+	for (int block_id = 0;; ++block_id) {
+		timer.go("Loading reference sequences");
+		std::unique_ptr<Block> block(db.load_seqs(config.block_size(), 0, nullptr));
+		if (block->empty())
+			break;
+		blocks.push_back({ (uint64_t)block->oid_begin(), (uint64_t)block->seqs().size(), (uint64_t)block->seqs().letters(), (uint64_t)out.tell() });
+
+		if (cfg.target_masking != MaskingAlgo::NONE) {
+			timer.go("Masking reference");
+			mask_seqs(block->seqs(), Masking::get(), true, cfg.target_masking);
+		}
+
+		timer.go("Building reference histograms");
+		EnumCfg enum_cfg{ nullptr, 0, 0, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut, cfg.soft_masking, cfg.minimizer_window, false, false, cfg.sketch_size, nullptr };
+		block->hst() = SeedHistogram(*block, false, &no_filter, enum_cfg, cfg.seedp_bits);
+		char* buffer = SA::alloc_buffer(block->hst(), 1);
+
+		for (int sid = 0; sid < shapes.count(); ++sid) {
+			*message_stream << "Processing reference block " << block_id + 1 << ", shape " << sid + 1 << '/' << shapes.count() << '.' << endl;
+			timer.go("Building reference seed array");
+			const EnumCfg enum_ref{ &block->hst().partition(), sid, sid + 1, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut,
+				cfg.soft_masking, cfg.minimizer_window, false, false, cfg.sketch_size, nullptr };
+			SA ref_idx(*block, block->hst().get(sid), range, cfg.seedp_bits, buffer, &no_filter, enum_ref);
+			timer.go("Writing to disk");
+			uint64_t offset = 0;
+			for (SeedPartition i = 0; i < range.size(); ++i) {
+				out.write(offset);
+				offset += ref_idx.size(i);
+			}
+			out.write(offset);
+			out.write(ref_idx.begin(0), ref_idx.size());
+			out.write(padding, (8 - out.tell() % 8) % 8);
+		}
+		Util::Memory::aligned_free(buffer);
+	}
+
+	timer.go("Writing block table");
+	const uint64_t table_offset = out.tell();
+	out.write(blocks.data(), blocks.size());
+	out.write(table_offset);
+	out.write((uint64_t)blocks.size());
+	out.close();
+	db.close();
+	timer.finish();
+	*message_stream << "Indexed " << blocks.size() << " reference blocks." << endl;
+}
 
 void makeindex() {
 	static const size_t MAX_LETTERS = 100000000;
 	if (config.database.empty())
 		throw std::runtime_error("Missing parameter: database file (--db/-d).");
+	if (config.seed_array_index) {
+		make_seed_array_index();
+		return;
+	}
 	DatabaseFile db(config.database);
 	if (db.ref_header.letters > MAX_LETTERS)
 		throw std::runtime_error("Indexing is only supported for databases of < 100000000 letters.");
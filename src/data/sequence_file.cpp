@@ -35,6 +35,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/string/tokenizer.h"
 #include "util/log_stream.h"
 #include "util/data_structures/queue.h"
+#include "util/io/file.h"
+#include "legacy/dmnd/io.h"
+#include "util/algo/external_sort.h"
+#include "util/io/temp_file.h"
+#include "accession_index.h"
 
 using std::string;
 using std::endl;
@@ -394,9 +399,18 @@ void SequenceFile::get_seq()
 		list.close();
 	}
 
+	std::set<string> seqidlist;
+	if (!config.seqidlist.empty()) {
+		File list(config.seqidlist, "rb", File::Flags::DETECT_COMPRESSION);
+		const char* l;
+		while (l = list.getline(), !list.eof() || l[0] != '\0')
+			seqidlist.emplace(l);
+		list.close();
+	}
+
 	vector<Letter> seq;
 	string id;
-	bool all = config.seq_no.size() == 0 && seq_titles.empty() && config.oid_list.empty();
+	bool all = config.seq_no.size() == 0 && seq_titles.empty() && config.oid_list.empty() && seqidlist.empty();
 
 	std::set<size_t> seqs;
 	if (!all)
@@ -412,24 +426,61 @@ void SequenceFile::get_seq()
 		}
 		f.close();
 	}
+
+	const AccessionIndex* index = seq_titles.empty() && seqidlist.empty() ? nullptr : accession_index();
+	map<OId, string> oid_titles;
+	if (index) {
+		for (const auto& t : seq_titles)
+			for (OId oid : index->find(t.first))
+				oid_titles[oid] = t.second;
+		for (const string& acc : seqidlist) {
+			const vector<OId> oids = index->find(acc);
+			if (oids.empty() && !config.skip_missing_seqids)
+				throw runtime_error("Accession not found in database: " + acc + ". Use --skip-missing-seqids to ignore.");
+			seqs.insert(oids.begin(), oids.end());
+		}
+		seqidlist.clear();
+	}
 	if (!seqs.empty())
 		*message_stream << "#Selected sequences: " << seqs.size() << endl;
 
+	uint64_t end = sequence_count().value();
+	if (!all && (index || (seq_titles.empty() && seqidlist.empty()))) {
+		uint64_t last = seqs.empty() ? 0 : *seqs.rbegin() + 1;
+		if (!oid_titles.empty())
+			last = std::max(last, oid_titles.rbegin()->first + 1);
+		end = std::min(end, last);
+	}
+
 	const size_t max_letters = config.chunk_size == 0.0 ? std::numeric_limits<size_t>::max() : (size_t)(config.chunk_size * 1e9);
 	size_t letters = 0;
 	TextBuffer buf;
 	OutputFile out(config.output_file);
-	for (uint64_t n = 0; n < sequence_count().value(); ++n) {
+	init_seq_access();
+	for (uint64_t n = 0; n < end; ++n) {
 		read_seq(seq, id);
-		std::map<string, string>::const_iterator mapped_title = seq_titles.find(Util::Seq::seqid(id.c_str()));
-		if (all || seqs.find(n) != seqs.end() || mapped_title != seq_titles.end()) {
+		const string* mapped_title = nullptr;
+		bool listed = false;
+		if (index) {
+			const auto it = oid_titles.find(n);
+			if (it != oid_titles.end())
+				mapped_title = &it->second;
+		}
+		else if (!seq_titles.empty() || !seqidlist.empty()) {
+			const string acc = Util::Seq::seqid(id.c_str());
+			const auto it = seq_titles.find(acc);
+			if (it != seq_titles.end())
+				mapped_title = &it->second;
+			listed = seqidlist.find(acc) != seqidlist.end();
+		}
+		if (all || listed || seqs.find(n) != seqs.end() || mapped_title) {
 			if (config.reverse) {
-				buf << '>' << (mapped_title != seq_titles.end() ? mapped_title->second : id) << '\n';
+				buf << '>' << (mapped_title ? *mapped_title : id) << '\n';
 				Sequence(seq).print(buf, value_traits, Sequence::Reversed());
 				buf << '\n';
 			}
 			else if (config.hardmasked) {
-				buf << '>' << (mapped_title != seq_titles.end() ? mapped_title->second : id) << '\n';
+				buf << '>' << (mapped_title ? *mapped_title : id) << '\n';
 				Sequence(seq).print(buf, value_traits, Sequence::Hardmasked());
 				buf << '\n';
 			}
@@ -744,7 +795,7 @@ void SequenceFile::reserve_dict(const size_t ref_blocks)
 	}
 }
 
-std::string SequenceFile::dict_title(DictId dict_id, const size_t ref_block) const
+const char* SequenceFile::dict_title(DictId dict_id, const size_t ref_block) const
 {
 	const size_t b = dict_block(ref_block);
 	if (b >= dict_title_.size() || dict_id >= (DictId)dict_title_[b].size())
@@ -760,13 +811,12 @@ Loc SequenceFile::dict_len(DictId dict_id, const size_t ref_block)
 	return dict_len_[b][dict_id];
 }
 
-std::vector<Letter> SequenceFile::dict_seq(DictId dict_id, const size_t ref_block)
+Sequence SequenceFile::dict_seq(DictId dict_id, const size_t ref_block) const
 {
 	const size_t b = dict_block(ref_block);
 	if (b >= dict_seq_.size() || dict_id >= (DictId)dict_seq_[b].size())
 		throw std::runtime_error("Dictionary not loaded.");
-	Sequence s = dict_seq_[b][dict_id];
-	return vector<Letter>(s.data(), s.end());
+	return dict_seq_[b][dict_id];
 }
 
 DbFilter* SequenceFile::filter_by_taxonomy(std::istream& filter, char delimiter, bool exclude)
@@ -802,7 +852,94 @@ void SequenceFile::build_acc_to_oid() {
 	}
 }
 
+void SequenceFile::read_accessions(vector<string>& accessions) {
+	vector<Letter> seq;
+	string id;
+	read_seq(seq, id);
+	accessions.push_back(Util::Seq::seqid(id.c_str()));
+}
+
+const AccessionIndex* SequenceFile::accession_index() {
+	if (acc_index_)
+		return acc_index_.get();
+	if (type_ != Type::DMND && type_ != Type::BLAST)
+		return nullptr;
+	const uint64_t seqs = sequence_count().value(), letters = this->letters().value();
+	const string file_name = AccessionIndex::file_name(this->file_name());
+	if (exists(file_name)) {
+		try {
+			acc_index_.reset(new AccessionIndex(file_name));
+			if (acc_index_->matches(seqs, letters))
+				return acc_index_.get();
+			*message_stream << "Accession index does not match the database and will be rebuilt: " << file_name << endl;
+		}
+		catch (std::runtime_error& e) {
+			*message_stream << "Accession index is invalid and will be rebuilt: " << e.what() << endl;
+		}
+		acc_index_.reset();
+	}
+
+	TaskTimer timer("Reading database accessions");
+	ExternalSorter<AccessionIndex::T> accessions;
+	vector<string> acc;
+	init_seq_access();
+	for (OId i = 0; i < seqs; ++i) {
+		acc.clear();
+		read_accessions(acc);
+		for (const string& a : acc)
+			accessions.push({ a, i });
+	}
+	set_seqinfo_ptr(0);
+
+	timer.go("Building accession index");
+	string out_name = file_name;
+	bool temporary = false;
+	try {
+		AccessionIndex::write(file_name, accessions, seqs, letters);
+	}
+	catch (FileOpenException&) {
+		*message_stream << "Warning: could not write accession index file " << file_name << ", using a temporary index." << endl;
+		TempFile out(false);
+		out_name = out.file_name();
+		AccessionIndex::build(out, accessions, seqs, letters);
+		temporary = true;
+	}
+	acc_index_.reset(new AccessionIndex(out_name, temporary));
+	timer.finish();
+	*log_stream << "Accession index: " << out_name << " entries=" << acc_index_->size() << endl;
+	return acc_index_.get();
+}
+
+DbFilter* SequenceFile::filter_by_accession_index(const string& file_name) {
+	const AccessionIndex* index = accession_index();
+	if (!index)
+		throw OperationNotSupported();
+	unique_ptr<DbFilter> v(new DbFilter(sequence_count().value()));
+	File in(file_name, "rb", File::Flags::DETECT_COMPRESSION);
+	const char* l;
+	while (l = in.getline(), !in.eof() || l[0] != '\0') {
+		const vector<OId> oids = index->find(l);
+		if (oids.empty() && !config.skip_missing_seqids)
+			throw runtime_error("Accession not found in database: " + string(l) + ". Use --skip-missing-seqids to ignore.");
+		for (OId i : oids)
+			v->oid_filter.set(i);
+	}
+	in.close();
+	v->letter_count = letters_filtered(*v);
+	return v.release();
+}
+
 vector<OId> SequenceFile::accession_to_oid(const string& accession) const {
+	if (!flag_any(flags_, Flags::ACC_TO_OID_MAPPING)) {
+		// Loading the index does not change the state observable by the caller.
+		const AccessionIndex* index = const_cast<SequenceFile*>(this)->accession_index();
+		if (index) {
+			vector<OId> r = index->find(accession);
+			if (r.empty())
+				throw runtime_error("Accession not found in database: " + accession);
+			return r;
+		}
+	}
 	try {
 		return { acc2oid_.at(accession) };
 	}
@@ -44,6 +44,7 @@ struct OperationNotSupported : public std::exception {
 };
 
 struct FastaFile;
+struct AccessionIndex;
 
 constexpr int MAX_LINEAGE = 256;
 
@@ -147,9 +148,10 @@ struct SequenceFile {
 	virtual void read_id_data(const int64_t oid, char* dst, size_t len, bool all, bool full_titles) = 0;
 	virtual void skip_id_data() = 0;
 	virtual std::string seqid(OId oid, bool all, bool full_titles);
-	virtual std::string dict_title(DictId dict_id, const size_t ref_block) const final;
+	// Dictionary accessors return views into the loaded dictionary, valid until end_random_access().
+	virtual const char* dict_title(DictId dict_id, const size_t ref_block) const final;
 	virtual Loc dict_len(DictId dict_id, const size_t ref_block);
-	std::vector<Letter> dict_seq(DictId dict_id, const size_t ref_block);
+	Sequence dict_seq(DictId dict_id, const size_t ref_block) const;
 	virtual optional<uint64_t> sequence_count() const = 0;
 	virtual optional<uint64_t> letters() const = 0;
 	virtual size_t letters_filtered(const DbFilter& v);
@@ -181,6 +183,7 @@ struct SequenceFile {
 	void init_random_access(const size_t query_block, const size_t ref_blocks, bool dictionary = true);
 	virtual void end_random_access(bool dictionary = true) = 0;
 	virtual std::vector<OId> accession_to_oid(const std::string& acc) const;
+	const AccessionIndex* accession_index();
 	virtual void init_write();
 	virtual void write_seq(const Sequence& seq, const std::string& id);
 	virtual ~SequenceFile();
@@ -251,6 +254,8 @@ protected:
 	void free_dictionary();
 	static size_t dict_block(const size_t ref_block);
 	void build_acc_to_oid();
+	virtual void read_accessions(std::vector<std::string>& accessions);
+	DbFilter* filter_by_accession_index(const std::string& file_name);
 	std::pair<int64_t, int64_t> read_fai_file(const std::string& file_name, int64_t seqs, int64_t letters);
 	void add_seqid_mapping(const std::string& id, OId oid);
 	void init_cache();
@@ -269,6 +274,7 @@ protected:
 	std::vector<SequenceSet> dict_seq_;
 	std::vector<std::vector<double>> dict_self_aln_score_;
 	std::unordered_map<std::string, OId> acc2oid_;
+	std::unique_ptr<AccessionIndex> acc_index_;
 	std::vector<Loc> seq_length_;
 	std::string open_stats_;
 
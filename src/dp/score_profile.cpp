@@ -38,12 +38,12 @@ LongScoreProfile<Score> make_profile(Sequence seq, const int8_t* cbs, int64_t pa
 		const int8_t* scores = &matrix.matrix8()[l << 5];
 		p.data[l].reserve(round_up(seq.length(), 32) + 2 * p.padding);
 		p.data[l].insert(p.data[l].end(), p.padding, -1);
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 		using Sv = ::DISPATCH_ARCH::ScoreVector<int8_t, 0>;
 		constexpr auto CHANNELS = ::DISPATCH_ARCH::ScoreTraits<Sv>::CHANNELS;
-		alignas(32) array<Score, CHANNELS> buf;
+		alignas(64) array<Score, CHANNELS> buf;
 		for (Loc i = 0; i < seq.length(); i += CHANNELS) {
-			__m256i s = _mm256_loadu_si256((const __m256i*)(seq.data() + i));
+			const typename ::DISPATCH_ARCH::ScoreTraits<Sv>::Vector s(seq.data() + i);
 			Sv scores(l, s, matrix.matrix8_low(), matrix.matrix8_high());
 			if (cbs && l < TRUE_AA)
 				scores += Sv(cbs + i);
@@ -25,7 +25,167 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace DISPATCH_ARCH {
 
-#if ARCH_ID == 2 || ARCH_ID == 3
+#if ARCH_ID == 3
+
+template<int DELTA>
+struct ScoreVector<int16_t, DELTA>
+{
+
+	typedef __m512i Register;
+
+	ScoreVector() :
+		data_(_mm512_set1_epi16(DELTA))
+	{}
+
+	explicit ScoreVector(int x)
+	{
+		data_ = _mm512_set1_epi16(x);
+	}
+
+	explicit ScoreVector(int16_t x)
+	{
+		data_ = _mm512_set1_epi16(x);
+	}
+
+	explicit ScoreVector(__m512i data) :
+		data_(data)
+	{ }
+
+	explicit ScoreVector(const int16_t* x) :
+		data_(_mm512_loadu_si512((const __m512i*)x))
+	{}
+
+	explicit ScoreVector(const uint16_t* x) :
+		data_(_mm512_loadu_si512((const __m512i*)x))
+	{}
+
+	ScoreVector(unsigned a, Register seq)
+	{
+		const __m512i r1 = _mm512_broadcast_i64x4(_mm256_load_si256(reinterpret_cast<const __m256i*>(&score_matrix.matrix8u_low()[a << 5])));
+		const __m512i r2 = _mm512_broadcast_i64x4(_mm256_load_si256(reinterpret_cast<const __m256i*>(&score_matrix.matrix8u_high()[a << 5])));
+
+		__m512i high_mask = _mm512_slli_epi16(_mm512_and_si512(seq, _mm512_set1_epi8('\x10')), 3);
+		__m512i seq_low = _mm512_or_si512(seq, high_mask);
+		__m512i seq_high = _mm512_or_si512(seq, _mm512_xor_si512(high_mask, _mm512_set1_epi8('\x80')));
+
+		__m512i s1 = _mm512_shuffle_epi8(r1, seq_low);
+		__m512i s2 = _mm512_shuffle_epi8(r2, seq_high);
+		data_ = _mm512_and_si512(_mm512_or_si512(s1, s2), _mm512_set1_epi16(255));
+		data_ = _mm512_subs_epi16(data_, _mm512_set1_epi16(score_matrix.bias()));
+	}
+
+	ScoreVector operator+(const ScoreVector& rhs) const
+	{
+		return ScoreVector(_mm512_adds_epi16(data_, rhs.data_));
+	}
+
+	ScoreVector operator-(const ScoreVector& rhs) const
+	{
+		return ScoreVector(_mm512_subs_epi16(data_, rhs.data_));
+	}
+
+	ScoreVector& operator+=(const ScoreVector& rhs) {
+		data_ = _mm512_adds_epi16(data_, rhs.data_);
+		return *this;
+	}
+
+	ScoreVector& operator-=(const ScoreVector& rhs)
+	{
+		data_ = _mm512_subs_epi16(data_, rhs.data_);
+		return *this;
+	}
+
+	ScoreVector& operator &=(const ScoreVector& rhs) {
+		data_ = _mm512_and_si512(data_, rhs.data_);
+		return *this;
+	}
+
+	ScoreVector& operator++() {
+		data_ = _mm512_adds_epi16(data_, _mm512_set1_epi16(1));
+		return *this;
+	}
+
+	ScoreVector& max(const ScoreVector& rhs)
+	{
+		data_ = _mm512_max_epi16(data_, rhs.data_);
+		return *this;
+	}
+
+	template<int i>
+	ScoreVector shift_left() const {
+		return ScoreVector(_mm512_bslli_epi128(data_, i));
+	}
+
+	ScoreVector operator==(const ScoreVector& v) const {
+		return ScoreVector(_mm512_movm_epi16(_mm512_cmpeq_epi16_mask(data_, v.data_)));
+	}
+
+	ScoreVector operator>(const ScoreVector& v) const {
+		return ScoreVector(_mm512_movm_epi16(_mm512_cmpgt_epi16_mask(data_, v.data_)));
+	}
+
+	friend uint32_t cmp_mask(const ScoreVector& v, const ScoreVector& w) {
+		return (uint32_t)_mm512_cmpeq_epi16_mask(v.data_, w.data_);
+	}
+
+	friend ScoreVector max(const ScoreVector& lhs, const ScoreVector& rhs)
+	{
+		return ScoreVector(_mm512_max_epi16(lhs.data_, rhs.data_));
+	}
+
+	void store(int16_t* ptr) const
+	{
+		_mm512_storeu_si512((__m512i*)ptr, data_);
+	}
+
+	void store_aligned(int16_t* ptr) const
+	{
+		_mm512_store_si512((__m512i*)ptr, data_);
+	}
+
+	int16_t operator[](int i) const {
+		int16_t d[32];
+		store(d);
+		return d[i];
+	}
+
+	ScoreVector& set(int i, int16_t x) {
+		data_ = _mm512_mask_set1_epi16(data_, (__mmask32)1 << i, x);
+		return *this;
+	}
+
+	void expand_from_8bit() {
+		data_ = _mm512_cvtepi8_epi16(_mm512_castsi512_si256(data_));
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, ScoreVector v)
+	{
+		int16_t x[32];
+		v.store(x);
+		for (unsigned i = 0; i < 32; ++i)
+			printf("%3i ", (int)x[i]);
+		return s;
+	}
+
+	static ScoreVector load_aligned(const int16_t* x) {
+		return ScoreVector(_mm512_load_si512((const __m512i*)x));
+	}
+
+	__m512i data_;
+
+};
+
+template<int i, int DELTA>
+static inline int16_t extract(ScoreVector<int16_t, DELTA> sv) {
+	return sv[i];
+}
+
+template<int DELTA>
+static inline ScoreVector<int16_t, DELTA> blend(const ScoreVector<int16_t, DELTA>& v, const ScoreVector<int16_t, DELTA>& w, const ScoreVector<int16_t, DELTA>& mask) {
+	return ScoreVector<int16_t, DELTA>(_mm512_mask_blend_epi16(_mm512_movepi16_mask(mask.data_), v.data_, w.data_));
+}
+
+#elif ARCH_ID == 2
 
 template<int DELTA>
 struct ScoreVector<int16_t, DELTA>
@@ -536,7 +696,23 @@ template<int DELTA>
 struct ScoreTraits<ScoreVector<int16_t, DELTA>>
 {
 	typedef ::DISPATCH_ARCH::SIMD::Vector<int16_t> Vector;
-#if ARCH_ID == 2
+#if ARCH_ID == 3
+	enum { CHANNELS = 32 };
+	typedef uint32_t Mask;
+	struct TraceMask {
+		static uint64_t make(uint32_t vmask, uint32_t hmask) {
+			return (uint64_t)vmask << 32 | (uint64_t)hmask;
+		}
+		static uint64_t vmask(int channel) {
+			return (uint64_t)1 << (channel + 32);
+		}
+		static uint64_t hmask(int channel) {
+			return (uint64_t)1 << channel;
+		}
+		uint64_t gap;
+		uint64_t open;
+	};
+#elif ARCH_ID == 2
 	enum { CHANNELS = 16 };
 	typedef uint16_t Mask;
 	struct TraceMask {
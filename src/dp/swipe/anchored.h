@@ -39,7 +39,7 @@ using std::tie;
 
 namespace DP { namespace AnchoredSwipe {
 
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 	
 namespace DISPATCH_ARCH {
 
@@ -201,7 +201,7 @@ Stats FLATTEN smith_waterman(DP::AnchoredSwipe::Target<typename ::DISPATCH_ARCH:
 	if (target_count == 0)
 		return Stats();
 
-	alignas(32) Score scores[CHANNELS * CHANNELS];
+	alignas(64) Score scores[CHANNELS * CHANNELS];
 	Loc band_max, target_len_max;
 	tie(band_max, target_len_max) = limits(targets, target_count);
 	DP::BandedSwipe::DISPATCH_ARCH::Matrix<ScoreVector> matrix(round_up(band_max, CHANNELS), 0, ScoreVector(SCORE_MIN));
@@ -225,7 +225,7 @@ Stats FLATTEN smith_waterman(DP::AnchoredSwipe::Target<typename ::DISPATCH_ARCH:
 			ScoreVector vgap = ScoreVector(SCORE_MIN), hgap = ScoreVector(), col_best = ScoreVector(SCORE_MIN), row_counter(0), col_max_i(0);
 
 			for (int i = 0; i < band;) {
-				transpose_offset(prof_ptr.data(), CHANNELS, i / CHANNELS, scores, __m256i());
+				transpose_offset(prof_ptr.data(), CHANNELS, i / CHANNELS, scores, typename ::DISPATCH_ARCH::ScoreTraits<ScoreVector>::Vector());
 				const Score* score_ptr = scores;
 
 				do {
@@ -28,7 +28,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "align/def.h"
 #include "stats/stats.h"
 
-using std::list;
 using std::vector;
 using std::unique_ptr;
 using std::pair;
@@ -121,13 +120,18 @@ static void swipe_threads(DP::AnchoredSwipe::Target<int16_t>* targets, int64_t c
 	using Target = DP::AnchoredSwipe::Target<int16_t>;
 	ThreadPool::TaskSet task_set(*cfg.thread_pool, 0);
 	int64_t size = 0;
+#if ARCH_ID == 2 || ARCH_ID == 3
+	constexpr ptrdiff_t CHANNELS = ::DISPATCH_ARCH::ScoreTraits<::DISPATCH_ARCH::ScoreVector<int16_t, 0>>::CHANNELS;
+#else
+	constexpr ptrdiff_t CHANNELS = 16;
+#endif
 	Target* i0 = targets, *i1 = targets, *end = targets + count;
 	while (i1 < end) {
-		const auto n = std::min((ptrdiff_t)16, end - i1);
+		const auto n = std::min(CHANNELS, end - i1);
 		size += accumulate(i1, i1 + n, (int64_t)0, [](int64_t n, const Target& t) {return n + t.gross_cells(); });
 		i1 += n;
 		if (size >= config.swipe_task_size) {
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 			task_set.enqueue(DP::AnchoredSwipe::DISPATCH_ARCH::smith_waterman<::DISPATCH_ARCH::ScoreVector<int16_t, 0>>, i0, i1 - i0, options);
 #endif
 			cfg.stats.inc(Statistics::SWIPE_TASKS_TOTAL);
@@ -138,7 +142,7 @@ static void swipe_threads(DP::AnchoredSwipe::Target<int16_t>* targets, int64_t c
 	}
 	if (task_set.total() == 0) {
 		cfg.stats.inc(Statistics::SWIPE_TASKS_TOTAL);
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 		DP::AnchoredSwipe::DISPATCH_ARCH::smith_waterman<::DISPATCH_ARCH::ScoreVector<int16_t, 0>>(i0, i1 - i0, options);
 #endif
 		return;
@@ -146,7 +150,7 @@ static void swipe_threads(DP::AnchoredSwipe::Target<int16_t>* targets, int64_t c
 	if (i1 - i0 > 0) {
 		cfg.stats.inc(Statistics::SWIPE_TASKS_TOTAL);
 		cfg.stats.inc(Statistics::SWIPE_TASKS_ASYNC);
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 		task_set.enqueue(DP::AnchoredSwipe::DISPATCH_ARCH::smith_waterman<::DISPATCH_ARCH::ScoreVector<int16_t, 0>>, i0, i1 - i0, options);
 #endif
 	}
@@ -160,8 +164,8 @@ const ScoreMatrix& select_matrix(int qlen) {
 	return score_matrix;
 }
 
-list<Hsp> anchored_swipe(Targets& targets, const DP::AnchoredSwipe::Config& cfg, std::pmr::monotonic_buffer_resource& pool) {
-#if ARCH_ID != 2
+HspVector anchored_swipe(Targets& targets, const DP::AnchoredSwipe::Config& cfg, std::pmr::monotonic_buffer_resource& pool) {
+#if ARCH_ID < 2
 	throw runtime_error("Anchored SWIPE requires at least AVX2 support");
 #endif
 	TaskTimer total;
@@ -233,7 +237,8 @@ list<Hsp> anchored_swipe(Targets& targets, const DP::AnchoredSwipe::Config& cfg,
 
 	timer.go();
 	auto target_it = target_vec.int16.cbegin();
-	list<Hsp> out;
+	HspVector out;
+	out.reserve(target_count);
 	DP::Targets recompute;
 	std::pmr::list<Stats::TargetMatrix> matrices(&pool);
 	Stats::Composition query_comp(Stats::composition(cfg.query));
@@ -320,7 +325,7 @@ list<Hsp> anchored_swipe(Targets& targets, const DP::AnchoredSwipe::Config& cfg,
 	if (cfg.recompute_adjusted) {
 		DP::Params params{ cfg.query, nullptr, Frame(0), cfg.query.length(), nullptr, DP::Flags::NONE, false,
 		0, 0, HspValues::COORDS, cfg.stats, cfg.thread_pool };
-		out.splice(out.end(), DP::BandedSwipe::swipe(recompute, params));
+		append(out, DP::BandedSwipe::swipe(recompute, params));
 		return out;
 	}
 	return out;
@@ -328,6 +333,6 @@ list<Hsp> anchored_swipe(Targets& targets, const DP::AnchoredSwipe::Config& cfg,
 
 }
 
-DISPATCH_3(std::list<Hsp>, anchored_swipe, Targets&, targets, const DP::AnchoredSwipe::Config&, cfg, std::pmr::monotonic_buffer_resource&, pool)
+DISPATCH_3(HspVector, anchored_swipe, Targets&, targets, const DP::AnchoredSwipe::Config&, cfg, std::pmr::monotonic_buffer_resource&, pool)
 
 }}
\ No newline at end of file
@@ -31,7 +31,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../score_vector_int16.h"
 #include "../score_vector_int8.h"
 
-using std::list;
 using std::thread;
 using std::atomic;
 using std::pair;
@@ -406,7 +405,7 @@ Hsp traceback(Sequence *query, Strand strand, int dna_len, const Banded3FrameSwi
 }
 
 template<typename Sv, typename Traceback>
-list<Hsp> banded_3frame_swipe(
+HspVector banded_3frame_swipe(
 	const TranslatedSequence& query,
 	Strand strand, std::vector<DpTarget>::const_iterator subject_begin,
 	std::vector<DpTarget>::const_iterator subject_end,
@@ -515,7 +514,7 @@ list<Hsp> banded_3frame_swipe(
 		++j;
 	}
 	
-	list<Hsp> out;
+	HspVector out;
 	for (int i = 0; i < targets.n_targets; ++i) {
 		if (best[i] < ScoreTraits<Sv>::max_score()) {
 			const int score = ScoreTraits<Sv>::int_score(best[i]) * config.cbs_matrix_scale;
@@ -530,7 +529,7 @@ list<Hsp> banded_3frame_swipe(
 }
 
 template<typename Sv>
-list<Hsp> banded_3frame_swipe_targets(std::vector<DpTarget>::const_iterator begin,
+HspVector banded_3frame_swipe_targets(std::vector<DpTarget>::const_iterator begin,
 	vector<DpTarget>::const_iterator end,
 	bool score_only,
 	const TranslatedSequence &query,
@@ -539,12 +538,12 @@ list<Hsp> banded_3frame_swipe_targets(std::vector<DpTarget>::const_iterator begi
 	bool parallel,
 	std::vector<DpTarget> &overflow)
 {
-	list<Hsp> out;
+	HspVector out;
 	for (vector<DpTarget>::const_iterator i = begin; i < end; i += std::min((ptrdiff_t)ScoreTraits<Sv>::CHANNELS, end - i)) {
 		if (score_only)
-			out.splice(out.end(), banded_3frame_swipe<Sv, DP::ScoreOnly>(query, strand, i, i + std::min(ptrdiff_t(ScoreTraits<Sv>::CHANNELS), end - i), stat, parallel, overflow));
+			append(out, banded_3frame_swipe<Sv, DP::ScoreOnly>(query, strand, i, i + std::min(ptrdiff_t(ScoreTraits<Sv>::CHANNELS), end - i), stat, parallel, overflow));
 		else
-			out.splice(out.end(), banded_3frame_swipe<Sv, DP::Traceback>(query, strand, i, i + std::min(ptrdiff_t(ScoreTraits<Sv>::CHANNELS), end - i), stat, parallel, overflow));
+			append(out, banded_3frame_swipe<Sv, DP::Traceback>(query, strand, i, i + std::min(ptrdiff_t(ScoreTraits<Sv>::CHANNELS), end - i), stat, parallel, overflow));
 	}
 	return out;
 }
@@ -555,7 +554,7 @@ void banded_3frame_swipe_worker(std::vector<DpTarget>::const_iterator begin,
 	bool score_only,
 	const TranslatedSequence *query,
 	Strand strand,
-	list<Hsp> *out,
+	HspVector *out,
 	vector<DpTarget> *overflow)
 {
 	DpStat stat;
@@ -564,30 +563,29 @@ void banded_3frame_swipe_worker(std::vector<DpTarget>::const_iterator begin,
 	while (begin + (pos = next->fetch_add(config.swipe_chunk_size, std::memory_order_relaxed)) < end)
 #if defined(__SSE2__) | defined(__ARM_NEON)
 		if(score_only)
-			out->splice(out->end(), banded_3frame_swipe_targets<ScoreVector<int16_t, SHRT_MIN>>(begin + pos, min(begin + pos + config.swipe_chunk_size, end), score_only, *query, strand, stat, true, of));
+			append(*out, banded_3frame_swipe_targets<ScoreVector<int16_t, SHRT_MIN>>(begin + pos, min(begin + pos + config.swipe_chunk_size, end), score_only, *query, strand, stat, true, of));
 		else
-			out->splice(out->end(), banded_3frame_swipe_targets<int32_t>(begin + pos, min(begin + pos + config.swipe_chunk_size, end), score_only, *query, strand, stat, true, of));
+			append(*out, banded_3frame_swipe_targets<int32_t>(begin + pos, min(begin + pos + config.swipe_chunk_size, end), score_only, *query, strand, stat, true, of));
 #else
-		out->splice(out->end(), banded_3frame_swipe_targets<int32_t>(begin + pos, min(begin + pos + config.swipe_chunk_size, end), score_only, *query, strand, stat, true, of));
+		append(*out, banded_3frame_swipe_targets<int32_t>(begin + pos, min(begin + pos + config.swipe_chunk_size, end), score_only, *query, strand, stat, true, of));
 #endif
 	*overflow = std::move(of);
 }
 
-list<Hsp> banded_3frame_swipe(const TranslatedSequence &query, Strand strand, vector<DpTarget>::iterator target_begin, vector<DpTarget>::iterator target_end, DpStat &stat, bool score_only, bool parallel)
+HspVector banded_3frame_swipe(const TranslatedSequence &query, Strand strand, vector<DpTarget>::iterator target_begin, vector<DpTarget>::iterator target_end, DpStat &stat, bool score_only, bool parallel)
 {
 	vector<DpTarget> overflow16, overflow32;
 #if defined (__SSE2__) | defined(__ARM_NEON)
 	TaskTimer timer("Banded 3frame swipe (sort)", parallel ? 3 : UINT_MAX);
 	std::stable_sort(target_begin, target_end);
-	list<Hsp> out;
+	HspVector out;
 	if (parallel) {
 		timer.go("Banded 3frame swipe (run)");
 		vector<thread> threads;
-		vector<list<Hsp>*> thread_out;
+		vector<HspVector> thread_out(config.threads_);
 		vector<vector<DpTarget>> thread_overflow(config.threads_);
 		atomic<size_t> next(0);
 		for (int i = 0; i < config.threads_; ++i) {
-			thread_out.push_back(new list<Hsp>);
 			threads.emplace_back(banded_3frame_swipe_worker,
 				target_begin,
 				target_end,
@@ -595,16 +593,14 @@ list<Hsp> banded_3frame_swipe(const TranslatedSequence &query, Strand strand, ve
 				score_only,
 				&query,
 				strand,
-				thread_out.back(),
+				&thread_out[i],
 				&thread_overflow[i]);
 		}
 		for (auto &t : threads)
 			t.join();
 		timer.go("Banded 3frame swipe (merge)");
-		for (list<Hsp>* l : thread_out) {
-			out.splice(out.end(), *l);
-			delete l;
-		}
+		for (HspVector& v : thread_out)
+			append(out, std::move(v));
 		overflow16.reserve(std::accumulate(thread_overflow.begin(), thread_overflow.end(), (size_t)0, [](size_t n, const vector<DpTarget> &v) { return n + v.size(); }));
 		for (const vector<DpTarget> &v : thread_overflow)
 			overflow16.insert(overflow16.end(), v.begin(), v.end());
@@ -616,7 +612,7 @@ list<Hsp> banded_3frame_swipe(const TranslatedSequence &query, Strand strand, ve
 			out = banded_3frame_swipe_targets<int32_t>(target_begin, target_end, score_only, query, strand, stat, false, overflow16);
 	}
 
-	out.splice(out.end(), banded_3frame_swipe_targets<int32_t>(overflow16.begin(), overflow16.end(), score_only, query, strand, stat, false, overflow32));
+	append(out, banded_3frame_swipe_targets<int32_t>(overflow16.begin(), overflow16.end(), score_only, query, strand, stat, false, overflow32));
 	return out;
 #else
 	return banded_3frame_swipe_targets<int32_t>(target_begin, target_end, score_only, query, strand, stat, false, overflow32);
@@ -625,4 +621,4 @@ list<Hsp> banded_3frame_swipe(const TranslatedSequence &query, Strand strand, ve
 
 }
 
-DISPATCH_7(std::list<Hsp>, banded_3frame_swipe, const TranslatedSequence&, query, Strand, strand, std::vector<DpTarget>::iterator, target_begin, std::vector<DpTarget>::iterator, target_end, DpStat&, stat, bool, score_only, bool, parallel)
\ No newline at end of file
+DISPATCH_7(HspVector, banded_3frame_swipe, const TranslatedSequence&, query, Strand, strand, std::vector<DpTarget>::iterator, target_begin, std::vector<DpTarget>::iterator, target_end, DpStat&, stat, bool, score_only, bool, parallel)
\ No newline at end of file
@@ -19,7 +19,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <array>
 #include <utility>
-#include <list>
 #include "../dp.h"
 #include "swipe.h"
 #include "target_iterator.h"
@@ -27,7 +26,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/data_structures/range_partition.h"
 #include "banded_matrix.h"
 
-using std::list;
 using std::pair;
 using std::vector;
 using std::array;
@@ -186,7 +184,7 @@ Hsp traceback(Cbs bias_correction, const TracebackVectorMatrix<Sv> &dp, const Dp
 	return out;
 }
 template<typename Sv, typename Cbs, typename Cfg>
-list<Hsp> swipe(const TargetVec::const_iterator subject_begin, const TargetVec::const_iterator subject_end, Cbs composition_bias, TargetVec& overflow, Params& p)
+HspVector swipe(const TargetVec::const_iterator subject_begin, const TargetVec::const_iterator subject_end, Cbs composition_bias, TargetVec& overflow, Params& p)
 {
 	typedef typename ScoreTraits<Sv>::Score Score;
 	using Cell = typename Cfg::Cell;
@@ -226,13 +224,13 @@ list<Hsp> swipe(const TargetVec::const_iterator subject_begin, const TargetVec::
 	::DISPATCH_ARCH::TargetIterator<Score> targets(subject_begin, subject_end, p.reverse_targets, i1, qlen, d_begin);
 	Matrix dp(band, targets.cols);
 
-	const uint32_t cbs_mask = targets.cbs_mask();
+	const uint64_t cbs_mask = targets.cbs_mask();
 	const Score go = score_matrix.gap_open() + score_matrix.gap_extend(), go_s = go * (Score)config.cbs_matrix_scale,
 		ge = score_matrix.gap_extend(), ge_s = ge * (Score)config.cbs_matrix_scale;
 	const Sv open_penalty = blend_sv<Sv>(go, go_s, cbs_mask),
 		extend_penalty = blend_sv<Sv>(ge, ge_s, cbs_mask);
 	SwipeProfile<Sv> profile;
-	array<const int8_t*, 32> target_scores;
+	array<const int8_t*, std::max(CHANNELS, 32)> target_scores;
 
 	Score best[CHANNELS];
 	int max_col[CHANNELS], max_band_row[CHANNELS];
@@ -331,7 +329,7 @@ list<Hsp> swipe(const TargetVec::const_iterator subject_begin, const TargetVec::
 		++j;
 	}
 
-	list<Hsp> out;
+	HspVector out;
 	TaskTimer timer;
 	for (int i = 0; i < targets.n_targets; ++i) {
 		if (best[i] < ScoreTraits<Sv>::max_score() && !overflow_stats<Sv>(stats[i])) {
@@ -28,7 +28,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../score_vector_int8.h"
 
 using std::vector;
-using std::list;
 using std::pair;
 using std::max;
 using namespace DISPATCH_ARCH;
@@ -132,7 +131,7 @@ Hsp traceback(Cbs bias_correction, const TracebackVectorMatrix<Sv> &dp, const Dp
 }
 
 template<typename Sv, typename Cbs, typename It, typename Cfg>
-list<Hsp> swipe(const It target_begin, const It target_end, std::atomic<BlockId>* const next, Cbs composition_bias, TargetVec& overflow, Params& p)
+HspVector swipe(const It target_begin, const It target_end, std::atomic<BlockId>* const next, Cbs composition_bias, TargetVec& overflow, Params& p)
 {
 	using Score = typename ScoreTraits<Sv>::Score;
 	using Cell = typename Cfg::Cell;
@@ -158,11 +157,11 @@ list<Hsp> swipe(const It target_begin, const It target_end, std::atomic<BlockId>
 	StatType hsp_stats[CHANNELS];
 	std::fill(best, best + CHANNELS, ScoreTraits<Sv>::zero_score());
 	SwipeProfile<Sv> profile;
-	std::array<const int8_t*, 32> target_scores;
+	std::array<const int8_t*, std::max(CHANNELS, 32)> target_scores;
 	AsyncTargetBuffer<Score, It> targets(target_begin, target_end, p.target_max_len, p.reverse_targets, next);
 	Matrix dp(qlen, targets.max_len());
 	CBSBuffer<Sv, Cbs> cbs_buf(composition_bias, qlen, 0);
-	list<Hsp> out;
+	HspVector out;
 	int col = 0;
 	
 	while (targets.active.size() > 0) {
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 #include <assert.h>
+#include <string.h>
 #include <vector>
 #include "../score_vector.h"
 #include "basic/value.h"
@@ -33,7 +34,7 @@ namespace DP {
 
 template<typename Sv, typename Cbs>
 struct CBSBuffer {
-	CBSBuffer(const DP::NoCBS&, int, uint32_t) {}
+	CBSBuffer(const DP::NoCBS&, int, uint64_t) {}
 	void* operator()(int i) const {
 		return nullptr;
 	}
@@ -41,7 +42,7 @@ struct CBSBuffer {
 
 template<typename Sv>
 struct CBSBuffer<Sv, const int8_t*> {
-	CBSBuffer(const int8_t* v, int l, uint32_t channel_mask) {
+	CBSBuffer(const int8_t* v, int l, uint64_t channel_mask) {
 		typedef typename ::DISPATCH_ARCH::ScoreTraits<Sv>::Score Score;
 		data.reserve(l);
 		for (int i = 0; i < l; ++i)
@@ -50,7 +51,7 @@ struct CBSBuffer<Sv, const int8_t*> {
 	Sv operator()(int i) const {
 		return data[i];
 	}
-	std::vector<Sv, Util::Memory::AlignmentAllocator<Sv, 32>> data;
+	std::vector<Sv, Util::Memory::AlignmentAllocator<Sv, (alignof(Sv) > 32 ? alignof(Sv) : 32)>> data;
 };
 
 template<typename Sv>
@@ -102,7 +103,17 @@ struct SwipeProfile
 	}
 
 	void set(const int8_t** target_scores) {
-#if ARCH_ID == 2
+#if ARCH_ID == 3
+		// The rows of 32 letter scores are transposed in groups of 32 channels.
+		alignas(32) int8_t t[32 * 32];
+		for (int k = 0; k < ScoreTraits<Sv>::CHANNELS / 32; ++k) {
+			transpose(target_scores + k * 32, 32, t, __m256i());
+			for (size_t i = 0; i < AMINO_ACID_COUNT; ++i)
+				memcpy((int8_t*)&data_[i] + k * 32, &t[i * 32], 32);
+		}
+		for (size_t i = 0; i < AMINO_ACID_COUNT; ++i)
+			data_[i].expand_from_8bit();
+#elif ARCH_ID == 2
 		transpose(target_scores, 32, (int8_t*)data_, __m256i());
 		for (size_t i = 0; i < AMINO_ACID_COUNT; ++i)
 			data_[i].expand_from_8bit();
@@ -17,7 +17,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 // SPDX-License-Identifier: GPL-3.0-or-later
 
-#include <list>
 #include <atomic>
 #include <thread>
 #include <mutex>
@@ -38,7 +37,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "stats/stats.h"
 
 using std::unique_ptr;
-using std::list;
 using std::atomic;
 using std::thread;
 using std::array;
@@ -123,33 +121,33 @@ static bool reversed(const HspValues v) {
 }
 
 template<typename Sv, typename Cbs, typename Cfg>
-static list<Hsp> dispatch_swipe(const TargetVec::const_iterator subject_begin, const TargetVec::const_iterator subject_end, Cbs composition_bias, TargetVec& overflow, Params& p)
+static HspVector dispatch_swipe(const TargetVec::const_iterator subject_begin, const TargetVec::const_iterator subject_end, Cbs composition_bias, TargetVec& overflow, Params& p)
 {
 	return ::DP::BandedSwipe::DISPATCH_ARCH::swipe<Sv, Cbs, Cfg>(subject_begin, subject_end, composition_bias, overflow, p);
 }
 
 template<typename Sv, typename Cbs, typename Cfg>
-static list<Hsp> dispatch_swipe(const SequenceSet::ConstIterator subject_begin, const SequenceSet::ConstIterator subject_end, Cbs composition_bias, TargetVec& overflow, Params& p)
+static HspVector dispatch_swipe(const SequenceSet::ConstIterator subject_begin, const SequenceSet::ConstIterator subject_end, Cbs composition_bias, TargetVec& overflow, Params& p)
 {
 	return {};
 }
 
 template<typename Sv, typename Cbs, typename It, typename Cfg>
-static list<Hsp> dispatch_swipe(const It begin, const It end, atomic<BlockId>* const next, Cbs composition_bias, TargetVec& overflow, Params& p)
+static HspVector dispatch_swipe(const It begin, const It end, atomic<BlockId>* const next, Cbs composition_bias, TargetVec& overflow, Params& p)
 {
 	constexpr auto CHANNELS = TargetVec::const_iterator::difference_type(::DISPATCH_ARCH::ScoreTraits<Sv>::CHANNELS);
 	if (flag_any(p.flags, Flags::FULL_MATRIX))
 		return ::DP::Swipe::DISPATCH_ARCH::swipe<Sv, Cbs, It, Cfg>(begin, end, next, composition_bias, overflow, p);
 	else {
-		list<Hsp> out;
+		HspVector out;
 		for (It i = begin; i < end; i += std::min(CHANNELS, end - i))
-			out.splice(out.end(), dispatch_swipe<Sv, Cbs, Cfg>(i, i + std::min(CHANNELS, end - i), composition_bias, overflow, p));
+			append(out, dispatch_swipe<Sv, Cbs, Cfg>(i, i + std::min(CHANNELS, end - i), composition_bias, overflow, p));
 		return out;
 	}
 }
 
 template<typename Sv, typename It, typename Cfg>
-static list<Hsp> dispatch_swipe(const It begin, const It end, atomic<BlockId>* const next, TargetVec &overflow, Params& p)
+static HspVector dispatch_swipe(const It begin, const It end, atomic<BlockId>* const next, TargetVec &overflow, Params& p)
 {
 	if (p.composition_bias == nullptr)
 		return dispatch_swipe<Sv, NoCBS, It, Cfg>(begin, end, next, NoCBS(), overflow, p);
@@ -158,7 +156,7 @@ static list<Hsp> dispatch_swipe(const It begin, const It end, atomic<BlockId>* c
 }
 
 template<typename Sv, typename It>
-static list<Hsp> dispatch_swipe(const It begin, const It end, atomic<BlockId>* const next, TargetVec &overflow, const int round, const int bin, Params& p)
+static HspVector dispatch_swipe(const It begin, const It end, atomic<BlockId>* const next, TargetVec &overflow, const int round, const int bin, Params& p)
 {
 	if (p.v == HspValues::NONE) {
 		using Cfg = SwipeConfig<false, DummyRowCounter<Sv>, Sv, DummyIdMask<Sv>>;
@@ -192,8 +190,9 @@ static list<Hsp> dispatch_swipe(const It begin, const It end, atomic<BlockId>* c
 }
 
 template<typename Sv, typename It>
-static void swipe_worker(const It begin, const It end, atomic<BlockId>* const next, list<Hsp> *out, TargetVec *overflow, const int round, const int bin, Params* p)
+static void swipe_worker(const It begin, const It end, atomic<BlockId>* const next, HspVector *out, TargetVec *overflow, const int round, const int bin, Params* p, Util::Memory::ThreadArenas* arenas)
 {
+	Util::Memory::ArenaScope arena_scope(arenas);
 	const ptrdiff_t CHANNELS = ::DISPATCH_ARCH::ScoreTraits<Sv>::CHANNELS;
 	Statistics stat2;
 	size_t pos;
@@ -217,7 +216,7 @@ static void swipe_worker(const It begin, const It end, atomic<BlockId>* const ne
 	else
 		while (begin + (pos = next->fetch_add(CHANNELS, std::memory_order_relaxed)) < end) {
 			const auto start = begin + pos;
-			out->splice(out->end(), dispatch_swipe<Sv, It>(start, start + std::min(CHANNELS, end - start), next, of, round, bin, params));
+			append(*out, dispatch_swipe<Sv, It>(start, start + std::min(CHANNELS, end - start), next, of, round, bin, params));
 		}
 		
 	*overflow = std::move(of);
@@ -225,7 +224,8 @@ static void swipe_worker(const It begin, const It end, atomic<BlockId>* const ne
 }
 
 template<typename Sv, typename It>
-static void swipe_task(const It begin, const It end, list<Hsp> *out, TargetVec *overflow, mutex* mtx, const int round, const int bin, Params* p) {
+static void swipe_task(const It begin, const It end, HspVector *out, TargetVec *overflow, mutex* mtx, const int round, const int bin, Params* p, Util::Memory::ThreadArenas* arenas) {
+	Util::Memory::ArenaScope arena_scope(arenas);
 	const ptrdiff_t CHANNELS = ::DISPATCH_ARCH::ScoreTraits<Sv>::CHANNELS;
 	Statistics stat2;
 	TargetVec of;
@@ -244,17 +244,17 @@ static void swipe_task(const It begin, const It end, list<Hsp> *out, TargetVec *
 		stat2,
 		nullptr
 	};
-	list<Hsp> hsp = dispatch_swipe<Sv, It>(begin, end, &next, of, round, bin, params);
+	HspVector hsp = dispatch_swipe<Sv, It>(begin, end, &next, of, round, bin, params);
 	{
 		std::lock_guard<mutex> lock(*mtx);
 		overflow->push_back(of);
-		out->splice(out->end(), hsp);
+		append(*out, std::move(hsp));
 	}
 	p->stat += stat2;
 }
 
 template<typename Sv, typename It>
-static list<Hsp> swipe_threads(const It begin, const It end, TargetVec &overflow, const int round, const int bin, Params& p) {
+static HspVector swipe_threads(const It begin, const It end, TargetVec &overflow, const int round, const int bin, Params& p) {
 	const ptrdiff_t CHANNELS = ::DISPATCH_ARCH::ScoreTraits<Sv>::CHANNELS;
 	if (begin == end)
 		return {};
@@ -264,16 +264,17 @@ static list<Hsp> swipe_threads(const It begin, const It end, TargetVec &overflow
 		TaskTimer timer("Banded swipe (run)", config.target_parallel_verbosity);
 		const size_t n = config.threads_align ? config.threads_align : config.threads_;
 		vector<thread> threads;
-		vector<list<Hsp>> thread_out(n);
+		vector<HspVector> thread_out(n);
 		vector<TargetVec> thread_overflow(n);
 		for (size_t i = 0; i < n; ++i)
-			threads.emplace_back(swipe_worker<Sv, It>, begin, end, &next, &thread_out[i], &thread_overflow[i], round, bin, &p);
+			threads.emplace_back(swipe_worker<Sv, It>, begin, end, &next, &thread_out[i], &thread_overflow[i], round, bin, &p, Util::Memory::ThreadArenas::current());
 		for (auto &t : threads)
 			t.join();
 		timer.go("Banded swipe (merge)");
-		list<Hsp> out;
-		for (list<Hsp> &l : thread_out)
-			out.splice(out.end(), l);
+		HspVector out;
+		out.reserve(accumulate(thread_out.begin(), thread_out.end(), (size_t)0, [](size_t n, const HspVector& v) { return n + v.size(); }));
+		for (HspVector &v : thread_out)
+			append(out, std::move(v));
 		overflow.reserve(std::accumulate(thread_overflow.begin(), thread_overflow.end(), (size_t)0, [](size_t n, const TargetVec &v) { return n + v.size(); }));
 		for (const TargetVec& v : thread_overflow)
 			overflow.push_back(v);
@@ -283,7 +284,7 @@ static list<Hsp> swipe_threads(const It begin, const It end, TargetVec &overflow
 	if(!p.thread_pool)
 		return dispatch_swipe<Sv, It>(begin, end, &next, overflow, round, bin, p);
 
-	list<Hsp> hsp;
+	HspVector hsp;
 	ThreadPool::TaskSet task_set(*p.thread_pool, 0);
 	mutex mtx;
 	int64_t size = 0;
@@ -293,7 +294,7 @@ static list<Hsp> swipe_threads(const It begin, const It end, TargetVec &overflow
 		size += accumulate(i1, i1 + n, (int64_t)0, [&p](int64_t n, const DpTarget& t) {return n + t.cells(p.flags, p.query.length()); });
 		i1 += n;
 		if (size >= config.swipe_task_size) {
-			task_set.enqueue(swipe_task<Sv, It>, i0, i1, &hsp, &overflow, &mtx, round, bin, &p);
+			task_set.enqueue(swipe_task<Sv, It>, i0, i1, &hsp, &overflow, &mtx, round, bin, &p, Util::Memory::ThreadArenas::current());
 			p.stat.inc(Statistics::SWIPE_TASKS_TOTAL);
 			p.stat.inc(Statistics::SWIPE_TASKS_ASYNC);
 			i0 = i1;
@@ -307,18 +308,18 @@ static list<Hsp> swipe_threads(const It begin, const It end, TargetVec &overflow
 	if (i1 - i0 > 0) {
 		p.stat.inc(Statistics::SWIPE_TASKS_TOTAL);
 		p.stat.inc(Statistics::SWIPE_TASKS_ASYNC);
-		task_set.enqueue(swipe_task<Sv, It>, i0, i1, &hsp, &overflow, &mtx, round, bin, &p);
+		task_set.enqueue(swipe_task<Sv, It>, i0, i1, &hsp, &overflow, &mtx, round, bin, &p, Util::Memory::ThreadArenas::current());
 	}
 	task_set.run();
 	return hsp;
 }
 
 template<typename It>
-static pair<list<Hsp>, TargetVec> swipe_bin(const unsigned bin, const It begin, const It end, const int round, Params& p) {
+static pair<HspVector, TargetVec> swipe_bin(const unsigned bin, const It begin, const It end, const int round, Params& p) {
 	if (end - begin == 0)
 		return { {},{} };
 	TargetVec overflow;
-	list<Hsp> out;
+	HspVector out;
 	auto time_stat = flag_any(p.v, HspValues::TRANSCRIPT) ? Statistics::TIME_TRACEBACK_SW : Statistics::TIME_SW;
 	if (!flag_any(p.flags, Flags::FULL_MATRIX))
 		sort(begin, end);
@@ -351,7 +352,7 @@ static pair<list<Hsp>, TargetVec> swipe_bin(const unsigned bin, const It begin,
 		throw std::runtime_error("Invalid SWIPE bin.");
 	}
 	if (!flag_any(p.flags, Flags::PARALLEL)) p.stat.inc(time_stat, timer.microseconds());
-	return { out, overflow };
+	return { std::move(out), std::move(overflow) };
 }
 
 static Loc mismatch_est(const Loc query_len, const Loc target_len, const int32_t aln_len, const HspValues v) {
@@ -361,7 +362,7 @@ static Loc mismatch_est(const Loc query_len, const Loc target_len, const int32_t
 	return aln_len > 0 ? std::min(aln_len, m) : m;
 }
 
-static list<Hsp> recompute_reversed(list<Hsp> &hsps, Params& p) {
+static HspVector recompute_reversed(HspVector &hsps, Params& p) {
 	Targets dp_targets;
 	const Loc qlen = p.query.length();
 
@@ -404,7 +405,7 @@ static list<Hsp> recompute_reversed(list<Hsp> &hsps, Params& p) {
 		p.stat,
 		p.thread_pool
 	};
-	list<Hsp> out;
+	HspVector out;
 #ifndef STRICT_BAND
 	unique_ptr<Targets> overflow_targets;
 #endif
@@ -432,21 +433,20 @@ static list<Hsp> recompute_reversed(list<Hsp> &hsps, Params& p) {
 			}
 #endif
 		}
-		out.splice(out.end(), r.first);
+		append(out, std::move(r.first));
 	}
 #ifndef STRICT_BAND
 	if(overflow_targets) {
-		list<Hsp> recompute = ::DP::BandedSwipe::swipe(*overflow_targets, p);
-		out.splice(out.end(), recompute);
+		append(out, ::DP::BandedSwipe::swipe(*overflow_targets, p));
 	}
 #endif
 	return out;
 }
 
-list<Hsp> swipe(const Targets &targets, Params& p)
+HspVector swipe(const Targets &targets, Params& p)
 {
-	pair<list<Hsp>, TargetVec> result;
-	list<Hsp> out, out_tmp;
+	pair<HspVector, TargetVec> result;
+	HspVector out, out_tmp;
 	for (int algo_bin = 0; algo_bin < ALGO_BINS; ++algo_bin) {
 		for (int score_bin = 0; score_bin < SCORE_BINS; ++score_bin) {
 			const int bin = algo_bin * SCORE_BINS + score_bin;
@@ -458,34 +458,34 @@ list<Hsp> swipe(const Targets &targets, Params& p)
 			p.swipe_bin = bin;
 			result = swipe_bin(bin, round_targets.begin(), round_targets.end(), 0, p);
 			if(algo_bin == 0)
-				out.splice(out.end(), result.first);
+				append(out, std::move(result.first));
 			else
-				out_tmp.splice(out_tmp.end(), result.first);;
+				append(out_tmp, std::move(result.first));
 		}
 		assert(result.second.empty());
 	}
 	if (!out_tmp.empty())
-		out.splice(out.end(), recompute_reversed(out_tmp, p));
+		append(out, recompute_reversed(out_tmp, p));
 	return out;
 }
 
-list<Hsp> swipe_set(const SequenceSet::ConstIterator begin, const SequenceSet::ConstIterator end, Params& p) {
+HspVector swipe_set(const SequenceSet::ConstIterator begin, const SequenceSet::ConstIterator end, Params& p) {
 	const unsigned b = bin(p.v, 0, 0, 0, 0, 0, 0);
-	pair<list<Hsp>, TargetVec> result = swipe_bin(b, begin, end, 0, p);
+	pair<HspVector, TargetVec> result = swipe_bin(b, begin, end, 0, p);
 	if (reversed(p.v))
 		result.first = recompute_reversed(result.first, p);
 	if (b < BINS - 1 && !result.second.empty()) {
 		Targets targets;
 		targets[b + 1] = std::move(result.second);
-		result.first.splice(result.first.end(), swipe(targets, p));
+		append(result.first, swipe(targets, p));
 	}
 	return result.first;
 }
 
 }
 
-DISPATCH_2(std::list<Hsp>, swipe, const Targets&, targets, Params&, params)
-DISPATCH_3(std::list<Hsp>, swipe_set, const SequenceSet::ConstIterator, begin, const SequenceSet::ConstIterator, end, Params&, params)
+DISPATCH_2(HspVector, swipe, const Targets&, targets, Params&, params)
+DISPATCH_3(HspVector, swipe_set, const SequenceSet::ConstIterator, begin, const SequenceSet::ConstIterator, end, Params&, params)
 DISPATCH_7(int, bin, HspValues, v, int, query_len, int, score, int, ungapped_score, const int64_t, dp_size, unsigned, score_width, const Loc, mismatch_est)
 
 }}
\ No newline at end of file
@@ -75,7 +75,7 @@ void window_ungapped_best(const Letter* query, const Letter** subjects, int subj
 #if defined(__SSE4_1__) | defined(__aarch64__)
 	}
 #endif
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 	//else if (subject_count <= 16)
 		//::DP::ARCH_SSE4_1::window_ungapped(query, subjects, subject_count, window, out);
 	else
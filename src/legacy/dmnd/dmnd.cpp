@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "data/fasta/fasta_file.h"
 #include "util/sequence/sequence.h"
 #include "legacy/dmnd/io.h"
+#include "data/accession_index.h"
 
 using std::tuple;
 using std::string;
@@ -268,7 +269,7 @@ void DatabaseFile::make_db()
 
     Block* block;
 	vector<SeqInfo> pos_array;
-	ExternalSorter<pair<string, OId>> accessions;
+	ExternalSorter<pair<string, OId>> accessions, seqids;
 	Util::Seq::AccessionParsing acc_stats;
 	try {
 		while (true) {
@@ -300,6 +301,9 @@ void DatabaseFile::make_db()
 						accessions.push(std::make_pair(s, total_seqs + i));
 				}
 			}
+			if (config.accession_index)
+				for (size_t i = 0; i < n; ++i)
+					seqids.push(std::make_pair(Util::Seq::seqid(block->ids()[i]), total_seqs + i));
 			timer.go("Hashing sequences");
 			for (size_t i = 0; i < n; ++i) {
 				Sequence seq = block->seqs()[i];
@@ -365,6 +369,11 @@ void DatabaseFile::make_db()
 	*out << header2;
 	out->close();
 
+	if (config.accession_index) {
+		timer.go("Building accession index");
+		AccessionIndex::write(AccessionIndex::file_name(config.database), seqids, n_seqs, letters);
+	}
+
 	timer.finish();
 	stats("Database hash", hex_print(header2.hash, 16));
 	stats("Total time", total.get(), "s");
@@ -577,8 +586,20 @@ DatabaseFile::~DatabaseFile()
 
 DbFilter* DatabaseFile::filter_by_accession(const std::string& file_name)
 {
-	throw std::runtime_error("The .dmnd database format does not support filtering by accession.");
-	return nullptr;
+	return filter_by_accession_index(file_name);
+}
+
+size_t DatabaseFile::letters_filtered(const DbFilter& v)
+{
+	size_t n = 0;
+	for (OId i = 0; i < v.oid_filter.size(); ++i)
+		if (v.oid_filter.get(i)) {
+			set_seqinfo_ptr(i);
+			init_seqinfo_access();
+			n += read_seqinfo().seq_len;
+		}
+	set_seqinfo_ptr(0);
+	return n;
 }
 
 std::string DatabaseFile::file_name()
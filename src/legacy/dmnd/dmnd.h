@@ -141,6 +141,7 @@ struct DatabaseFile : public SequenceFile
 	virtual int build_version() override;
 	virtual ~DatabaseFile();
 	virtual DbFilter* filter_by_accession(const std::string& file_name) override;
+	virtual size_t letters_filtered(const DbFilter& v) override;
 	virtual std::string file_name() override;
 	virtual std::vector<TaxId> taxids(size_t oid) const override;
 	virtual void seq_data(size_t oid, std::vector<Letter>& dst) override;
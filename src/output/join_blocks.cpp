@@ -236,14 +236,17 @@ void join_query(
 		else if (c == TargetCulling::NEXT)
 			continue;
 
+		const bool daa = f == OutputFormat::daa;
+		const Loc tlen = daa ? 0 : cfg.db->dict_len(dict_id, block_idx);
+		const char* target_title = daa ? nullptr : cfg.db->dict_title(dict_id, block_idx);
+		const Sequence target_seq = !daa && flag_any(f.flags, Output::Flags::TARGET_SEQS) ? cfg.db->dict_seq(dict_id, block_idx) : Sequence();
 		unsigned hsp_num = 0;
 		for (vector<IntermediateRecord>::const_iterator i = target_hsp.begin(); i != target_hsp.end(); ++i, ++hsp_num) {
-			if (f == OutputFormat::daa)
+			if (daa)
 				write_daa_record(out, *i);
 			/*else if (config.global_ranking_targets > 0)
 				Extension::GlobalRanking::write_merged_query_list(*i, out, ranking_db_filter, statistics);*/
 			else {
-				const Loc tlen = cfg.db->dict_len(dict_id, block_idx);
 				const unsigned frame = i->frame(query_source_len, align_mode.mode);
 
 #ifdef WITH_DNA
@@ -259,10 +262,10 @@ void join_query(
 					query_name,
 					target_oid,
 					tlen,
-					cfg.db->dict_title(dict_id, block_idx).c_str(),
+					target_title,
 					n_target_seq,
 					hsp_num,
-					flag_any(f.flags, Output::Flags::TARGET_SEQS) ? Sequence(cfg.db->dict_seq(dict_id, block_idx)) : Sequence(),
+					target_seq,
 					0,
 					query_self_aln_score,
 					target_self_aln_score).parse(cfg.output_format.get()), info);
@@ -338,8 +341,11 @@ void join_worker(const std::atomic<bool>& stop, TaskQueue<TextBuffer, JoinWriter
 void join_blocks(int64_t ref_blocks, File &master_out, const vector<File*> &tmp_file, Search::Config& cfg, SequenceFile &db_file,
 	const vector<string> tmp_file_names)
 {
-	if (*cfg.output_format != OutputFormat::daa)
+	if (*cfg.output_format != OutputFormat::daa) {
+		TaskTimer timer;
 		cfg.db->init_random_access(cfg.current_query_block, config.multiprocessing ? tmp_file_names.size() : tmp_file.size());
+		statistics.inc(Statistics::TIME_LOAD_DICT, timer.microseconds());
+	}
 	TaskTimer timer("Joining output blocks");
 
 	if (tmp_file_names.size() > 0) {
@@ -374,6 +380,7 @@ void join_blocks(int64_t ref_blocks, File &master_out, const vector<File*> &tmp_
 
 	/*if (config.global_ranking_targets)
 		Extension::GlobalRanking::extend(db_file, *merged_query_list, ranking_db_filter, cfg, master_out);*/
+	statistics.inc(Statistics::TIME_JOIN, timer.microseconds());
 	if (*cfg.output_format != OutputFormat::daa)
 		cfg.db->end_random_access();
 }
\ No newline at end of file
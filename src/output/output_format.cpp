@@ -18,6 +18,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <limits.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <cmath>
 #include <algorithm>
 #include "data/taxonomy.h"
 #include "output_format.h"
@@ -208,6 +211,8 @@ OutputFormat* get_output_format()
 #endif
 	else if (f[0] == "edge")
 		return new Output::Format::Edge;
+	else if (f[0] == "bin_edge")
+		return new Output::Format::BinaryEdge;
     else if(f[0] == "json-flat" || f[0] == "104")
         return new TabularFormat(true);
 	else
@@ -266,4 +271,22 @@ void Edge::print_match(const HspContext& r, Output::Info& info)
 	info.out.write(Data{ r.query_oid, r.subject_oid, (float)r.qcovhsp(), (float)r.scovhsp(),  r.corrected_bit_score() });
 }
 
+static uint64_t numeric_id(const string& title) {
+	const char* begin = title.c_str();
+	char* end;
+	const uint64_t id = strtoull(begin, &end, 10);
+	if (end == begin || (*end != '\0' && !isspace(*end)))
+		throw runtime_error("Binary edge output requires numeric sequence ids: " + title);
+	return id;
+}
+
+static uint16_t quantize_coverage(double cov) {
+	return (uint16_t)std::lround(std::min(std::max(cov, 0.0), 100.0) * BinaryEdge::COVERAGE_SCALE);
+}
+
+void BinaryEdge::print_match(const HspContext& r, Output::Info& info)
+{
+	info.out.write(Data{ numeric_id(r.query_title), numeric_id(r.target_title), (float)r.corrected_bit_score(), quantize_coverage(r.qcovhsp()), quantize_coverage(r.scovhsp()) });
+}
+
 }}
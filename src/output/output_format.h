@@ -145,7 +145,7 @@ struct OutputFormat
 	bool needs_taxon_id_lists, needs_taxon_nodes, needs_taxon_scientific_names, needs_taxon_ranks, needs_paired_end_info;
 	HspValues hsp_values;
 	Output::Flags flags;
-	enum { daa, blast_tab, blast_xml, sam, blast_pairwise, null, taxon, paf, bin1, EDGE, json };
+	enum { daa, blast_tab, blast_xml, sam, blast_pairwise, null, taxon, paf, bin1, EDGE, json, BINARY_EDGE };
 };
 
 struct Null_format : public OutputFormat
@@ -312,6 +312,28 @@ struct Edge : public OutputFormat
 	}
 };
 
+// Fixed size edge record of the multinode clustering workflow. Sequences are identified by the
+// numeric ids in their titles, coverage values are stored in units of 0.01%.
+struct BinaryEdge : public OutputFormat
+{
+	struct Data {
+		uint64_t query, target;
+		float weight;
+		uint16_t qcovhsp, scovhsp;
+	};
+	static constexpr double COVERAGE_SCALE = 100.0;
+	BinaryEdge() :
+		OutputFormat(BINARY_EDGE, HspValues::COORDS, Output::Flags::SSEQID)
+	{}
+	virtual void print_match(const HspContext& r, Output::Info& info) override;
+	virtual ~BinaryEdge()
+	{ }
+	virtual OutputFormat* clone() const override
+	{
+		return new BinaryEdge(*this);
+	}
+};
+
 }}
 
 OutputFormat* get_output_format();
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "search/search.h"
 #include "masking/masking.h"
 #include "align/def.h"
+#include "search/seed_array/seed_array_index.h"
 
 #ifdef WITH_DNA
 #include "../dna/extension.h"
@@ -57,6 +58,9 @@ Config::Config(std::unique_ptr<std::vector<BitVector>>& target_seed_hits) :
 	query_file(nullptr),
 	out(nullptr),
 	target_seed_hits(target_seed_hits),
+	reserved_mem(0),
+	search_threads(config.threads_),
+	align_threads(config.threads_align ? config.threads_align : config.threads_),
 	iteration_query_aligned(0)
 {
 	if (config.iterate.present()) {
@@ -121,6 +125,18 @@ Config::Config(std::unique_ptr<std::vector<BitVector>>& target_seed_hits) :
 	if (config.target_indexed && config.algo != ::Config::Algo::AUTO && config.algo != ::Config::Algo::DOUBLE_INDEXED)
 		throw runtime_error("--target-indexed requires --algo 0");
 
+	if (config.seed_array_index) {
+		if (config.algo != ::Config::Algo::AUTO && config.algo != ::Config::Algo::DOUBLE_INDEXED)
+			throw runtime_error("--seed-array-index requires --algo 0");
+		if (sensitivity.size() > 1 || config.self || config.multiprocessing || config.global_ranking_targets || config.swipe_all)
+			throw runtime_error("--seed-array-index is not compatible with iterated search, self alignment, --multiprocessing, --global-ranking or --swipe.");
+	}
+
+	if (config.pipeline) {
+		if (sensitivity.size() > 1 || config.self || config.multiprocessing || config.global_ranking_targets || config.swipe_all || config.command == ::Config::blastn)
+			throw runtime_error("--pipeline is not compatible with iterated search, self alignment, --multiprocessing, --global-ranking, --swipe or blastn.");
+	}
+
     if(config.command != ::Config::blastn) {
         const MaskingMode masking_mode = from_string<MaskingMode>(config.masking_.get("tantan"));
         switch (masking_mode) {
@@ -169,6 +185,8 @@ Config::Config(std::unique_ptr<std::vector<BitVector>>& target_seed_hits) :
 		throw runtime_error("Incompatible options: --approx-id, --id.");
 }
 
+Config::Config(const Config& cfg) = default;
+
 Config::~Config() {
 
 }
@@ -19,11 +19,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 #include <memory>
+#include <functional>
+#include <vector>
+#include "basic/value.h"
 #include "util/optional.h"
 #include "util/data_structures/bit_vector.h"
 #include "util/scores/cutoff_table.h"
 #include "util/io/file.h"
 #include "util/parallel/simple_thread_pool.h"
+#include "util/memory/copy_policy.h"
 #include "util/data_structures/bit_vector.h"
 #ifdef WITH_DNA
 #include "contrib/dna/build_score.h"
@@ -37,6 +41,7 @@ struct Block;
 struct TaxonomyNodes;
 struct ThreadPool;
 struct OutputFormat;
+struct SeedArrayIndex;
 enum class Sensitivity;
 enum class SeedEncoding;
 enum class MaskingAlgo;
@@ -50,6 +55,7 @@ template<typename T, size_t E, typename Sync> struct Deque;
 
 namespace Extension {
 	enum class Mode;
+	struct Match;
 	namespace GlobalRanking {
 	struct Hit;
 }}
@@ -63,6 +69,8 @@ namespace Dna {
 
 namespace Search {
 
+using MatchCallback = std::function<void(BlockId query, std::vector<Extension::Match>& matches, const Block& targets)>;
+
 struct Round {
 	Round(Sensitivity sens, bool lin = false):
 		sensitivity(sens),
@@ -83,12 +91,20 @@ struct Round {
 
 struct Hit;
 
+// Prepared reference blocks and seed arrays kept in memory across searches of the same database (--serve).
+struct ReferenceCache {
+	std::vector<std::shared_ptr<Block>> blocks;
+	bool                                loaded = false, lazy_masking = false;
+	std::shared_ptr<SeedArrayIndex>     seed_arrays;
+};
+
 struct Config {
 
 	using RankingTable = std::vector<Extension::GlobalRanking::Hit>;
 	using RankingBuffer = Deque<Search::Hit, 28, Async>;
 
 	Config(std::unique_ptr<std::vector<BitVector>>& target_seed_hits);
+	Config(const Config& cfg);
 	void free();
 	~Config();
 
@@ -115,7 +131,7 @@ struct Config {
 	int                                        seedp_bits;
 	unsigned                                   query_bins;
 	int64_t                                    max_target_seqs;
-	std::unique_ptr<OutputFormat>              output_format;
+	Util::Memory::ClonePtr<OutputFormat>       output_format;
 	
 	std::shared_ptr<SequenceFile>              db;
 	std::shared_ptr<SequenceFile>              query_file;
@@ -123,16 +139,21 @@ struct Config {
 	std::shared_ptr<DbFilter>                  db_filter;
 
 	std::shared_ptr<Block>                     query, target;
-	std::unique_ptr<std::vector<bool>>         query_skip;
-	std::unique_ptr<HitBuffer>                 seed_hit_buf;
-	std::unique_ptr<RankingBuffer>             global_ranking_buffer;
-	std::unique_ptr<RankingTable>              ranking_table;
+	// Buffers and thread pools of a search are not copied along with the configuration.
+	template<typename T>
+	using Owned = Util::Memory::ResetOnCopy<std::unique_ptr<T>>;
+	Owned<std::vector<bool>>                   query_skip;
+	Owned<HitBuffer>                           seed_hit_buf;
+	Owned<RankingBuffer>                       global_ranking_buffer;
+	Owned<RankingTable>                        ranking_table;
 	std::unique_ptr<std::vector<BitVector>>&   target_seed_hits;
+	std::shared_ptr<SeedArrayIndex>            seed_array_index;
+	std::shared_ptr<ReferenceCache>            ref_cache;
 	
 #ifdef WITH_DNA
-	std::unique_ptr<Stats::Blastn_Score>       score_builder;
-    std::unique_ptr<Dna::Index>                dna_ref_index;
-    std::unique_ptr<Dna::TotalTime>            timer;
+	std::shared_ptr<Stats::Blastn_Score>       score_builder;
+    Owned<Dna::Index>                          dna_ref_index;
+    std::shared_ptr<Dna::TotalTime>            timer;
     double                                     chain_pen_gap;
     double                                     chain_pen_skip;
     double                                     chain_fraction_align;
@@ -143,6 +164,10 @@ struct Config {
     int                                        current_query_block;
 	int                                        current_ref_block;
 	bool                                       blocked_processing;
+	uint64_t                                   reserved_mem;
+	// Threads of the seed search and of the alignment stage, which run concurrently with --pipeline.
+	int                                        search_threads, align_threads;
+	MatchCallback                              match_callback;
 
     optional<uint64_t> db_seqs, db_letters, ref_blocks;
 #ifdef UNGAPPED_SPOUGE
@@ -155,8 +180,8 @@ struct Config {
 
 	BlockId                                    iteration_query_aligned;
 
-	std::unique_ptr<ThreadPool>                thread_pool;
-	SimpleThreadPool                           search_pool;
+	Owned<ThreadPool>                          thread_pool;
+	Util::Memory::ResetOnCopy<SimpleThreadPool> search_pool;
 
 	bool iterated() const {
 		return sensitivity.size() > 1;
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 #include <iostream>
 #include <memory>
+#include <chrono>
 #include "data/queries.h"
 #include "basic/statistics.h"
 #include "basic/shape_config.h"
@@ -35,9 +36,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "data/seed_set.h"
 #include "align/global_ranking/global_ranking.h"
 #include "align/align.h"
+#include "stats/cbs.h"
 #include "search/hit_buffer.h"
 #include "config.h"
 #include "search/seed_array/seed_array.h"
+#include "search/seed_array/seed_array_index.h"
 #include "data/fasta/fasta_file.h"
 #include "legacy/dmnd/dmnd.h"
 #include "data/blastdb/blastdb.h"
@@ -91,6 +94,9 @@ static string get_ref_block_tmpfile_name(size_t query, size_t block) {
 }
 
 static pair<char*, char*> alloc_buffers(Config& cfg) {
+	if (cfg.seed_array_index)
+		return { (char*)Util::Memory::aligned_malloc(sizeof(ARCH_GENERIC::SeedArray<PackedLoc>::Entry) * cfg.seed_array_index->max_chunk_size(cfg.current_ref_block, cfg.index_chunks), 32),
+		ARCH_GENERIC::SeedArray<PackedLoc>::alloc_buffer(cfg.query->hst(), cfg.index_chunks) };
 	if (Search::keep_target_id(cfg))
 		return { ARCH_GENERIC::SeedArray<PackedLocId>::alloc_buffer(cfg.target->hst(), cfg.index_chunks),
 		config.target_indexed ? nullptr : ARCH_GENERIC::SeedArray<PackedLocId>::alloc_buffer(cfg.query->hst(), cfg.index_chunks) };
@@ -99,15 +105,13 @@ static pair<char*, char*> alloc_buffers(Config& cfg) {
 		config.target_indexed ? nullptr : ARCH_GENERIC::SeedArray<PackedLoc>::alloc_buffer(cfg.query->hst(), cfg.index_chunks) };
 }
 
-static void run_ref_chunk(SequenceFile &db_file,
-	const unsigned query_iteration,
-	File &master_out,
-	vector<File*> &tmp_file,
-	Config& cfg)
-{
+static bool persist_dict(const Config& cfg) {
+	return *cfg.output_format == OutputFormat::daa || cfg.iterated();
+}
+
+static void prepare_ref_chunk(Config& cfg) {
 	TaskTimer timer;
 	log_rss();
-	auto& query_seqs = cfg.query->seqs();
 
 	if ((cfg.lin_stage1_target || cfg.min_length_ratio > 0.0) && !config.kmer_ranking && cfg.target.use_count() == 1) {
 		timer.go("Length sorting reference");
@@ -131,23 +135,32 @@ static void run_ref_chunk(SequenceFile &db_file,
 		cfg.target->compute_self_aln();
 	}
 
+	if (::Stats::CBS::matrix_adjust(config.comp_based_stats) && !config.anchored_swipe) {
+		timer.go("Computing reference compositions");
+		cfg.target->compute_aa_counts();
+	}
+}
+
+static void init_ref_dict(SequenceFile& db_file, const unsigned query_iteration, Config& cfg) {
 	const bool daa = *cfg.output_format == OutputFormat::daa;
-	const bool persist_dict = daa || cfg.iterated();
 	if(((cfg.blocked_processing || daa) && !config.global_ranking_targets) || cfg.iterated()) {
-		timer.go("Initializing dictionary");
+		TaskTimer timer("Initializing dictionary");
 		if (config.multiprocessing || (cfg.current_ref_block == 0 && (!daa || cfg.current_query_block == 0) && query_iteration == 0))
 			db_file.init_dict(cfg.current_query_block, cfg.current_ref_block);
 		if(!config.global_ranking_targets)
-			db_file.init_dict_block(cfg.current_ref_block, cfg.target->seqs().size(), persist_dict);
+			db_file.init_dict_block(cfg.current_ref_block, cfg.target->seqs().size(), persist_dict(cfg));
 	}
+}
 
-	timer.go("Initializing temporary storage");
+static void search_ref_chunk(SequenceFile& db_file, const unsigned query_iteration, Config& cfg) {
+	TaskTimer timer("Initializing temporary storage");
+	auto& query_seqs = cfg.query->seqs();
 	if (config.global_ranking_targets)
 		cfg.global_ranking_buffer.reset(new Config::RankingBuffer());
 	else
 		cfg.seed_hit_buf.reset(new Search::HitBuffer(query_seqs.partition(cfg.query_bins, true, true),
 			config.tmpdir,
-			cfg.target->long_offsets(), align_mode.query_contexts, config.threads_, cfg));
+			cfg.target->long_offsets(), align_mode.query_contexts, cfg.search_threads, cfg));
 
 	if (cfg.target_seed_hits && cfg.target_seed_hits->empty()) {
 		cfg.target_seed_hits->reserve(shapes.count());
@@ -156,16 +169,22 @@ static void run_ref_chunk(SequenceFile &db_file,
 	}
 
 	if (!config.swipe_all) {
-		timer.go("Building reference histograms");
-		if (query_seeds_bitset.get()) {
+		if (cfg.seed_array_index) {
+			timer.go("Checking reference seed array index");
+			cfg.seed_array_index->check_block(cfg.current_ref_block, *cfg.target);
+		}
+		else if (query_seeds_bitset.get()) {
+			timer.go("Building reference histograms");
 			EnumCfg enum_cfg{ nullptr, 0, 0, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut, MaskingAlgo::NONE, cfg.minimizer_window, false, false, cfg.sketch_size, cfg.target_seed_hits.get() };
 			cfg.target->hst() = SeedHistogram(*cfg.target, true, query_seeds_bitset.get(), enum_cfg, cfg.seedp_bits);
 		}
 		else if (query_seeds_hashed.get()) {
+			timer.go("Building reference histograms");
 			EnumCfg enum_cfg{ nullptr, 0, 0, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut, MaskingAlgo::NONE, cfg.minimizer_window, false, false, cfg.sketch_size, cfg.target_seed_hits.get() };
 			cfg.target->hst() = SeedHistogram(*cfg.target, true, query_seeds_hashed.get(), enum_cfg, cfg.seedp_bits);
 		}
-		else {	
+		else {
+			timer.go("Building reference histograms");
 			EnumCfg enum_cfg{ nullptr, 0, 0, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut, cfg.soft_masking, cfg.minimizer_window, false, false, cfg.sketch_size, cfg.target_seed_hits.get() };
 			cfg.target->hst() = SeedHistogram(*cfg.target, false, &no_filter, enum_cfg, cfg.seedp_bits);
 		}
@@ -213,8 +232,11 @@ static void run_ref_chunk(SequenceFile &db_file,
 		timer.finish();
 		log_rss();
 	}
+}
 
-    File* out;
+static void align_ref_chunk(File& master_out, vector<File*>& tmp_file, Config& cfg) {
+	TaskTimer timer;
+	File* out;
 	const bool temp_output = (cfg.blocked_processing || cfg.iterated()) && !config.global_ranking_targets;
 	if (temp_output) {
 		timer.go("Opening temporary output file");
@@ -245,11 +267,160 @@ static void run_ref_chunk(SequenceFile &db_file,
 
 	timer.go("Deallocating reference");
 	cfg.target.reset();
-	cfg.db->close_dict_block(persist_dict);
+	cfg.db->close_dict_block(persist_dict(cfg));
 
 	timer.finish();
 }
 
+static void run_ref_chunk(SequenceFile &db_file,
+	const unsigned query_iteration,
+	File &master_out,
+	vector<File*> &tmp_file,
+	Config& cfg)
+{
+	prepare_ref_chunk(cfg);
+	init_ref_dict(db_file, query_iteration, cfg);
+	search_ref_chunk(db_file, query_iteration, cfg);
+	align_ref_chunk(master_out, tmp_file, cfg);
+}
+
+static bool use_pipeline(const SequenceFile& db_file, const Config& cfg) {
+	return config.pipeline && config.load_balancing == ::Config::query_parallel && !config.swipe_all
+		&& !flag_any(db_file.format_flags(), SequenceFile::FormatFlags::TITLES_LAZY) && !cfg.target_seed_hits;
+}
+
+static bool use_prefetch(const SequenceFile& db_file, const Config& cfg) {
+	return config.prefetch && cfg.blocked_processing && !config.self && !config.global_ranking_targets
+		&& !flag_any(db_file.format_flags(), SequenceFile::FormatFlags::TITLES_LAZY);
+}
+
+static void run_ref_chunks_pipelined(SequenceFile& db_file,
+	const unsigned query_iteration,
+	File& master_out,
+	vector<File*>& tmp_file,
+	Config& options)
+{
+	TaskTimer timer("Copying query block");
+	Config pipeline_cfg(options);
+	pipeline_cfg.query.reset(new Block(*options.query));
+	if (options.query_skip)
+		pipeline_cfg.query_skip.reset(new vector<bool>(*options.query_skip));
+	pipeline_cfg.iteration_query_aligned = 0;
+	timer.finish();
+	Config* cfg[] = { &options, &pipeline_cfg };
+	const int search_threads = options.search_threads, align_threads = options.align_threads;
+	const size_t entry_size = keep_target_id(options) ? sizeof(ARCH_GENERIC::SeedArray<PackedLocId>::Entry) : sizeof(ARCH_GENERIC::SeedArray<PackedLoc>::Entry);
+	SimpleThreadPool align_pool;
+	bool aligning = false;
+	int block = 0;
+	for (; ; ++block) {
+		Config& c = *cfg[block % 2];
+		timer.go("Loading reference sequences");
+		c.target.reset(db_file.load_seqs(config.block_size(), 0, &options.db_filter->oid_filter));
+		const auto t = timer.microseconds();
+		timer.finish();
+		c.target->load_stats(*message_stream, t);
+		c.current_ref_block = block;
+		if (block == 0) {
+			options.blocked_processing = pipeline_cfg.blocked_processing = !options.db->eof();
+			if (options.blocked_processing) {
+				// The search of the next block runs concurrently with the alignment of the current one.
+				const int a = std::max(int(config.threads_align ? config.threads_align : config.threads_ / 2), 1);
+				for (Config* p : cfg) {
+					p->align_threads = a;
+					p->search_threads = std::max((int)config.threads_ - a, 1);
+				}
+			}
+		}
+		if (c.target->empty())
+			break;
+		if (!c.blocked_processing) {
+			run_ref_chunk(db_file, query_iteration, master_out, tmp_file, c);
+			continue;
+		}
+		prepare_ref_chunk(c);
+		search_ref_chunk(db_file, query_iteration, c);
+		if (aligning)
+			align_pool.join_all();
+		// Memory of the search of the next block, estimated from the current one.
+		c.reserved_mem = cfg[(block + 1) % 2]->query->mem_size() + c.target->mem_size() + (config.target_indexed ? 0
+			: seed_array_memory(options.query->hst(), options.query->seqs().letters(), c.target->seqs().letters(), options.index_chunks, options.seedp_bits, entry_size));
+		align_pool.spawn([&db_file, query_iteration, &master_out, &tmp_file, &c](const atomic<bool>&) {
+			init_ref_dict(db_file, query_iteration, c);
+			align_ref_chunk(master_out, tmp_file, c);
+		});
+		aligning = true;
+	}
+	if (aligning)
+		align_pool.join_all();
+	options.target.reset();
+	options.current_ref_block = block;
+	options.iteration_query_aligned += pipeline_cfg.iteration_query_aligned;
+	options.search_threads = search_threads;
+	options.align_threads = align_threads;
+}
+
+static void load_ref_cache(SequenceFile& db_file, Config& cfg) {
+	ReferenceCache& cache = *cfg.ref_cache;
+	TaskTimer timer;
+	cache.blocks.clear();
+	cache.seed_arrays.reset();
+	for (cfg.current_ref_block = 0; ; ++cfg.current_ref_block) {
+		timer.go("Loading reference sequences");
+		cfg.target.reset(db_file.load_seqs(config.block_size(), 0, &cfg.db_filter->oid_filter));
+		const auto t = timer.microseconds();
+		timer.finish();
+		if (cfg.target->empty())
+			break;
+		cfg.target->load_stats(*message_stream, t);
+		prepare_ref_chunk(cfg);
+		cache.blocks.push_back(cfg.target);
+	}
+	cfg.target.reset();
+	cache.loaded = true;
+	cache.lazy_masking = cfg.lazy_masking;
+	*message_stream << "Keeping " << cache.blocks.size() << " reference blocks in memory." << endl;
+}
+
+static bool cache_seed_arrays(const Config& cfg) {
+	return config.algo == ::Config::Algo::DOUBLE_INDEXED && !cfg.seed_array_index && !config.target_indexed && !config.swipe_all
+		&& !keep_target_id(cfg) && !cfg.lin_stage1_target && !cfg.minimizer_window && !cfg.sketch_size && !cfg.target_seed_hits;
+}
+
+// Searches the reference blocks kept in cfg.ref_cache, loading them on first use. In double-indexed mode,
+// the reference seed arrays are built once per block and kept as well.
+static void run_ref_chunks_cached(SequenceFile& db_file,
+	const unsigned query_iteration,
+	File& master_out,
+	vector<File*>& tmp_file,
+	Config& options)
+{
+	ReferenceCache& cache = *options.ref_cache;
+	if (!cache.loaded || cache.lazy_masking != options.lazy_masking)
+		load_ref_cache(db_file, options);
+	const bool seed_arrays = cache_seed_arrays(options);
+	if (seed_arrays && cache.seed_arrays && !cache.seed_arrays->matches(options))
+		cache.seed_arrays.reset();
+	if (seed_arrays && !cache.seed_arrays)
+		cache.seed_arrays.reset(new SeedArrayIndex(options));
+	options.blocked_processing = config.global_ranking_targets || cache.blocks.size() > 1;
+	for (options.current_ref_block = 0; options.current_ref_block < (int)cache.blocks.size(); ++options.current_ref_block) {
+		options.target = cache.blocks[options.current_ref_block];
+		if (seed_arrays) {
+			if (options.current_ref_block == cache.seed_arrays->block_count()) {
+				TaskTimer timer("Building reference seed arrays");
+				cache.seed_arrays->add_block(*options.target, options);
+			}
+			options.seed_array_index = cache.seed_arrays;
+		}
+		init_ref_dict(db_file, query_iteration, options);
+		search_ref_chunk(db_file, query_iteration, options);
+		align_ref_chunk(master_out, tmp_file, options);
+	}
+	if (seed_arrays)
+		options.seed_array_index.reset();
+}
+
 static void run_query_iteration(const unsigned query_iteration,
 	File& master_out,
 	OutputFile* unaligned_file,
@@ -269,6 +440,7 @@ static void run_query_iteration(const unsigned query_iteration,
 			|| query_seqs.letters() > MAX_INDEX_QUERY_SIZE
 			|| (options.db_letters ? options.db_letters.value() : db_file.disk_size()) < MIN_QUERY_INDEXED_DB_SIZE
 			|| config.target_indexed
+			|| config.seed_array_index
 			|| config.swipe_all
 			|| options.minimizer_window
 			|| options.sketch_size))
@@ -296,6 +468,21 @@ static void run_query_iteration(const unsigned query_iteration,
 	const Sensitivity sens = options.sensitivity[query_iteration].sensitivity;
 	::Config::set_option(options.index_chunks, config.lowmem_, 0u, config.algo == ::Config::Algo::DOUBLE_INDEXED ? sensitivity_traits.at(sens).index_chunks : 1u);
 	options.seedp_bits = Search::seedp_bits(shapes[0].weight_, config.threads_, options.index_chunks);
+	if (config.seed_array_index) {
+		if (!options.seed_array_index) {
+			if (db_file.type() != SequenceFile::Type::DMND)
+				throw runtime_error("--seed-array-index requires a DIAMOND database.");
+			if (options.db_filter)
+				throw runtime_error("--seed-array-index is not compatible with database filtering.");
+			timer.go("Loading seed array index");
+			options.seed_array_index.reset(new SeedArrayIndex(SeedArrayIndex::file_name(db_file.file_name())));
+			timer.finish();
+		}
+		if (keep_target_id(options) || options.lin_stage1_target || options.minimizer_window || options.sketch_size || options.target_seed_hits)
+			throw runtime_error("--seed-array-index is not supported for this search mode.");
+		options.seed_array_index->check_config(options);
+		options.seedp_bits = options.seed_array_index->seedp_bits();
+	}
 	*log_stream << "Seed partition bits = " << options.seedp_bits << endl;
 	options.lazy_masking = config.algo != ::Config::Algo::DOUBLE_INDEXED && options.target_masking != MaskingAlgo::NONE && config.frame_shift == 0;
 	if (config.command != ::Config::blastn && options.gapped_filter_evalue != 0.0) {
@@ -328,6 +515,23 @@ static void run_query_iteration(const unsigned query_iteration,
 		options.soft_masking, options.minimizer_window, static_cast<bool>(query_seeds_hashed.get()), false, options.sketch_size, config.self ? options.target_seed_hits.get() : nullptr };
 		options.query->hst() = SeedHistogram(*options.query, false, &no_filter, enum_cfg, options.seedp_bits);
 		timer.finish();
+		if (config.fit_memory && config.lowmem_ == 0 && config.algo == ::Config::Algo::DOUBLE_INDEXED && !config.seed_array_index && !config.self) {
+			const int64_t memory_limit = Util::String::interpret_number(config.memory_limit.get(DEFAULT_MEMORY_LIMIT)),
+				target_letters = std::min(config.block_size(), options.db_letters ? (int64_t)options.db_letters.value() : config.block_size());
+			const size_t entry_size = keep_target_id(options) ? sizeof(ARCH_GENERIC::SeedArray<PackedLocId>::Entry) : sizeof(ARCH_GENERIC::SeedArray<PackedLoc>::Entry);
+			const IndexFit fit = fit_index_chunks(options.query->hst(), query_seqs.letters(), target_letters, memory_limit, entry_size);
+			*message_stream << "Fitting to memory limit: index chunks = " << fit.index_chunks << ", seed partition bits = " << fit.seedp_bits
+				<< ", predicted memory use = " << convert_size(fit.predicted_memory) << endl;
+			if (fit.predicted_memory > memory_limit)
+				*message_stream << "Warning: the predicted memory use exceeds the memory limit. Consider using a smaller block size (-b)." << endl;
+			options.index_chunks = fit.index_chunks;
+			if (fit.seedp_bits != options.seedp_bits) {
+				timer.go("Rebuilding query histograms");
+				options.seedp_bits = fit.seedp_bits;
+				options.query->hst() = SeedHistogram(*options.query, false, &no_filter, enum_cfg, options.seedp_bits);
+				timer.finish();
+			}
+		}
 	}
 
 	log_rss();
@@ -404,29 +608,58 @@ static void run_query_iteration(const unsigned query_iteration,
 		if (!lin_self_first_query_block)
 			db_file.set_seqinfo_ptr((config.self && !config.lin_stage1_query) ? options.query->oid_end() : 0);
 		timer.finish();
-		for (options.current_ref_block = 0; ; ++options.current_ref_block) {
-			if (config.self && ((config.lin_stage1_query && options.current_ref_block == options.current_query_block) || (!config.lin_stage1_query && options.current_ref_block == 0))) {
-				options.target = options.query;
-				if (config.lin_stage1_query) {
-					timer.go("Seeking in database");
-					db_file.set_seqinfo_ptr(options.query->oid_end());
+		if (options.ref_cache && !config.self)
+			run_ref_chunks_cached(db_file, query_iteration, master_out, tmp_file, options);
+		else if (use_pipeline(db_file, options))
+			run_ref_chunks_pipelined(db_file, query_iteration, master_out, tmp_file, options);
+		else {
+			SimpleThreadPool load_pool;
+			unique_ptr<Block> next_block;
+			int64_t next_block_time = 0;
+			bool prefetching = false;
+			for (options.current_ref_block = 0; ; ++options.current_ref_block) {
+				if (config.self && ((config.lin_stage1_query && options.current_ref_block == options.current_query_block) || (!config.lin_stage1_query && options.current_ref_block == 0))) {
+					options.target = options.query;
+					if (config.lin_stage1_query) {
+						timer.go("Seeking in database");
+						db_file.set_seqinfo_ptr(options.query->oid_end());
+						timer.finish();
+					}
+				}
+				else if (prefetching) {
+					timer.go("Waiting for prefetched reference sequences");
+					load_pool.join_all();
+					prefetching = false;
+					options.target.reset(next_block.release());
 					timer.finish();
+					options.target->load_stats(*message_stream, (double)next_block_time);
 				}
-			}
-			else {
-				timer.go("Loading reference sequences");
-				options.target.reset(db_file.load_seqs(config.block_size(), 0, &options.db_filter->oid_filter));
-				const auto t = timer.microseconds();
+				else {
+					timer.go("Loading reference sequences");
+					options.target.reset(db_file.load_seqs(config.block_size(), 0, &options.db_filter->oid_filter));
+					const auto t = timer.microseconds();
+					timer.finish();
+					options.target->load_stats(*message_stream, t);
+				}
+				if (options.current_ref_block == 0) {
+					//const int64_t db_seq_count = options.db_filter ? options.db_filter->oid_filter.one_count() : options.db->sequence_count();
+					options.blocked_processing = config.global_ranking_targets || !options.db->eof(); // options.target->seqs().size() < db_seq_count;
+				}
+				if (options.target->empty()) break;
 				timer.finish();
-				options.target->load_stats(*message_stream, t);
-			}
-			if (options.current_ref_block == 0) {
-				//const int64_t db_seq_count = options.db_filter ? options.db_filter->oid_filter.one_count() : options.db->sequence_count();
-				options.blocked_processing = config.global_ranking_targets || !options.db->eof(); // options.target->seqs().size() < db_seq_count;
+				options.reserved_mem = 0;
+				if (use_prefetch(db_file, options)) {
+					options.reserved_mem = options.target->mem_size();
+					load_pool.spawn([&db_file, &options, &next_block, &next_block_time](const atomic<bool>&) {
+						const auto t = std::chrono::high_resolution_clock::now();
+						next_block.reset(db_file.load_seqs(config.block_size(), 0, &options.db_filter->oid_filter));
+						next_block_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t).count();
+					});
+					prefetching = true;
+				}
+				run_ref_chunk(db_file, query_iteration, master_out, tmp_file, options);
 			}
-			if (options.target->empty()) break;
-			timer.finish();
-			run_ref_chunk(db_file, query_iteration, master_out, tmp_file, options);
+			options.reserved_mem = 0;
 		}
 		log_rss();
 	}
@@ -780,100 +1013,59 @@ static void master_thread(TaskTimer &total_timer, Config &options)
 	//print_warnings();
 }
 
-void run(unique_ptr<vector<BitVector>>& target_seed_hits, const shared_ptr<SequenceFile>& db, const shared_ptr<SequenceFile>& query, const shared_ptr<File>& out, const shared_ptr<DbFilter>& db_filter)
-{
-	TaskTimer total;
-
-	align_mode = AlignMode(AlignMode::from_command(config.command));
-	(align_mode.sequence_type == SequenceType::amino_acid) ? value_traits = amino_acid_traits : value_traits = nucleotide_traits;
-
-	*message_stream << "Temporary directory: " << TempFile::get_temp_dir() << endl;
-
-	if (config.sensitivity >= Sensitivity::VERY_SENSITIVE)
-		::Config::set_option(config.chunk_size, 0.4);
-	else
-		::Config::set_option(config.chunk_size, 2.0);
-
-	Config cfg(target_seed_hits);
-	statistics.reset();
-
+SequenceFile::Flags database_flags(const OutputFormat& format) {
 	const bool taxon_filter = !config.taxonlist.empty() || !config.taxon_exclude.empty();
 	const bool taxon_culling = config.taxon_k != 0;
 	SequenceFile::Flags flags = SequenceFile::Flags::NONE;
 	if (config.db_size == 0)
 		flags |= SequenceFile::Flags::NEED_LETTER_COUNT;
-	if (cfg.output_format->needs_taxon_id_lists || taxon_filter || taxon_culling)
+	if (format.needs_taxon_id_lists || taxon_filter || taxon_culling)
 		flags |= SequenceFile::Flags::TAXON_MAPPING;
-	if (cfg.output_format->needs_taxon_nodes || taxon_filter || taxon_culling)
+	if (format.needs_taxon_nodes || taxon_filter || taxon_culling)
 		flags |= SequenceFile::Flags::TAXON_NODES;
-	if (cfg.output_format->needs_taxon_scientific_names)
+	if (format.needs_taxon_scientific_names)
 		flags |= SequenceFile::Flags::TAXON_SCIENTIFIC_NAMES;
-	if (cfg.output_format->needs_taxon_ranks || taxon_culling)
+	if (format.needs_taxon_ranks || taxon_culling)
 		flags |= SequenceFile::Flags::TAXON_RANKS;
 
-	if (flag_any(cfg.output_format->flags, Output::Flags::ALL_SEQIDS))
+	if (flag_any(format.flags, Output::Flags::ALL_SEQIDS))
 		flags |= SequenceFile::Flags::ALL_SEQIDS;
-	if (flag_any(cfg.output_format->flags, Output::Flags::FULL_TITLES) || config.no_self_hits)
+	if (flag_any(format.flags, Output::Flags::FULL_TITLES) || config.no_self_hits)
 		flags |= SequenceFile::Flags::FULL_TITLES;
-	if (flag_any(cfg.output_format->flags, Output::Flags::TARGET_SEQS))
+	if (flag_any(format.flags, Output::Flags::TARGET_SEQS))
 		flags |= SequenceFile::Flags::TARGET_SEQS;
-	if (flag_any(cfg.output_format->flags, Output::Flags::SELF_ALN_SCORES))
+	if (flag_any(format.flags, Output::Flags::SELF_ALN_SCORES))
 		flags |= SequenceFile::Flags::SELF_ALN_SCORES;
 	if (taxon_filter)
 		flags |= SequenceFile::Flags::NEED_EARLY_TAXON_MAPPING | SequenceFile::Flags::NEED_LENGTH_LOOKUP;
 	if (!config.seqidlist.empty())
 		flags |= SequenceFile::Flags::NEED_LENGTH_LOOKUP;
+	return flags;
+}
 
+shared_ptr<DbFilter> build_db_filter(SequenceFile& db) {
 	TaskTimer timer;
-
-	if (db) {
-		cfg.db = db;
-		if (!query && config.query_file.empty())
-			cfg.self = true;
-	}
-	else {
-		timer.go("Opening the database");
-		try {
-			cfg.db.reset(SequenceFile::auto_create({ config.database }, flags, value_traits));
-		}
-		catch (FormatDetectionError& e) {
-			throw runtime_error("Error opening database file: " + string(e.what()));
-		}
-		timer.finish();
-		if (!cfg.db->open_stats().empty())
-			*message_stream << cfg.db->open_stats();
-	}
-	if (config.multiprocessing && cfg.db->type() == SequenceFile::Type::FASTA)
-		throw runtime_error("Multiprocessing mode is not compatible with FASTA databases.");
+	shared_ptr<DbFilter> filter;
+	const bool taxon_filter = !config.taxonlist.empty() || !config.taxon_exclude.empty();
 	const Pal* pal = nullptr;
-	if (cfg.db->type() == SequenceFile::Type::BLAST)
-		pal = &dynamic_cast<BlastDB*>(cfg.db.get())->pal();
-	cfg.db_seqs = cfg.db->sequence_count();
-	cfg.db_letters = cfg.db->letters();
-	cfg.ref_blocks = cfg.db->total_blocks();
-	cfg.query_file = query;
-	cfg.db_filter = db_filter;
-	cfg.out = out;
-	timer.finish();
-
-	cfg.db->print_info();
-	*message_stream << "Block size = " << (size_t)(config.chunk_size * 1e9) << endl;	
+	if (db.type() == SequenceFile::Type::BLAST)
+		pal = &dynamic_cast<BlastDB&>(db).pal();
 	const bool alias_taxfilter = pal && pal->metadata.find("TAXIDLIST") != pal->metadata.end();
 
 	if (taxon_filter) {
 		if (!config.taxonlist.empty() && !config.taxon_exclude.empty())
 			throw runtime_error("Options --taxonlist and --taxon-exclude are mutually exclusive.");
 		timer.go("Building taxonomy filter");
-		std::istringstream filter(config.taxonlist.empty() ? config.taxon_exclude : config.taxonlist);
-		cfg.db_filter.reset(cfg.db->filter_by_taxonomy(filter, ',', !config.taxon_exclude.empty()));
+		std::istringstream taxa(config.taxonlist.empty() ? config.taxon_exclude : config.taxonlist);
+		filter.reset(db.filter_by_taxonomy(taxa, ',', !config.taxon_exclude.empty()));
 		timer.finish();
 	}
 	else if (alias_taxfilter) {
 		timer.go("Building taxonomy filter");
-		std::ifstream filter(pal->metadata.at("TAXIDLIST"));
-		if (!filter)
+		std::ifstream taxa(pal->metadata.at("TAXIDLIST"));
+		if (!taxa)
 			throw runtime_error("Cannot open TAXIDLIST file: " + pal->metadata.at("TAXIDLIST"));
-		cfg.db_filter.reset(cfg.db->filter_by_taxonomy(filter, '\n', false));
+		filter.reset(db.filter_by_taxonomy(taxa, '\n', false));
 		timer.finish();
 	}
 
@@ -891,10 +1083,73 @@ void run(unique_ptr<vector<BitVector>>& target_seed_hits, const shared_ptr<Seque
 			throw runtime_error("--seqidlist is not compatible with taxonomy filtering.");
 		*message_stream << "Filtering database by accession list: " << seqidlist << endl;
 		timer.go("Building database filter");
-		cfg.db_filter.reset(cfg.db->filter_by_accession(seqidlist));
+		filter.reset(db.filter_by_accession(seqidlist));
 		timer.finish();
 	}
 
+	return filter;
+}
+
+void run(unique_ptr<vector<BitVector>>& target_seed_hits, const shared_ptr<SequenceFile>& db, const shared_ptr<SequenceFile>& query, const shared_ptr<File>& out, const shared_ptr<DbFilter>& db_filter, const MatchCallback& match_callback, const shared_ptr<ReferenceCache>& ref_cache)
+{
+	TaskTimer total;
+
+	align_mode = AlignMode(AlignMode::from_command(config.command));
+	(align_mode.sequence_type == SequenceType::amino_acid) ? value_traits = amino_acid_traits : value_traits = nucleotide_traits;
+
+	*message_stream << "Temporary directory: " << TempFile::get_temp_dir() << endl;
+
+	const bool fit_block_size = config.fit_memory && config.chunk_size == 0.0;
+	if (config.sensitivity >= Sensitivity::VERY_SENSITIVE)
+		::Config::set_option(config.chunk_size, 0.4);
+	else
+		::Config::set_option(config.chunk_size, 2.0);
+
+	Config cfg(target_seed_hits);
+	statistics.reset();
+
+	const SequenceFile::Flags flags = database_flags(*cfg.output_format);
+
+	TaskTimer timer;
+
+	if (db) {
+		cfg.db = db;
+		if (!query && config.query_file.empty())
+			cfg.self = true;
+	}
+	else {
+		timer.go("Opening the database");
+		try {
+			cfg.db.reset(SequenceFile::auto_create({ config.database }, flags, value_traits));
+		}
+		catch (FormatDetectionError& e) {
+			throw runtime_error("Error opening database file: " + string(e.what()));
+		}
+		timer.finish();
+		if (!cfg.db->open_stats().empty())
+			*message_stream << cfg.db->open_stats();
+	}
+	if (config.multiprocessing && cfg.db->type() == SequenceFile::Type::FASTA)
+		throw runtime_error("Multiprocessing mode is not compatible with FASTA databases.");
+	cfg.db_seqs = cfg.db->sequence_count();
+	cfg.db_letters = cfg.db->letters();
+	if (fit_block_size && cfg.db_letters) {
+		const int64_t memory_limit = Util::String::interpret_number(config.memory_limit.get(DEFAULT_MEMORY_LIMIT));
+		config.chunk_size = Search::fit_block_size(memory_limit, (int64_t)cfg.db_letters.value());
+		*message_stream << "Fitting to memory limit: block size = " << config.chunk_size << " for memory limit " << convert_size(memory_limit) << endl;
+	}
+	cfg.ref_blocks = cfg.db->total_blocks();
+	cfg.query_file = query;
+	cfg.db_filter = db_filter;
+	cfg.out = out;
+	cfg.match_callback = match_callback;
+	cfg.ref_cache = ref_cache;
+	timer.finish();
+
+	cfg.db->print_info();
+	*message_stream << "Block size = " << (size_t)(config.chunk_size * 1e9) << endl;	
+	if (!cfg.db_filter)
+		cfg.db_filter = build_db_filter(*cfg.db);
 	if (cfg.db_filter)
 		*message_stream << "Filtered database contains " << cfg.db_filter->oid_filter.one_count() << " sequences, " << cfg.db_filter->letter_count << " letters." << endl;
 	score_matrix.set_db_letters(config.db_size ? config.db_size : (cfg.db_filter && cfg.db_filter->letter_count ? cfg.db_filter->letter_count : cfg.db->letters().value()));
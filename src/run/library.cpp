@@ -0,0 +1,125 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <mutex>
+#include <algorithm>
+#include <iterator>
+#include "basic/config.h"
+#include "basic/value.h"
+#include "align/extend.h"
+#include "data/block/block_wrapper.h"
+#include "masking/masking.h"
+#include "output/output_format.h"
+#include "util/command_line_parser.h"
+#include "util/sequence/sequence.h"
+#include "workflow.h"
+#include "library.h"
+
+using std::lock_guard;
+using std::mutex;
+using std::pair;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace Diamond {
+
+static mutex mtx;
+
+void init(const vector<string>& args) {
+	lock_guard<mutex> lock(mtx);
+	vector<const char*> argv{ "diamond" };
+	for (const string& s : args)
+		argv.push_back(s.c_str());
+	init_motif_table();
+	CommandLineParser parser;
+	config = ::Config((int)argv.size(), argv.data(), false, parser);
+	align_mode = AlignMode(AlignMode::from_command(config.command));
+	value_traits = align_mode.sequence_type == SequenceType::amino_acid ? amino_acid_traits : nucleotide_traits;
+}
+
+Database::Database(const string& file_name) {
+	lock_guard<mutex> lock(mtx);
+	int64_t max_target_seqs;
+	const unique_ptr<OutputFormat> format(init_output(max_target_seqs));
+	file.reset(SequenceFile::auto_create({ file_name }, Search::database_flags(*format), value_traits));
+}
+
+Database::~Database() {
+}
+
+vector<Hit> search(Database& db, const Block& queries) {
+	if (config.command != ::Config::blastp)
+		throw runtime_error("The library interface only supports the blastp command.");
+	lock_guard<mutex> lock(mtx);
+	vector<Hit> hits;
+	mutex hits_mtx;
+	auto callback = [&hits, &hits_mtx](BlockId query, vector<Extension::Match>& matches, const Block& targets) {
+		// The matches live in the arenas of the alignment task; copy the HSPs to the heap.
+		Util::Memory::ArenaScope heap(nullptr);
+		vector<Hit> v;
+		v.reserve(matches.size());
+		for (Extension::Match& m : matches) {
+			v.push_back({ query,
+				targets.block_id2oid(m.target_block_id),
+				targets.has_ids() ? string(targets.ids()[m.target_block_id]) : string(),
+				m.seq.length(),
+				m.filter_score,
+				m.filter_evalue,
+				vector<Hsp>(m.hsp.begin(), m.hsp.end()) });
+			for (Hsp& h : v.back().hsp) {
+				h.target_seq = Sequence();
+				h.matrix = nullptr;
+			}
+		}
+		lock_guard<mutex> lock(hits_mtx);
+		hits.insert(hits.end(), std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+	};
+	const shared_ptr<SequenceFile> query_file(new BlockWrapper(queries, SequenceFile::Flags::SEQS | SequenceFile::Flags::TITLES, input_value_traits));
+	const shared_ptr<File> out(new File(Temporary()));
+	unique_ptr<vector<BitVector>> target_seed_hits;
+	const ::Config::Algo algo = config.algo;
+	try {
+		Search::run(target_seed_hits, db.file, query_file, out, nullptr, callback);
+	}
+	catch (...) {
+		config.algo = algo;
+		throw;
+	}
+	config.algo = algo;
+	std::stable_sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+		return a.query < b.query || (a.query == b.query && (a.filter_evalue < b.filter_evalue || (a.filter_evalue == b.filter_evalue && a.target_oid < b.target_oid)));
+		});
+	return hits;
+}
+
+vector<Hit> search(Database& db, const vector<pair<string, string>>& queries) {
+	Block block;
+	vector<Letter> seq;
+	for (size_t i = 0; i < queries.size(); ++i) {
+		Util::Seq::from_string(queries[i].second, seq, input_value_traits, (int64_t)i + 1);
+		block.push_back(Sequence(seq), queries[i].first.c_str(), nullptr, (OId)i, input_value_traits.seq_type, frame_mask());
+	}
+	block.finish_reserve();
+	return search(db, block);
+}
+
+}
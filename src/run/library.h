@@ -0,0 +1,56 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "basic/match.h"
+#include "data/block/block.h"
+
+struct SequenceFile;
+
+// Entry points for using the aligner as a library (libdiamond) without going
+// through main() and the output formats. The search options are still held
+// in the global configuration, so calls into this interface are serialized.
+namespace Diamond {
+
+struct Hit {
+	BlockId query;
+	OId target_oid;
+	std::string target_title;
+	Loc target_len;
+	int filter_score;
+	double filter_evalue;
+	std::vector<Hsp> hsp;
+};
+
+struct Database {
+	Database(const std::string& file_name);
+	~Database();
+	std::shared_ptr<SequenceFile> file;
+};
+
+// Parses the options as for the command line, e.g. { "blastp", "--sensitive", "-k", "10" }.
+void init(const std::vector<std::string>& args);
+std::vector<Hit> search(Database& db, const Block& queries);
+std::vector<Hit> search(Database& db, const std::vector<std::pair<std::string, std::string>>& queries);
+
+}
@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/log_stream.h"
 #include "util/system/system.h"
 #include "tools/tools.h"
+#include "util/parallel/coordinator.h"
 
 using std::cout;
 using std::cerr;
@@ -93,7 +94,12 @@ int main(int ac, const char* av[])
 			break;
 		case Config::blastp:
 		case Config::blastx:
-			Search::run(target_seed_hits);
+			if (config.serve.empty())
+				Search::run(target_seed_hits);
+			else if (config.serve_query)
+				Search::serve_query();
+			else
+				Search::serve(target_seed_hits);
 			break;
 		case Config::view:
 			if (!config.daa_file.empty())
@@ -194,9 +200,22 @@ int main(int ac, const char* av[])
 		case Config::MERGE_DAA:
 			merge_daa();
 			break;
+		case Config::COORDINATOR:
+			if (config.coordinator.empty())
+				throw std::runtime_error("Option missing: coordinator address (--coordinator)");
+			if (config.coordinator_shutdown)
+				Coordinator(config.coordinator, Coordinator::token(config.coordinator_token)).shutdown();
+			else
+				run_coordinator(config.coordinator, Coordinator::token(config.coordinator_token));
+			break;
 #ifdef EXTRA
         case Config::blastn:
-            Search::run(target_seed_hits);
+            if (config.serve.empty())
+                Search::run(target_seed_hits);
+            else if (config.serve_query)
+                Search::serve_query();
+            else
+                Search::serve(target_seed_hits);
             break;
 #ifdef WITH_FAMSA
 		case Config::PROFILE_RECLUSTER:
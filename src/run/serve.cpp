@@ -0,0 +1,160 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <fstream>
+#include <iostream>
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+#include "basic/config.h"
+#include "basic/value.h"
+#include "basic/statistics.h"
+#include "output/output_format.h"
+#include "util/io/unix_socket.h"
+#include "util/io/temp_file.h"
+#include "util/parallel/multiprocessing.h"
+#include "util/system/system.h"
+#include "util/log_stream.h"
+#include "workflow.h"
+
+using std::endl;
+using std::string;
+using std::shared_ptr;
+using std::unique_ptr;
+using std::vector;
+using std::runtime_error;
+
+namespace Search {
+
+static const int ACCEPT_POLL_MS = 500;
+
+static void process_batch(UnixSocket& conn, const string& query_file, const string& output_file, unique_ptr<vector<BitVector>>& target_seed_hits, const shared_ptr<SequenceFile>& db,
+	const shared_ptr<DbFilter>& db_filter, const shared_ptr<ReferenceCache>& ref_cache)
+{
+	string buf;
+	conn.read_all(buf);
+	{
+		std::ofstream f(query_file, std::ios::binary);
+		f.write(buf.data(), buf.size());
+		if (!f)
+			throw runtime_error("Error writing file " + query_file);
+	}
+	buf.clear();
+	buf.shrink_to_fit();
+
+	const ::Config::Algo algo = config.algo;
+	const Sensitivity sensitivity = config.sensitivity;
+	config.query_file = { query_file };
+	config.output_file = output_file;
+	try {
+		run(target_seed_hits, db, nullptr, nullptr, db_filter, nullptr, ref_cache);
+	}
+	catch (...) {
+		config.algo = algo;
+		config.sensitivity = sensitivity;
+		throw;
+	}
+	config.algo = algo;
+	config.sensitivity = sensitivity;
+
+	std::ifstream f(output_file, std::ios::binary);
+	char chunk[65536];
+	while (f.read(chunk, sizeof(chunk)) || f.gcount() > 0)
+		conn.write(chunk, (size_t)f.gcount());
+}
+
+void serve(unique_ptr<vector<BitVector>>& target_seed_hits) {
+	if (config.database.empty())
+		throw runtime_error("Missing parameter: database file (--db/-d)");
+	if (config.multiprocessing)
+		throw runtime_error("--serve is not compatible with --multiprocessing.");
+	align_mode = AlignMode(AlignMode::from_command(config.command));
+	value_traits = align_mode.sequence_type == SequenceType::amino_acid ? amino_acid_traits : nucleotide_traits;
+
+	TaskTimer timer("Opening the database");
+	int64_t max_target_seqs;
+	const unique_ptr<OutputFormat> format(init_output(max_target_seqs));
+	shared_ptr<SequenceFile> db(SequenceFile::auto_create({ config.database }, database_flags(*format), value_traits));
+	timer.finish();
+	if (!db->open_stats().empty())
+		*message_stream << db->open_stats();
+	const shared_ptr<DbFilter> db_filter = build_db_filter(*db);
+	if (db_filter)
+		*message_stream << "Filtered database contains " << db_filter->oid_filter.one_count() << " sequences, " << db_filter->letter_count << " letters." << endl;
+	const shared_ptr<ReferenceCache> ref_cache(new ReferenceCache());
+
+	const string spool = join_path(TempFile::get_temp_dir(), "diamond-serve-" + std::to_string(getpid()));
+	UnixSocket socket = UnixSocket::listen(config.serve);
+	*message_stream << "Listening on " << config.serve << endl;
+
+	for (int64_t batch = 0; !file_exists("stop"); ) {
+		if (!socket.wait_readable(ACCEPT_POLL_MS))
+			continue;
+		UnixSocket conn = socket.accept();
+		*message_stream << "Processing query batch " << batch << endl;
+		const string query_file = spool + "_" + std::to_string(batch) + ".faa", output_file = spool + "_" + std::to_string(batch) + ".out";
+		try {
+			process_batch(conn, query_file, output_file, target_seed_hits, db, db_filter, ref_cache);
+		}
+		catch (std::exception& e) {
+			*message_stream << "Error processing query batch " << batch << ": " << e.what() << endl;
+			try {
+				conn.write(string("Error: ") + e.what() + '\n');
+			}
+			catch (std::exception&) {}
+		}
+		std::remove(query_file.c_str());
+		std::remove(output_file.c_str());
+		++batch;
+	}
+	*message_stream << "Encountered \'stop\' file, shutting down server" << endl;
+	std::remove("stop");
+}
+
+void serve_query() {
+	if (config.query_file.size() != 1)
+		throw runtime_error("--serve-query requires a single query file (--query/-q).");
+	string buf;
+	{
+		std::ifstream f(config.query_file.front(), std::ios::binary);
+		if (!f)
+			throw runtime_error("Error opening file " + config.query_file.front());
+		buf.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+	}
+	UnixSocket conn = UnixSocket::connect(config.serve);
+	conn.write(buf);
+	conn.shutdown_write();
+	buf.clear();
+	conn.read_all(buf);
+	if (buf.compare(0, 7, "Error: ") == 0)
+		throw runtime_error("Server: " + buf.substr(7, buf.find_last_not_of('\n') - 6));
+	if (config.output_file.empty())
+		std::cout.write(buf.data(), buf.size());
+	else {
+		std::ofstream f(config.output_file, std::ios::binary);
+		f.write(buf.data(), buf.size());
+		if (!f)
+			throw runtime_error("Error writing file " + config.output_file);
+	}
+}
+
+}
@@ -22,12 +22,20 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 #include "data/sequence_file.h"
 #include "util/io/file.h"
+#include "config.h"
+
+struct OutputFormat;
 
 void get_seq();
 void random_seqs();
 
 namespace Search {
 
-void run(std::unique_ptr<std::vector<BitVector>>& target_seed_hits, const std::shared_ptr<SequenceFile>& db = nullptr, const std::shared_ptr<SequenceFile>& query = nullptr, const std::shared_ptr<File>& out = nullptr, const std::shared_ptr<DbFilter>& db_filter = nullptr);
+void run(std::unique_ptr<std::vector<BitVector>>& target_seed_hits, const std::shared_ptr<SequenceFile>& db = nullptr, const std::shared_ptr<SequenceFile>& query = nullptr, const std::shared_ptr<File>& out = nullptr, const std::shared_ptr<DbFilter>& db_filter = nullptr, const MatchCallback& match_callback = nullptr, const std::shared_ptr<ReferenceCache>& ref_cache = nullptr);
+// Database filter from --taxonlist, --taxon-exclude, --seqidlist or BLAST alias metadata, null if the database is not filtered.
+std::shared_ptr<DbFilter> build_db_filter(SequenceFile& db);
+void serve(std::unique_ptr<std::vector<BitVector>>& target_seed_hits);
+void serve_query();
+SequenceFile::Flags database_flags(const OutputFormat& format);
 
 }
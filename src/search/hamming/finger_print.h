@@ -203,12 +203,37 @@ struct FingerPrint
 
 #endif
 
+// Number of seed locations ahead of the current one whose fingerprint is prefetched.
+static constexpr size_t FP_PREFETCH_DISTANCE = 8;
+
+static inline void prefetch_fp(const Letter* q) noexcept {
+#ifdef __SSE2__
+	_mm_prefetch((const char*)(q - 16), _MM_HINT_T0);
+	_mm_prefetch((const char*)(q + 31), _MM_HINT_T0);
+#elif defined(__GNUC__)
+	__builtin_prefetch(q - 16);
+	__builtin_prefetch(q + 31);
+#endif
+}
+
+template<typename SeedLoc>
+static void prefetch_fps(const SeedLoc* p, size_t n, const SequenceSet& seqs) noexcept
+{
+	const SeedLoc* end = p + std::min(n, FP_PREFETCH_DISTANCE);
+	for (; p < end; ++p)
+		prefetch_fp(seqs.data(*p));
+}
+
 template<typename SeedLoc>
 static void load_fps(const SeedLoc* p, size_t n, ::Search::Container& v, const SequenceSet& seqs) noexcept
 {
 	v.resize(n);
-	const SeedLoc* end = p + n;
+	const SeedLoc* end = p + n, *prefetch_end = n > FP_PREFETCH_DISTANCE ? end - FP_PREFETCH_DISTANCE : p;
 	array<char, 48>* dst = v.data();
+	for (; p < prefetch_end; ++p) {
+		prefetch_fp(seqs.data(p[FP_PREFETCH_DISTANCE]));
+		FingerPrint::load(seqs.data(*p), dst++);
+	}
 	for (; p < end; ++p) {
 		FingerPrint::load(seqs.data(*p), dst++);
 	}
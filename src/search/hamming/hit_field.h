@@ -50,6 +50,11 @@ struct HitField {
 #endif
     }
 
+    // Sets the bits of 64 consecutive targets starting at target, which has to be a multiple of 64.
+    void set_word(uint_fast32_t query, uint_fast32_t target, uint64_t bits) noexcept {
+        data_[((query << shift_) | target) >> 6] = bits;
+    }
+
     const vector<uint_fast32_t>& hits(size_t query) {
         hits_.clear();
         const size_t base_w = query << word_shift_;
@@ -26,7 +26,9 @@ using ::DISPATCH_ARCH::FingerPrint;
 
 namespace Search { namespace DISPATCH_ARCH {
 
-static void all_vs_all(const array<char, 48>* __restrict a, uint_fast32_t na, const array<char, 48>* __restrict b, uint_fast32_t nb, HitField& out, const unsigned hamming_filter_id) {
+// Compares the query fingerprints to the targets in batches of 64, so that the hits of each batch are
+// assembled in a register and written to the hit field as one word.
+static void all_vs_all_generic(const array<char, 48>* __restrict a, uint_fast32_t na, const array<char, 48>* __restrict b, uint_fast32_t nb, HitField& out, const unsigned hamming_filter_id) {
 	const uint_fast32_t na2 = na & ~uint_fast32_t(3);
 	uint_fast32_t i = 0;
 	for (; i < na2; i += 4) {
@@ -34,21 +36,87 @@ static void all_vs_all(const array<char, 48>* __restrict a, uint_fast32_t na, co
 		const FingerPrint e2(a[i + 1]);
 		const FingerPrint e3(a[i + 2]);
 		const FingerPrint e4(a[i + 3]);
-		for (uint_fast32_t j = 0; j < nb; ++j) {
-			const FingerPrint fb(b[j]);
-			out.set(i, j, e1.match(fb) >= hamming_filter_id);
-			out.set(i+1, j, e2.match(fb) >= hamming_filter_id);
-			out.set(i+2, j, e3.match(fb) >= hamming_filter_id);
-			out.set(i+3, j, e4.match(fb) >= hamming_filter_id);
+		for (uint_fast32_t j = 0; j < nb; j += 64) {
+			const uint_fast32_t n = std::min(nb - j, (uint_fast32_t)64);
+			uint64_t h1 = 0, h2 = 0, h3 = 0, h4 = 0;
+			for (uint_fast32_t k = 0; k < n; ++k) {
+				const FingerPrint fb(b[j + k]);
+				h1 |= uint64_t(e1.match(fb) >= hamming_filter_id) << k;
+				h2 |= uint64_t(e2.match(fb) >= hamming_filter_id) << k;
+				h3 |= uint64_t(e3.match(fb) >= hamming_filter_id) << k;
+				h4 |= uint64_t(e4.match(fb) >= hamming_filter_id) << k;
+			}
+			out.set_word(i, j, h1);
+			out.set_word(i + 1, j, h2);
+			out.set_word(i + 2, j, h3);
+			out.set_word(i + 3, j, h4);
 		}
 	}
 	for (; i < na; ++i) {
 		const FingerPrint e(a[i]);
-		for (uint_fast32_t j = 0; j < nb; ++j)
-			out.set(i, j, e.match(FingerPrint(b[j])) >= hamming_filter_id);
+		for (uint_fast32_t j = 0; j < nb; j += 64) {
+			const uint_fast32_t n = std::min(nb - j, (uint_fast32_t)64);
+			uint64_t h = 0;
+			for (uint_fast32_t k = 0; k < n; ++k)
+				h |= uint64_t(e.match(FingerPrint(b[j + k])) >= hamming_filter_id) << k;
+			out.set_word(i, j, h);
+		}
 	}
 }
 
+#if defined(__AVX512BW__) && (defined(_MSC_VER) || defined(__clang__) || __GNUC__ >= 8)
+#define HAMMING_VPOPCNTDQ
+
+#ifdef _MSC_VER
+#define TARGET_VPOPCNTDQ
+#else
+#define TARGET_VPOPCNTDQ __attribute__((target("avx512vpopcntdq")))
+#endif
+
+// Kernel for CPUs supporting AVX512-VPOPCNTDQ. The 48-bit match masks of 8 targets are collected in the
+// 64-bit lanes of a vector, so that they can be counted and compared to the threshold using one
+// instruction each.
+TARGET_VPOPCNTDQ static void all_vs_all_vpopcntdq(const array<char, 48>* __restrict a, uint_fast32_t na, const array<char, 48>* __restrict b, uint_fast32_t nb, HitField& out, const unsigned hamming_filter_id) {
+	const __m512i threshold = _mm512_set1_epi64(hamming_filter_id);
+	for (uint_fast32_t i = 0; i < na; i += 4) {
+		const uint_fast32_t rows = std::min(na - i, (uint_fast32_t)4);
+		__m512i e[4];
+		for (uint_fast32_t r = 0; r < 4; ++r)
+			e[r] = r < rows ? FingerPrint(a[i + r]).v : _mm512_setzero_si512();
+		for (uint_fast32_t j = 0; j < nb; j += 64) {
+			const uint_fast32_t n = std::min(nb - j, (uint_fast32_t)64);
+			uint64_t h[4] = { 0, 0, 0, 0 };
+			for (uint_fast32_t k = 0; k < n; k += 8) {
+				const uint_fast32_t c = std::min(n - k, (uint_fast32_t)8);
+				__m512i m[4] = { _mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512() };
+				for (uint_fast32_t l = 0; l < c; ++l) {
+					const __m512i fb = FingerPrint(b[j + k + l]).v;
+					for (int r = 0; r < 4; ++r)
+						m[r] = _mm512_mask_set1_epi64(m[r], __mmask8(1u << l), (long long)_mm512_mask_cmpeq_epi8_mask(FingerPrint::K48, e[r], fb));
+				}
+				const __mmask8 valid = __mmask8((1u << c) - 1);
+				for (int r = 0; r < 4; ++r)
+					h[r] |= uint64_t(_mm512_mask_cmpge_epu64_mask(valid, _mm512_popcnt_epi64(m[r]), threshold)) << k;
+			}
+			for (uint_fast32_t r = 0; r < rows; ++r)
+				out.set_word(i + r, j, h[r]);
+		}
+	}
+}
+
+#endif
+
+static void all_vs_all(const array<char, 48>* __restrict a, uint_fast32_t na, const array<char, 48>* __restrict b, uint_fast32_t nb, HitField& out, const unsigned hamming_filter_id) {
+#ifdef HAMMING_VPOPCNTDQ
+	static const bool vpopcntdq = ::SIMD::supports(::SIMD::AVX512_VPOPCNTDQ);
+	if (vpopcntdq && nb >= 8) {
+		all_vs_all_vpopcntdq(a, na, b, nb, out, hamming_filter_id);
+		return;
+	}
+#endif
+	all_vs_all_generic(a, na, b, nb, out, hamming_filter_id);
+}
+
 template<typename SeedLoc>
 static void FLATTEN stage1(const SeedLoc* __restrict q, uint_fast32_t nq, const SeedLoc* __restrict s, uint_fast32_t ns, WorkSet& work_set)
 {
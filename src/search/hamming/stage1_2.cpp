@@ -53,10 +53,22 @@ static Stage1KernelPackedLoc* stage1_dispatch(const Search::Config* cfg, PackedL
 			: (config.self && cfg->current_ref_block == 0 ? stage1_self<PackedLoc> : stage1<PackedLoc>));
 }
 
+// Prefetches the first fingerprints of the next seed hit group, which are otherwise loaded from random
+// positions of the sequence sets once the kernel reaches them.
+template<typename SeedLoc>
+static void prefetch_next(const JoinIterator<SeedLoc>& it, const Search::Config& cfg) {
+	JoinIterator<SeedLoc> next = it;
+	if (!++next)
+		return;
+	::DISPATCH_ARCH::prefetch_fps(next.r->begin(), next.r->size(), cfg.query->seqs());
+	::DISPATCH_ARCH::prefetch_fps(next.s->begin(), next.s->size(), cfg.target->seqs());
+}
+
 void run_stage1(JoinIterator<PackedLoc>& it, Search::WorkSet* work_set, const Search::Config* cfg) {
 	auto kernel = stage1_dispatch(cfg, PackedLoc());
 	for (; it; ++it) {
 		work_set->stats.inc(Statistics::SEEDS_HIT);
+		prefetch_next(it, *cfg);
 		kernel(it.r->begin(), (int32_t)it.r->size(), it.s->begin(), (int32_t)it.s->size(), *work_set);
 	}
 }
@@ -65,6 +77,7 @@ void run_stage1(JoinIterator<PackedLocId>& it, Search::WorkSet* work_set, const
 	auto kernel = stage1_dispatch(cfg, PackedLocId());
 	for (; it; ++it) {
 		work_set->stats.inc(Statistics::SEEDS_HIT);
+		prefetch_next(it, *cfg);
 		kernel(it.r->begin(), (int32_t)it.r->size(), it.s->begin(), (int32_t)it.s->size(), *work_set);
 	}
 }
@@ -21,12 +21,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <sys/mman.h>
 #include <fcntl.h>
 #endif
+#include <limits>
 #include "hit_buffer.h"
 #include "basic/config.h"
 #include "util/log_stream.h"
 #include "util/io/output_file.h"
 #include "util/parallel/simple_thread_pool.h"
 #include "data/block/block.h"
+#include "util/string/string.h"
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#else
+#include <zlib.h>
+#endif
 
 using std::vector;
 using std::string;
@@ -42,6 +49,55 @@ using std::tuple;
 
 namespace Search {
 
+static char* write_varuint64(uint64_t x, char* out) {
+	while (x >= 0x80) {
+		*out++ = char(x | 0x80);
+		x >>= 7;
+	}
+	*out++ = char(x);
+	return out;
+}
+
+static const char* read_varuint64(const char* ptr, const char* end, uint64_t& x) {
+	x = 0;
+	for (int shift = 0; ptr < end && shift < 64; shift += 7) {
+		const uint8_t b = (uint8_t)*ptr++;
+		x |= uint64_t(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			return ptr;
+	}
+	throw runtime_error("HitBuffer: invalid varint / possibly corrupted memory buffer");
+}
+
+static void compress_block(const vector<char>& in, vector<char>& out) {
+#ifdef WITH_ZSTD
+	out.resize(ZSTD_compressBound(in.size()));
+	const size_t n = ZSTD_compress(out.data(), out.size(), in.data(), in.size(), 1);
+	if (ZSTD_isError(n))
+		throw runtime_error(ZSTD_getErrorName(n));
+#else
+	uLongf n = compressBound((uLong)in.size());
+	out.resize(n);
+	if (compress2((Bytef*)out.data(), &n, (const Bytef*)in.data(), (uLong)in.size(), Z_BEST_SPEED) != Z_OK)
+		throw runtime_error("HitBuffer: compress2 failed");
+#endif
+	out.resize(n);
+	out.shrink_to_fit();
+}
+
+static void decompress_block(const vector<char>& in, vector<char>& out, size_t raw_size) {
+	out.resize(raw_size);
+#ifdef WITH_ZSTD
+	const size_t n = ZSTD_decompress(out.data(), raw_size, in.data(), in.size());
+	if (ZSTD_isError(n) || n != raw_size)
+		throw runtime_error("HitBuffer: decompression failed / possibly corrupted memory buffer");
+#else
+	uLongf n = (uLongf)raw_size;
+	if (uncompress((Bytef*)out.data(), &n, (const Bytef*)in.data(), (uLong)in.size()) != Z_OK || n != raw_size)
+		throw runtime_error("HitBuffer: decompression failed / possibly corrupted memory buffer");
+#endif
+}
+
 HitBuffer::HitBuffer(const vector<Key>& key_partition, const string& tmpdir, bool long_subject_offsets, int query_contexts, int thread_count, Config& cfg) :
 	HitBuffer(key_partition, tmpdir, long_subject_offsets, query_contexts, thread_count,
 		(uint32_t)cfg.query->seqs().size(), (uint64_t)cfg.target->seqs().raw_len(),
@@ -50,6 +106,7 @@ HitBuffer::HitBuffer(const vector<Key>& key_partition, const string& tmpdir, boo
 
 HitBuffer::HitBuffer(const vector<Key>& key_partition, const string& tmpdir, bool long_subject_offsets, int query_contexts, int thread_count, uint32_t max_query, uint64_t max_target, SimpleThreadPool& search_pool) :
 	key_partition_(key_partition),
+	bin_shift_(0),
 	long_subject_offsets_(long_subject_offsets),
 	query_contexts_(query_contexts),
 	max_query_(max_query),
@@ -57,11 +114,24 @@ HitBuffer::HitBuffer(const vector<Key>& key_partition, const string& tmpdir, boo
 	search_pool_(search_pool),
 	bins_processed_(0),
 	total_disk_size_(0),
+	total_mem_size_(0),
+	mem_limit_(config.hit_buffer_mem.empty() ? 0 : Util::String::interpret_number(config.hit_buffer_mem)),
+	mem_used_(0),
 	load_worker_(nullptr),
-	load_exception_(nullptr)
+	load_exception_(nullptr),
+	text_buffer_pool_(thread_count * 4, 0),
+	hit_vector_pool_(config.trace_pt_membuf ? thread_count * 4 : 1, 8192)
 {
 	*log_stream << "Async_buffer() " << key_partition.back() << std::endl;
 	count_ = new atomic_size_t[key_partition.size()];
+	while ((key_partition.back() >> bin_shift_) > BIN_LOOKUP_SIZE)
+		++bin_shift_;
+	bin_lookup_.reserve((key_partition.back() >> bin_shift_) + 1);
+	for (int i = 0; bin_lookup_.size() <= (key_partition.back() >> bin_shift_);) {
+		while (i < (int)key_partition.size() - 1 && ((Key)bin_lookup_.size() << bin_shift_) >= key_partition[i])
+			++i;
+		bin_lookup_.push_back(i);
+	}
 
 	for (size_t i = 0; i < key_partition.size(); ++i) {
 		count_[i].store(0, std::memory_order_relaxed);
@@ -75,6 +145,7 @@ HitBuffer::HitBuffer(const vector<Key>& key_partition, const string& tmpdir, boo
 		else {
 			out_queue_.push_back(new Queue<tuple<int, TextBuffer*, uint32_t>>(thread_count * 4, thread_count, 1, tuple<int, TextBuffer*, uint32_t>(0, nullptr, 0)));
 			tmp_file_.push_back(File(Temporary()));
+			mem_blocks_.emplace_back();
 		}
 	}
 
@@ -93,23 +164,123 @@ void HitBuffer::write_worker(const std::atomic<bool>& stop, int bin) {
 				break;
 			vector<Hit>& hits = hit_buf_[buf.first];
 			hits.insert(hits.end(), buf.second->begin(), buf.second->end());
-			delete buf.second;
+			hit_vector_pool_.put(buf.second);
 		}
 	}
 	else {
+		vector<char> encode_buf;
 		while (!stop) {
 			tuple<int, TextBuffer*, uint32_t> buf;
 			if (!out_queue_[bin]->wait_and_dequeue(buf))
 				break;
+			if (mem_limit_ > 0 && store_in_memory(std::get<0>(buf), *std::get<1>(buf), std::get<2>(buf), encode_buf)) {
+				text_buffer_pool_.put(std::get<1>(buf));
+				continue;
+			}
 			File& tmp_file = tmp_file_[std::get<0>(buf)];
 			tmp_file.write(std::get<1>(buf)->size());
 			tmp_file.write(std::get<2>(buf));
 			tmp_file.write(std::get<1>(buf)->data(), std::get<1>(buf)->size());
-			delete std::get<1>(buf);
+			text_buffer_pool_.put(std::get<1>(buf));
 		}
 	}
 }
 
+// Re-encodes a buffer of the writer's record format with varint scores and
+// zigzag-coded subject deltas and keeps it compressed in memory. Returns false
+// if the block does not fit into the memory budget and has to go to disk.
+bool HitBuffer::store_in_memory(int bin, const TextBuffer& buf, uint32_t count, vector<char>& encode_buf) {
+	const char* ptr = buf.data(), * end = ptr + buf.size();
+	encode_buf.resize(buf.size() * 2 + 16);
+	char* out = encode_buf.data();
+	uint64_t last_subject = 0;
+	ptr += 2;
+	while (ptr < end) {
+		uint32_t query_id, seed_offset;
+		memcpy(&query_id, ptr, 4);
+		memcpy(&seed_offset, ptr + 4, 4);
+		ptr += 8;
+		out = write_varuint64(query_id, out);
+		out = write_varuint64(seed_offset, out);
+		while (ptr < end) {
+			uint16_t score;
+			memcpy(&score, ptr, 2);
+			ptr += 2;
+			out = write_varuint64(score, out);
+			if (score == 0)
+				break;
+			uint64_t subject;
+			if (long_subject_offsets_) {
+				PackedLoc l;
+				memcpy(&l, ptr, sizeof(PackedLoc));
+				ptr += sizeof(PackedLoc);
+				subject = l;
+			}
+			else {
+				uint32_t x;
+				memcpy(&x, ptr, 4);
+				ptr += 4;
+				subject = x;
+			}
+			const int64_t d = int64_t(subject - last_subject);
+			out = write_varuint64(uint64_t(d << 1) ^ uint64_t(d >> 63), out);
+			last_subject = subject;
+#ifdef HIT_KEEP_TARGET_ID
+			uint32_t target_block_id;
+			memcpy(&target_block_id, ptr, 4);
+			ptr += 4;
+			out = write_varuint64(target_block_id, out);
+#endif
+		}
+	}
+	const size_t raw_size = out - encode_buf.data();
+	encode_buf.resize(raw_size);
+	MemBlock block{ {}, raw_size, count };
+	compress_block(encode_buf, block.data);
+	const int64_t size = (int64_t)block.data.size();
+	if (mem_used_.fetch_add(size, std::memory_order_relaxed) + size > mem_limit_) {
+		mem_used_.fetch_sub(size, std::memory_order_relaxed);
+		return false;
+	}
+	mem_blocks_[bin].push_back(std::move(block));
+	return true;
+}
+
+uint32_t HitBuffer::decode_block(const char* ptr, const char* end, Hit* dst, uint32_t count) const {
+	uint32_t n = 0;
+	uint64_t last_subject = 0, x;
+	while (ptr < end) {
+		uint64_t query_id, seed_offset;
+		ptr = read_varuint64(ptr, end, query_id);
+		ptr = read_varuint64(ptr, end, seed_offset);
+		if (query_id >= max_query_)
+			throw runtime_error("HitBuffer::decode_block(): invalid query id / possibly corrupted memory buffer");
+		while (true) {
+			uint64_t score;
+			ptr = read_varuint64(ptr, end, score);
+			if (score == 0)
+				break;
+			ptr = read_varuint64(ptr, end, x);
+			last_subject += uint64_t(int64_t(x >> 1) ^ -int64_t(x & 1));
+			if (last_subject >= max_target_)
+				throw runtime_error("HitBuffer::decode_block(): invalid subject location / possibly corrupted memory buffer");
+			if (n >= count)
+				throw runtime_error("HitBuffer::decode_block(): buffer overflow / possibly corrupted memory buffer");
+#ifdef HIT_KEEP_TARGET_ID
+			ptr = read_varuint64(ptr, end, x);
+			dst->target_block_id = (uint32_t)x;
+#endif
+			dst->query_ = (uint32_t)query_id;
+			dst->subject_ = last_subject;
+			dst->seed_offset_ = (uint32_t)seed_offset;
+			dst->score_ = (uint16_t)score;
+			++dst;
+			++n;
+		}
+	}
+	return n;
+}
+
 void HitBuffer::finish_writing() {
 	auto cleanup = [&]() {
 		for (auto& q : membuf_out_queue_)
@@ -170,15 +341,25 @@ bool HitBuffer::load(size_t max_size) {
 	const int begin = bins_processed_;
 	int end = bins_processed_ + 1;
 	if (!config.trace_pt_membuf && !config.swipe_all) {
+		auto mem_size = [this](int bin) {
+			int64_t n = 0;
+			for (const MemBlock& b : mem_blocks_[bin])
+				n += b.data.size();
+			return n;
+		};
 		size_t disk_size = tmp_file_[bins_processed_].size();
+		int64_t compressed_size = mem_size(bins_processed_);
 		// consider using more bins here
 		while (end < bins() && (size + (current_size = count_[end])) * sizeof(Hit) < max_size && (end - bins_processed_ == 0)) {
 			size += current_size;
 			disk_size += tmp_file_[end].size();
+			compressed_size += mem_size(end);
 			++end;
 		}
-		*log_stream << "Async_buffer.load() " << size << " (" << (double)size * sizeof(Hit) / (1 << 30) << " GB, " << (double)disk_size / (1 << 30) << " GB on disk)" << endl;
+		*log_stream << "Async_buffer.load() " << size << " (" << (double)size * sizeof(Hit) / (1 << 30) << " GB, " << (double)disk_size / (1 << 30) << " GB on disk, "
+			<< (double)compressed_size / (1 << 30) << " GB compressed in memory)" << endl;
 		total_disk_size_ += disk_size;
+		total_mem_size_ += compressed_size;
 		data_size_next_ = size;
 		load_worker_ = new thread(worker, end);
 	}
@@ -204,19 +385,28 @@ void HitBuffer::load_bin(Hit* out, int bin)
 		return;
 	}
 	const int p = config.threads_ > 1 ? std::min(config.threads_ - 1, config.load_threads) : 1;
-	Queue<pair<vector<char>*, uint32_t>> queue(p * 4, 1, p, pair<vector<char>*, uint32_t>(nullptr, 0));
+	Queue<tuple<vector<char>*, uint32_t, size_t>> queue(p * 4, 1, p, tuple<vector<char>*, uint32_t, size_t>(nullptr, 0, 0));
 	atomic<Hit*> out_ptr(out);
 	atomic<uint64_t> count(0);
 	f.seek(0, SEEK_SET);
 	SimpleThreadPool pool;
 	auto worker = [&](const atomic<bool>& stop, int worker_id) {
 		uint64_t my_count = 0;
+		vector<char> raw;
 		while (true) {
-			pair<vector<char>*, uint32_t> v;
-			if (!queue.wait_and_dequeue(v)) {
+			tuple<vector<char>*, uint32_t, size_t> w;
+			if (!queue.wait_and_dequeue(w)) {
 				break;
 			}
+			const pair<vector<char>*, uint32_t> v(std::get<0>(w), std::get<1>(w));
 			Hit* dst = out_ptr.fetch_add(v.second, std::memory_order_relaxed);
+			if (std::get<2>(w) > 0) {
+				decompress_block(*v.first, raw, std::get<2>(w));
+				mem_used_.fetch_sub((int64_t)v.first->size(), std::memory_order_relaxed);
+				delete v.first;
+				my_count += decode_block(raw.data(), raw.data() + raw.size(), dst, v.second);
+				continue;
+			}
 			uint32_t package_count = 0;
 			vector<char>::const_iterator ptr = v.first->begin(), end = v.first->end();
 			uint16_t nullscore;
@@ -273,6 +463,13 @@ void HitBuffer::load_bin(Hit* out, int bin)
 	for (int i = 0; i < p; ++i)
 		pool.spawn(worker, i);
 	try {
+		for (MemBlock& b : mem_blocks_[bin]) {
+			if (pool.stop())
+				break;
+			queue.enqueue(tuple<vector<char>*, uint32_t, size_t>(new vector<char>(std::move(b.data)), b.count, b.raw_size));
+		}
+		mem_blocks_[bin].clear();
+		mem_blocks_[bin].shrink_to_fit();
 		while (!pool.stop()) {
 			uint32_t n;
 			size_t l;
@@ -287,7 +484,7 @@ void HitBuffer::load_bin(Hit* out, int bin)
 				delete v;
 				throw;
 			}
-			queue.enqueue(pair<vector<char>*, uint32_t>(v, n));
+			queue.enqueue(tuple<vector<char>*, uint32_t, size_t>(v, n, 0));
 		}
 	}
 	catch (...) {
@@ -57,11 +57,12 @@ struct HitBuffer
 	}
 
 	int bin(Key key) const {
-		const int n = (int)key_partition_.size();
-		for (int i = 0; i < n; ++i)
-			if (key < key_partition_[i])
-				return i;
-		throw std::runtime_error("key_partition error");
+		if (key >= key_partition_.back())
+			throw std::runtime_error("key_partition error");
+		int i = bin_lookup_[key >> bin_shift_];
+		while (key >= key_partition_[i])
+			++i;
+		return i;
 	}
 
 	struct Writer
@@ -78,12 +79,10 @@ struct HitBuffer
 			const int bins = parent.bins();
 			if (!config.trace_pt_membuf)
 				for (int i = 0; i < bins; ++i)
-					text_buffer_[i] = new TextBuffer();
+					text_buffer_[i] = parent.text_buffer_pool_.get();
 			else
-				for (int i = 0; i < bins; ++i) {
-					buffer_[i] = new std::vector<Hit>();
-					buffer_[i]->reserve(buffer_size);
-				}
+				for (int i = 0; i < bins; ++i)
+					buffer_[i] = parent.hit_vector_pool_.get();
 		}
 		void new_query(unsigned query, Loc seed_offset) {
 			last_bin_ = parent_.bin(query / parent_.query_contexts_);
@@ -134,24 +133,22 @@ struct HitBuffer
 		{
 			if(config.trace_pt_membuf) {
 				if (buffer_[bin]->size() == 0) {
-					delete buffer_[bin];
+					parent_.hit_vector_pool_.put(buffer_[bin]);
 					return;
 				}
 				parent_.membuf_out_queue_[bin]->enqueue(std::pair<int, std::vector<Hit>*>(bin, buffer_[bin]));
-				if (!done) {
-					buffer_[bin] = new std::vector<Hit>();
-					buffer_[bin]->reserve(buffer_size);
-				}
+				if (!done)
+					buffer_[bin] = parent_.hit_vector_pool_.get();
 			}
 			else {
 				if (text_buffer_[bin]->size() == 0) {
-					delete text_buffer_[bin];
+					parent_.text_buffer_pool_.put(text_buffer_[bin]);
 					return;
 				}
 				text_buffer_[bin]->write((uint16_t)0);
 				parent_.out_queue_[bin]->enqueue(std::tuple<int, TextBuffer*, uint32_t>(bin, text_buffer_[bin], buf_count_[bin]));
 				buf_count_[bin] = 0;
-				if(!done) text_buffer_[bin] = new TextBuffer();
+				if(!done) text_buffer_[bin] = parent_.text_buffer_pool_.get();
 			}
 		}
 		virtual ~Writer()
@@ -207,6 +204,15 @@ struct HitBuffer
 		return total_disk_size_;
 	}
 
+	size_t total_mem_size() {
+		return total_mem_size_;
+	}
+
+	// Compressed seed hits currently held in memory (--hit-buffer-mem); shrinks as bins are loaded.
+	int64_t resident_mem_size() const {
+		return mem_used_.load(std::memory_order_relaxed);
+	}
+
 	int64_t bin_size(int i) const {
 		return count_[i];
 	}
@@ -220,17 +226,62 @@ struct HitBuffer
 
 private:
 
+	// Recycles flushed writer buffers instead of freeing them in the write workers.
+	template<typename T>
+	struct BufferPool {
+		BufferPool(size_t capacity, size_t reserve) :
+			reserve_(reserve),
+			free_(capacity, 1, 1, nullptr)
+		{}
+		~BufferPool() {
+			T* p;
+			while (free_.try_pop(p))
+				delete p;
+		}
+		T* get() {
+			T* p;
+			if (free_.try_pop(p))
+				return p;
+			p = new T();
+			p->reserve(reserve_);
+			return p;
+		}
+		void put(T* p) {
+			p->clear();
+			if (!free_.try_enqueue(p))
+				delete p;
+		}
+	private:
+		const size_t reserve_;
+		Queue<T*> free_;
+	};
+
+	struct MemBlock {
+		std::vector<char> data;
+		size_t raw_size;
+		uint32_t count;
+	};
+
 	void load_bin(Hit* out, int bin);
 	void write_worker(const std::atomic<bool>& stop, int bin);
+	bool store_in_memory(int bin, const TextBuffer& buf, uint32_t count, std::vector<char>& encode_buf);
+	uint32_t decode_block(const char* ptr, const char* end, Hit* dst, uint32_t count) const;
+
+	static constexpr Key BIN_LOOKUP_SIZE = 1 << 16;
 
 	const std::vector<Key> key_partition_;
+	int bin_shift_;
+	std::vector<int> bin_lookup_;
 	const bool long_subject_offsets_;
 	const int query_contexts_;
 	const uint32_t max_query_;
 	const uint64_t max_target_;
 	SimpleThreadPool& search_pool_;
 	int bins_processed_;
-	int64_t total_disk_size_;
+	int64_t total_disk_size_, total_mem_size_;
+	const int64_t mem_limit_;
+	std::atomic<int64_t> mem_used_;
+	std::vector<std::vector<MemBlock>> mem_blocks_;
 	std::vector<std::vector<Hit>> hit_buf_;
 	std::vector<File> tmp_file_;
 	std::atomic_size_t *count_;
@@ -243,6 +294,8 @@ private:
 	std::vector<std::thread::id> writer_;
 	std::vector<Queue<std::tuple<int, TextBuffer*, uint32_t>>*> out_queue_;
 	std::vector<Queue<std::pair<int, std::vector<Hit>*>>*> membuf_out_queue_;
+	BufferPool<TextBuffer> text_buffer_pool_;
+	BufferPool<std::vector<Hit>> hit_vector_pool_;
 
 };
 
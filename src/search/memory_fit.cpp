@@ -0,0 +1,57 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "basic/config.h"
+#include "basic/shape_config.h"
+#include "search.h"
+
+namespace Search {
+
+static const unsigned MAX_INDEX_CHUNKS = 16;
+
+// Heuristics for --fit-memory. They only estimate the memory use of the search from the block sizes and the
+// query seed histogram; the reference is not sampled and the expected number of seed hits is not considered.
+
+double fit_block_size(int64_t memory_limit, int64_t db_letters) {
+	return ::block_size(memory_limit, db_letters, config.sensitivity, false, config.threads_).first;
+}
+
+// Predicts the peak memory use of the double-indexed search for a query block with the given seed histogram
+// and a reference block of target_letters. The number of index chunks is chosen as the smallest one that
+// fits into the memory limit, since every additional chunk costs one more pass of seed enumeration over
+// both blocks.
+IndexFit fit_index_chunks(const SeedHistogram& query_hst, int64_t query_letters, int64_t target_letters, int64_t memory_limit, size_t entry_size) {
+	IndexFit r;
+	for (unsigned c = 1;; ++c) {
+		const int bits = seedp_bits(shapes[0].weight_, config.threads_, c);
+		r = { c, bits, query_letters + target_letters + seed_array_memory(query_hst, query_letters, target_letters, c, bits, entry_size) };
+		if (r.predicted_memory <= memory_limit || c == MAX_INDEX_CHUNKS)
+			return r;
+	}
+}
+
+// Assumes that the reference seeds are distributed over the seed partitions like the query seeds.
+int64_t seed_array_memory(const SeedHistogram& query_hst, int64_t query_letters, int64_t target_letters, unsigned index_chunks, int seedp_bits, size_t entry_size) {
+	const double target_ratio = query_letters > 0 ? (double)target_letters / query_letters : 0.0;
+	const double chunk_seeds = (double)query_hst.max_chunk_size(index_chunks) * (1.0 + target_ratio),
+		hash_join_factor = 1.0 + (double)config.threads_ / ((double)seedp_count(seedp_bits) / index_chunks);
+	return (int64_t)(chunk_seeds * entry_size * hash_join_factor);
+}
+
+}
@@ -83,6 +83,17 @@ void setup_search(Sensitivity sens, Search::Config& cfg);
 MaskingAlgo soft_masking_algo(const SensitivityTraits& traits);
 int seedp_bits(int shape_weight, int threads, int index_chunks);
 
+struct IndexFit {
+	unsigned index_chunks;
+	int seedp_bits;
+	int64_t predicted_memory;
+};
+
+double fit_block_size(int64_t memory_limit, int64_t db_letters);
+IndexFit fit_index_chunks(const SeedHistogram& query_hst, int64_t query_letters, int64_t target_letters, int64_t memory_limit, size_t entry_size);
+// Estimated peak memory of the query and reference seed arrays of one index chunk.
+int64_t seed_array_memory(const SeedHistogram& query_hst, int64_t query_letters, int64_t target_letters, unsigned index_chunks, int seedp_bits, size_t entry_size);
+
 }
 
 namespace Search {
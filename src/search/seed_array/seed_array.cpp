@@ -31,5 +31,6 @@ namespace DISPATCH_ARCH {
 template char* SeedArray<PackedLoc>::alloc_buffer(const SeedHistogram&, int);
 
 template SeedArray<PackedLoc>::SeedArray(Block&, const ShapeHistogram&, const SeedPartitionRange&, int, char* buffer, const NoFilter*, const EnumCfg&);
+template SeedArray<PackedLoc>::SeedArray(const Entry*, const uint64_t*, const SeedPartitionRange&, int, char*, const SeedEncoding);
 
 }
\ No newline at end of file
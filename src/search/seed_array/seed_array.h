@@ -89,6 +89,8 @@ struct SeedArray
 	template<typename Filter>
 	SeedArray(Block& seqs, const SeedPartitionRange& range, int seedp_bits, const Filter* filter, EnumCfg& cfg);
 
+	SeedArray(const Entry* data, const uint64_t* partition_offsets, const SeedPartitionRange& range, int seedp_bits, char* buffer, const SeedEncoding code);
+
 	Entry* begin(unsigned i)
 	{
 		if (data_)
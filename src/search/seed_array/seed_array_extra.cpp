@@ -37,6 +37,7 @@ template SeedArray<PackedLoc>::SeedArray(Block&, const ShapeHistogram&, const Se
 template SeedArray<PackedLocId>::SeedArray(Block&, const ShapeHistogram&, const SeedPartitionRange&, int, char* buffer, const NoFilter*, const EnumCfg&);
 template SeedArray<PackedLocId>::SeedArray(Block&, const ShapeHistogram&, const SeedPartitionRange&, int, char* buffer, const SeedSet*, const EnumCfg&);
 template SeedArray<PackedLocId>::SeedArray(Block&, const ShapeHistogram&, const SeedPartitionRange&, int, char* buffer, const HashedSeedSet*, const EnumCfg&);
+template SeedArray<PackedLocId>::SeedArray(const Entry*, const uint64_t*, const SeedPartitionRange&, int, char*, const SeedEncoding);
 
 template<typename SeedLoc>
 struct OnePassBufferedWriter
@@ -146,4 +146,16 @@ SeedArray<SeedLoc>::SeedArray(Block& seqs, const ShapeHistogram& hst, const Seed
 	stats_ = enum_seeds(seqs, cb, filter, enum_cfg);
 }
 
+template<typename SeedLoc>
+SeedArray<SeedLoc>::SeedArray(const Entry* data, const uint64_t* partition_offsets, const SeedPartitionRange& range, int seedp_bits, char* buffer, const SeedEncoding code) :
+	key_bits(seed_bits(code, seedp_bits)),
+	data_((Entry*)buffer)
+{
+	const uint64_t offset = partition_offsets[range.begin()];
+	begin_.reserve(range.size() + 1);
+	for (SeedPartition i = range.begin(); i <= range.end(); ++i)
+		begin_.push_back(partition_offsets[i] - offset);
+	memcpy(data_, data + offset, sizeof(Entry) * begin_.back());
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <sstream>
+#include <string.h>
+#include <stdexcept>
+#include "mio/mmap.hpp"
+#include "seed_array_index.h"
+#include "seed_array.h"
+#include "basic/config.h"
+#include "basic/shape_config.h"
+#include "basic/reduction.h"
+#include "data/block/block.h"
+#include "run/config.h"
+#include "util/algo/partition.h"
+#include "util/log_stream.h"
+
+using std::string;
+using std::runtime_error;
+using std::to_string;
+using std::endl;
+
+SeedArrayIndex::SeedArrayIndex(const string& file_name):
+	mmap_(new mio::mmap_source(file_name))
+{
+	const char* buf = mmap_->data();
+	const size_t size = mmap_->length();
+	if (size < SEED_ARRAY_INDEX_HEADER_SIZE + SEED_ARRAY_INDEX_TRAILER_SIZE || *(const uint64_t*)buf != SEED_ARRAY_INDEX_MAGIC_NUMBER)
+		throw runtime_error("Invalid seed array index file: " + file_name);
+	if (*(const uint32_t*)(buf + 8) != SEED_ARRAY_INDEX_VERSION)
+		throw runtime_error("Invalid seed array index file version.");
+	shape_count_ = *(const int32_t*)(buf + 12);
+	seedp_bits_ = *(const int32_t*)(buf + 16);
+	entry_size_ = *(const uint32_t*)(buf + 20);
+	signature_ = string(buf + SEED_ARRAY_INDEX_HEADER_SIZE);
+
+	const uint64_t table_offset = *(const uint64_t*)(buf + size - SEED_ARRAY_INDEX_TRAILER_SIZE),
+		block_count = *(const uint64_t*)(buf + size - SEED_ARRAY_INDEX_TRAILER_SIZE + 8);
+	if (table_offset + block_count * sizeof(BlockInfo) + SEED_ARRAY_INDEX_TRAILER_SIZE != size)
+		throw runtime_error("Seed array index file is truncated: " + file_name);
+	const BlockInfo* table = (const BlockInfo*)(buf + table_offset);
+	blocks_.assign(table, table + block_count);
+
+	const size_t offsets_size = sizeof(uint64_t) * (seedp_count() + 1);
+	for (const BlockInfo& b : blocks_) {
+		shape_data_.emplace_back();
+		const char* ptr = buf + b.offset;
+		for (int i = 0; i < shape_count_; ++i) {
+			shape_data_.back().push_back(ptr);
+			const uint64_t n = ((const uint64_t*)ptr)[seedp_count()];
+			ptr += offsets_size + (n * entry_size_ + 7) / 8 * 8;
+		}
+	}
+	*log_stream << "Seed array index: blocks=" << blocks_.size() << " shapes=" << shape_count_ << " seedp_bits=" << seedp_bits_ << endl;
+}
+
+SeedArrayIndex::SeedArrayIndex(const Search::Config& cfg):
+	shape_count_(::shapes.count()),
+	seedp_bits_(cfg.seedp_bits),
+	entry_size_((uint32_t)sizeof(ARCH_GENERIC::SeedArray<PackedLoc>::Entry)),
+	signature_(signature(cfg))
+{}
+
+SeedArrayIndex::~SeedArrayIndex() {
+}
+
+void SeedArrayIndex::add_block(Block& seqs, const Search::Config& cfg) {
+	using SA = ARCH_GENERIC::SeedArray<PackedLoc>;
+	const SeedPartitionRange range(0, (SeedPartition)seedp_count());
+	EnumCfg enum_cfg{ nullptr, 0, 0, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut, cfg.soft_masking, cfg.minimizer_window, false, false, cfg.sketch_size, nullptr };
+	seqs.hst() = SeedHistogram(seqs, false, &no_filter, enum_cfg, seedp_bits_);
+	char* buffer = SA::alloc_buffer(seqs.hst(), 1);
+	blocks_.push_back({ (uint64_t)seqs.oid_begin(), (uint64_t)seqs.seqs().size(), (uint64_t)seqs.seqs().letters(), 0 });
+	shape_data_.emplace_back();
+	for (int sid = 0; sid < shape_count_; ++sid) {
+		const EnumCfg enum_ref{ &seqs.hst().partition(), sid, sid + 1, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut,
+			cfg.soft_masking, cfg.minimizer_window, false, false, cfg.sketch_size, nullptr };
+		const SA ref_idx(seqs, seqs.hst().get(sid), range, seedp_bits_, buffer, &no_filter, enum_ref);
+		const size_t offsets_size = sizeof(uint64_t) * (range.size() + 1);
+		owned_data_.emplace_back(offsets_size + ref_idx.size() * entry_size_);
+		char* ptr = owned_data_.back().data();
+		uint64_t offset = 0;
+		for (SeedPartition i = 0; i < range.size(); ++i) {
+			((uint64_t*)ptr)[i] = offset;
+			offset += ref_idx.size(i);
+		}
+		((uint64_t*)ptr)[range.size()] = offset;
+		memcpy(ptr + offsets_size, ref_idx.begin(0), ref_idx.size() * entry_size_);
+		shape_data_.back().push_back(ptr);
+	}
+	Util::Memory::aligned_free(buffer);
+}
+
+bool SeedArrayIndex::matches(const Search::Config& cfg) const {
+	return shape_count_ == ::shapes.count() && seedp_bits_ == cfg.seedp_bits && signature_ == signature(cfg)
+		&& entry_size_ == sizeof(ARCH_GENERIC::SeedArray<PackedLoc>::Entry);
+}
+
+size_t SeedArrayIndex::seedp_count() const {
+	return ::seedp_count(seedp_bits_);
+}
+
+string SeedArrayIndex::signature(const Search::Config& cfg) {
+	std::ostringstream s;
+	s << "shapes=" << ::shapes
+		<< ";reduction=" << Reduction::get_reduction()
+		<< ";block_size=" << config.block_size()
+		<< ";matrix=" << config.matrix
+		<< ";masking=" << (int)cfg.target_masking
+		<< ";soft_masking=" << (int)cfg.soft_masking
+		<< ";seed_cut=" << cfg.seed_complexity_cut
+		<< ";encoding=" << (int)cfg.seed_encoding;
+	return s.str();
+}
+
+string SeedArrayIndex::file_name(const string& db_file) {
+	return db_file + ".seed_arr";
+}
+
+void SeedArrayIndex::check_config(const Search::Config& cfg) const {
+	if (shape_count_ != ::shapes.count() || signature_ != signature(cfg))
+		throw runtime_error("The seed array index was built with a different configuration. Index: " + signature_ + " Search: " + signature(cfg));
+	if (entry_size_ != sizeof(ARCH_GENERIC::SeedArray<PackedLoc>::Entry))
+		throw runtime_error("The seed array index is not compatible with this build of the program.");
+}
+
+void SeedArrayIndex::check_block(int block, const Block& seqs) const {
+	if (block >= block_count())
+		throw runtime_error("Reference block " + to_string(block + 1) + " is not contained in the seed array index.");
+	const BlockInfo& b = blocks_[block];
+	if (b.oid_begin != (uint64_t)seqs.oid_begin() || b.seqs != (uint64_t)seqs.seqs().size() || b.letters != (uint64_t)seqs.seqs().letters())
+		throw runtime_error("Reference block " + to_string(block + 1) + " does not match the seed array index.");
+}
+
+size_t SeedArrayIndex::max_chunk_size(int block, int index_chunks) const {
+	size_t max = 0;
+	const ::Partition<SeedPartition> p((SeedPartition)seedp_count(), index_chunks);
+	for (int shape = 0; shape < shape_count_; ++shape) {
+		const uint64_t* offsets = partition_offsets(block, shape);
+		for (SeedPartition chunk = 0; chunk < p.parts; ++chunk)
+			max = std::max(max, (size_t)(offsets[p.end(chunk)] - offsets[p.begin(chunk)]));
+	}
+	return max;
+}
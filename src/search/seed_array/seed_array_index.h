@@ -0,0 +1,90 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "mio/forward.h"
+#include <stdint.h>
+
+/* Persistent reference seed index (makeidx --seed-array-index).
+   File layout:
+     header:  magic (8), version (4), shape count (4), seed partition bits (4), entry size (4),
+              configuration signature (null-terminated), padding to 8 bytes
+     blocks:  for each reference block and shape: seed partition offsets (uint64_t, seedp_count + 1),
+              followed by the SeedArray entries, padded to 8 bytes
+     table:   BlockInfo for each block
+     trailer: table offset (8), block count (8)
+   An index can also be built in memory block by block (add_block), which --serve uses to keep
+   the reference seed arrays across query batches. */
+
+const uint64_t SEED_ARRAY_INDEX_MAGIC_NUMBER = 0x5a0c7e33b1d2946f;
+const uint32_t SEED_ARRAY_INDEX_VERSION = 0;
+const size_t SEED_ARRAY_INDEX_HEADER_SIZE = 24;
+const size_t SEED_ARRAY_INDEX_TRAILER_SIZE = 16;
+
+struct Block;
+namespace Search {
+	struct Config;
+}
+
+struct SeedArrayIndex {
+
+	struct BlockInfo {
+		uint64_t oid_begin, seqs, letters, offset;
+	};
+
+	SeedArrayIndex(const std::string& file_name);
+	SeedArrayIndex(const Search::Config& cfg);
+	~SeedArrayIndex();
+	// Builds the seed arrays of all shapes for the next reference block and keeps them in memory.
+	void add_block(Block& seqs, const Search::Config& cfg);
+	bool matches(const Search::Config& cfg) const;
+	void check_config(const Search::Config& cfg) const;
+	void check_block(int block, const Block& seqs) const;
+	size_t max_chunk_size(int block, int index_chunks) const;
+	const uint64_t* partition_offsets(int block, int shape) const {
+		return (const uint64_t*)shape_data_[block][shape];
+	}
+	const char* entries(int block, int shape) const {
+		return shape_data_[block][shape] + sizeof(uint64_t) * (seedp_count() + 1);
+	}
+	int seedp_bits() const {
+		return seedp_bits_;
+	}
+	int64_t block_count() const {
+		return (int64_t)blocks_.size();
+	}
+	size_t seedp_count() const;
+
+	static std::string signature(const Search::Config& cfg);
+	static std::string file_name(const std::string& db_file);
+
+private:
+
+	std::unique_ptr<mio::mmap_source> mmap_;
+	int shape_count_, seedp_bits_;
+	uint32_t entry_size_;
+	std::string signature_;
+	std::vector<BlockInfo> blocks_;
+	std::vector<std::vector<const char*>> shape_data_;
+	std::vector<std::vector<char>> owned_data_;
+
+};
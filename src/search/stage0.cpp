@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <atomic>
 #include "search.h"
 #include "search/seed_array/seed_array.h"
+#include "search/seed_array/seed_array_index.h"
 #include "data/frequent_seeds.h"
 #include "util/data_structures/double_array.h"
 #include "util/system/system.h"
@@ -125,7 +126,12 @@ void search_shape(int sid, int query_block, unsigned query_iteration, char *quer
 		const EnumCfg enum_ref{ &ref_hst.partition(), sid, sid + 1, cfg.seed_encoding, nullptr, false, false, cfg.seed_complexity_cut,
 			query_seeds_bitset.get() || (bool)query_seeds_hashed ? MaskingAlgo::NONE : cfg.soft_masking,
 			cfg.minimizer_window, false, false, cfg.sketch_size, cfg.target_seed_hits.get() };
-		if (query_seeds_bitset.get())
+		if (cfg.seed_array_index) {
+			timer.go("Loading reference seed array from index");
+			ref_idx = new SA((const typename SA::Entry*)cfg.seed_array_index->entries(cfg.current_ref_block, sid), cfg.seed_array_index->partition_offsets(cfg.current_ref_block, sid),
+				range, cfg.seedp_bits, ref_buffer, cfg.seed_encoding);
+		}
+		else if (query_seeds_bitset.get())
 			ref_idx = new SA(*cfg.target, ref_hst.get(sid), range, cfg.seedp_bits, ref_buffer, query_seeds_bitset.get(), enum_ref);
 		else if (query_seeds_hashed.get())
 			ref_idx = new SA(*cfg.target, ref_hst.get(sid), range, cfg.seedp_bits, ref_buffer, query_seeds_hashed.get(), enum_ref);
@@ -158,7 +164,7 @@ void search_shape(int sid, int query_block, unsigned query_iteration, char *quer
 		atomic<SeedPartition> seedp(0);
 		vector<std::thread> threads;
 		vector<DoubleArray<SeedLoc>> query_seed_hits(range.size()), ref_seed_hits(range.size());
-		for (int i = 0; i < config.threads_; ++i)
+		for (int i = 0; i < cfg.search_threads; ++i)
 			threads.emplace_back(seed_join_worker<SeedLoc>, query_idx, ref_idx, &seedp, range.size(), query_seed_hits.data(), ref_seed_hits.data());
 		for (auto &t : threads)
 			t.join();
@@ -193,7 +199,7 @@ void search_shape(int sid, int query_block, unsigned query_iteration, char *quer
 		seedp = 0;
 		threads.clear();
 		vector<thread::id> search_workers;
-		for (int i = 0; i < config.threads_; ++i)
+		for (int i = 0; i < cfg.search_threads; ++i)
 			search_workers.push_back(cfg.search_pool.spawn(search_worker<SeedLoc>, &seedp, range.size(), sid, i, query_seed_hits.data(), ref_seed_hits.data(), context, &cfg));
 		try {
 			cfg.search_pool.join(search_workers.begin(), search_workers.end());
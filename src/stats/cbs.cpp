@@ -17,14 +17,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <mutex>
+#include <unordered_map>
+#include <list>
+#include <cmath>
 #include "cbs.h"
 #include "basic/config.h"
 #include "score_matrix.h"
 #include "util/log_stream.h"
+#include "util/hash_function.h"
 
 using std::array;
 using std::runtime_error;
 using std::vector;
+using std::mutex;
+using std::lock_guard;
 
 namespace Stats {
 
@@ -69,6 +76,21 @@ Composition composition(const Sequence& s) {
     return r;
 }
 
+Composition composition(const uint16_t* aa_counts) {
+    Composition r;
+    const int n = count_true_aa(aa_counts);
+    for (int i = 0; i < TRUE_AA; ++i)
+        r[i] = n == 0 ? 0.0 : (MatrixFloat)aa_counts[i] / n;
+    return r;
+}
+
+int count_true_aa(const uint16_t* aa_counts) {
+    int n = 0;
+    for (int i = 0; i < TRUE_AA; ++i)
+        n += aa_counts[i];
+    return n;
+}
+
 int count_true_aa(const Sequence& s) {
     int n = 0;
     for (Loc i = 0; i < s.length(); ++i)
@@ -87,6 +109,101 @@ bool use_seg_masking(const Sequence& a, const Sequence& b) {
     return n != a.length();
 }
 
+struct MatrixAdjustCache::Shard {
+
+    using Key = array<uint32_t, 2 * TRUE_AA + 2>;
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = 0;
+            for (uint32_t x : k)
+                h = MurmurHash()(h ^ x);
+            return (size_t)h;
+        }
+    };
+
+    using Lru = std::list<std::pair<Key, Matrix>>;
+
+    mutex mtx;
+    Lru lru;
+    std::unordered_map<Key, Lru::iterator, KeyHash> map;
+
+};
+
+MatrixAdjustCache::MatrixAdjustCache(int64_t capacity, int steps, int scale, MatrixFloat lambda, const MatrixFloat* joint_probs, const MatrixFloat* background_freqs) :
+    steps_(steps),
+    scale_(scale),
+    shard_capacity_(std::max(capacity / SHARDS, (int64_t)1)),
+    lambda_(lambda),
+    joint_probs_(joint_probs),
+    background_freqs_(background_freqs),
+    shards_(new Shard[SHARDS])
+{}
+
+MatrixAdjustCache::~MatrixAdjustCache() {}
+
+int MatrixAdjustCache::length_bin(int len) {
+    int shift = 0;
+    while ((len >> shift) >= (1 << LENGTH_BITS))
+        ++shift;
+    if (shift == 0)
+        return len;
+    const int half = 1 << (shift - 1);
+    return ((len + half) >> shift) << shift;
+}
+
+void MatrixAdjustCache::get(int query_len, int target_len, const Composition& query_comp, const Composition& target_comp, Matrix& out, Statistics& stats) {
+    Shard::Key key;
+    for (int i = 0; i < TRUE_AA; ++i) {
+        key[i] = (uint32_t)std::lround(query_comp[i] * steps_);
+        key[TRUE_AA + i] = (uint32_t)std::lround(target_comp[i] * steps_);
+    }
+    key[2 * TRUE_AA] = length_bin(query_len);
+    key[2 * TRUE_AA + 1] = length_bin(target_len);
+    Shard& shard = shards_[Shard::KeyHash()(key) % SHARDS];
+    {
+        lock_guard<mutex> lock(shard.mtx);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            out = it->second->second;
+            stats.inc(Statistics::MATRIX_ADJUST_CACHE_HITS);
+            return;
+        }
+    }
+    Composition qc, tc;
+    uint32_t qn = 0, tn = 0;
+    for (int i = 0; i < TRUE_AA; ++i) {
+        qn += key[i];
+        tn += key[TRUE_AA + i];
+    }
+    for (int i = 0; i < TRUE_AA; ++i) {
+        qc[i] = qn == 0 ? 0.0 : (MatrixFloat)key[i] / qn;
+        tc[i] = tn == 0 ? 0.0 : (MatrixFloat)key[TRUE_AA + i] / tn;
+    }
+    CompositionMatrixAdjust(key[2 * TRUE_AA], key[2 * TRUE_AA + 1], qc.data(), tc.data(), scale_, lambda_, joint_probs_, background_freqs_, out, stats);
+    stats.inc(Statistics::MATRIX_ADJUST_CACHE_MISSES);
+    stats.inc(Statistics::MATRIX_ADJUST_COUNT);
+    lock_guard<mutex> lock(shard.mtx);
+    if (shard.map.find(key) != shard.map.end())
+        return;
+    if ((int64_t)shard.map.size() >= shard_capacity_) {
+        shard.map.erase(shard.lru.back().first);
+        shard.lru.pop_back();
+    }
+    shard.lru.emplace_front(key, out);
+    shard.map.emplace(key, shard.lru.begin());
+}
+
+static void compute_adjusted_matrix(int query_len, int target_len, const Composition& query_comp, const Composition& target_comp, array<int, AMINO_ACID_COUNT * AMINO_ACID_COUNT>& out, Statistics& stats) {
+    if (MatrixAdjustCache* cache = score_matrix.matrix_adjust_cache()) {
+        cache->get(query_len, target_len, query_comp, target_comp, out, stats);
+        return;
+    }
+    CompositionMatrixAdjust(query_len, target_len, query_comp.data(), target_comp.data(), config.cbs_matrix_scale, score_matrix.ideal_lambda(), score_matrix.joint_probs(), score_matrix.background_freqs(), out, stats);
+    stats.inc(Statistics::MATRIX_ADJUST_COUNT, 1);
+}
+
 int TargetMatrix::score_width() const {
     return (score_max > SCHAR_MAX || score_min < SCHAR_MIN) ? 1 : 0;
 }
@@ -97,9 +214,14 @@ EMatrixAdjustRule adjust_matrix(const Composition& query_comp, int query_len, un
 
     //Masking::get()(target_seq.data(), target_seq.size(), Masking::Algo::SEG);
 
-    const auto c = composition(target);
+    return adjust_matrix(query_comp, query_len, cbs, target.length(), composition(target));
+}
+
+EMatrixAdjustRule adjust_matrix(const Composition& query_comp, int query_len, unsigned cbs, Loc target_len, const Composition& c) {
+    if (!CBS::matrix_adjust(cbs) || target_len == 0 || query_len == 0)
+        return eDontAdjustMatrix;
     if (CBS::conditioned(cbs)) {
-        const EMatrixAdjustRule rule = s_TestToApplyREAdjustmentConditional(query_len, (int)target.length(), query_comp.data(), c.data(), score_matrix.background_freqs());
+        const EMatrixAdjustRule rule = s_TestToApplyREAdjustmentConditional(query_len, (int)target_len, query_comp.data(), c.data(), score_matrix.background_freqs());
         if (cbs == CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST)
             return rule;
         else
@@ -110,13 +232,16 @@ EMatrixAdjustRule adjust_matrix(const Composition& query_comp, int query_len, un
 }
 
 TargetMatrix::TargetMatrix(const Composition& query_comp, int query_len, unsigned cbs, const Sequence& target, Statistics& stats, std::pmr::monotonic_buffer_resource& pool, EMatrixAdjustRule rule) :
+    TargetMatrix(query_comp, query_len, cbs, composition(target), count_true_aa(target), stats, pool, rule)
+{}
+
+TargetMatrix::TargetMatrix(const Composition& query_comp, int query_len, unsigned cbs, const Composition& c, int target_true_aa, Statistics& stats, std::pmr::monotonic_buffer_resource& pool, EMatrixAdjustRule rule) :
     scores(&pool)
 {
     TaskTimer timer;
     
     //Masking::get()(target_seq.data(), target_seq.size(), Masking::Algo::SEG);
 
-    const auto c = composition(target);
     scores.resize(32 * AMINO_ACID_COUNT);
     //scores32.resize(32 * AMINO_ACID_COUNT);
     score_min = INT_MAX;
@@ -130,14 +255,12 @@ TargetMatrix::TargetMatrix(const Composition& query_comp, int query_len, unsigne
         //throw std::runtime_error("Unsupported CBS code: " + std::to_string(cbs));
         //s = hauser_global(query_comp, c);
     //else
-    if (rule == eUserSpecifiedRelEntropy) {
-        CompositionMatrixAdjust(query_len, count_true_aa(target), query_comp.data(), c.data(), config.cbs_matrix_scale, score_matrix.ideal_lambda(), score_matrix.joint_probs(), score_matrix.background_freqs(), s, stats);
-        stats.inc(Statistics::MATRIX_ADJUST_COUNT, 1);
-    }
+    if (rule == eUserSpecifiedRelEntropy)
+        compute_adjusted_matrix(query_len, target_true_aa, query_comp, c, s, stats);
     else if (rule == eCompoScaleOldMatrix) {
         if (!CompositionBasedStats(score_matrix.matrix32_scaled_pointers().data(), query_comp, c, score_matrix.ungapped_lambda(), score_matrix.freq_ratios(), s)) {
             stats.inc(Statistics::FAILED_COMP_BASED_STATS, 1);
-            CompositionMatrixAdjust(query_len, count_true_aa(target), query_comp.data(), c.data(), config.cbs_matrix_scale, score_matrix.ideal_lambda(), score_matrix.joint_probs(), score_matrix.background_freqs(), s, stats);
+            CompositionMatrixAdjust(query_len, target_true_aa, query_comp.data(), c.data(), config.cbs_matrix_scale, score_matrix.ideal_lambda(), score_matrix.joint_probs(), score_matrix.background_freqs(), s, stats);
         }
         else
             stats.inc(Statistics::COMP_BASED_STATS_COUNT, 1);
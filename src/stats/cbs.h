@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <array>
+#include <memory>
 #include <vector>
 #include "util/memory/memory_resource.h"
 #include "basic/sequence.h"
@@ -32,6 +33,7 @@ namespace Stats {
 using Composition = std::array<MatrixFloat, TRUE_AA>;
 
 Composition composition(const Sequence& s);
+Composition composition(const uint16_t* aa_counts);
 
 /** An collection of constants that specify all rules that may
  *  be used to generate a compositionally adjusted matrix.  */
@@ -47,6 +49,7 @@ typedef enum EMatrixAdjustRule {
 struct TargetMatrix {
 
     TargetMatrix(const Composition& query_comp, int query_len, unsigned cbs, const Sequence& target, Statistics& stats, std::pmr::monotonic_buffer_resource& pool, EMatrixAdjustRule rule);
+    TargetMatrix(const Composition& query_comp, int query_len, unsigned cbs, const Composition& target_comp, int target_true_aa, Statistics& stats, std::pmr::monotonic_buffer_resource& pool, EMatrixAdjustRule rule);
     int score_width() const;
 
     std::pmr::vector<int8_t> scores;
@@ -85,6 +88,7 @@ typedef struct Blast_MatrixInfo {
 } Blast_MatrixInfo;
 
 EMatrixAdjustRule adjust_matrix(const Composition& query_comp, int query_len, unsigned cbs, const Sequence& target);
+EMatrixAdjustRule adjust_matrix(const Composition& query_comp, int query_len, unsigned cbs, Loc target_len, const Composition& target_comp);
 void Blast_FreqRatioToScore(MatrixFloat** matrix, size_t rows, size_t cols, MatrixFloat Lambda);
 void s_RoundScoreMatrix(int** matrix, size_t rows, size_t cols, MatrixFloat** floatScoreMatrix);
 int s_GetMatrixScoreProbs(MatrixFloat** scoreProb, int* obs_min, int* obs_max,
@@ -95,6 +99,7 @@ MatrixFloat s_CalcLambda(MatrixFloat probs[], int min_score, int max_score, Matr
 MatrixFloat ideal_lambda(const int** matrix);
 void s_SetXUOScores(MatrixFloat** M, int alphsize, const MatrixFloat row_probs[], const MatrixFloat col_probs[]);
 int count_true_aa(const Sequence& s);
+int count_true_aa(const uint16_t* aa_counts);
 // bool use_seg_masking(const Sequence& a, const Sequence& b);
 
 EMatrixAdjustRule
@@ -200,6 +205,34 @@ struct CBS {
     double angle;
 };
 
+// Cache of composition adjusted matrices (--matrix-adjust-cache), owned by the ScoreMatrix whose parameters and
+// --cbs-matrix-scale it was created with. Keys are both compositions rounded to multiples of 1/steps and both lengths
+// rounded to LENGTH_BITS significant bits, i.e. with a relative error of at most 2^-LENGTH_BITS. The matrix for a key
+// is computed from the rounded values, so it does not depend on which query-target pair first produced the key.
+// A full shard evicts its least recently used entry.
+struct MatrixAdjustCache {
+
+    static constexpr int SHARDS = 64;
+    static constexpr int LENGTH_BITS = 7;
+    using Matrix = std::array<int, AMINO_ACID_COUNT * AMINO_ACID_COUNT>;
+
+    MatrixAdjustCache(int64_t capacity, int steps, int scale, MatrixFloat lambda, const MatrixFloat* joint_probs, const MatrixFloat* background_freqs);
+    ~MatrixAdjustCache();
+    void get(int query_len, int target_len, const Composition& query_comp, const Composition& target_comp, Matrix& out, Statistics& stats);
+    static int length_bin(int len);
+
+private:
+
+    struct Shard;
+
+    const int steps_, scale_;
+    const int64_t shard_capacity_;
+    const MatrixFloat lambda_;
+    const MatrixFloat* joint_probs_, * background_freqs_;
+    std::unique_ptr<Shard[]> shards_;
+
+};
+
 void CompositionMatrixAdjust(int query_len, int target_len, const MatrixFloat* query_comp, const MatrixFloat* target_comp, int scale, MatrixFloat ungapped_lambda, const MatrixFloat* joint_probs, const MatrixFloat* background_freqs, std::array<int, AMINO_ACID_COUNT * AMINO_ACID_COUNT>& out, Statistics& stats);
 bool CompositionBasedStats(const int* const* matrix_in, const Composition& queryProb, const Composition& resProb, double lambda, const FreqRatios& freq_ratios, std::array<int, AMINO_ACID_COUNT* AMINO_ACID_COUNT>& out);
 std::vector<int> hauser_global(const Composition& query_comp, const Composition& target_comp);
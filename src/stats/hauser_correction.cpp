@@ -27,7 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 using std::array;
 using std::vector;
 
-static const int PADDING = 32;
+static const int PADDING = 64;
 
 struct VectorScores
 {
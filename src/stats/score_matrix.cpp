@@ -89,6 +89,10 @@ int8_t ScoreMatrix::high_score() const
 	return high;
 }
 
+void ScoreMatrix::init_matrix_adjust_cache(int64_t capacity, int steps) {
+	matrix_adjust_cache_.reset(new Stats::MatrixAdjustCache(capacity, steps, (int)scale_, ideal_lambda_, joint_probs(), background_freqs()));
+}
+
 double ScoreMatrix::avg_id_score() const
 {
 	double s = 0;
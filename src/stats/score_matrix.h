@@ -22,12 +22,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <ostream>
 #include <math.h>
 #include <stdint.h>
+#include <memory>
 #include "basic/value.h"
 #include "alp/sls_alignment_evaluer.hpp"
 #include "stats/standard_matrix.h"
 
 const double LN_2 = 0.69314718055994530941723212145818;
 
+namespace Stats {
+	struct MatrixAdjustCache;
+}
+
 template<typename T>
 struct Scores
 {
@@ -223,6 +228,12 @@ struct ScoreMatrix
 
 	double avg_id_score() const;
 	bool report_cutoff(int score, double evalue) const;
+	// Enables the cache of composition adjusted matrices for this matrix and scale (--matrix-adjust-cache).
+	void init_matrix_adjust_cache(int64_t capacity, int steps);
+
+	Stats::MatrixAdjustCache* matrix_adjust_cache() const {
+		return matrix_adjust_cache_.get();
+	}
 
 private:
 
@@ -245,6 +256,7 @@ private:
 	Scores<int16_t> matrix16_;
 	std::array<double, TRUE_AA> background_scores_;
 	Sls::AlignmentEvaluer evaluer;
+	std::shared_ptr<Stats::MatrixAdjustCache> matrix_adjust_cache_;
 
 };
 
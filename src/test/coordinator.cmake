@@ -0,0 +1,50 @@
+# Runs a parallel linclust with a coordinator process and two workers on this machine.
+set(TMP_DIR "${CMAKE_CURRENT_BINARY_DIR}/coordinator_tmp")
+set(SOCKET "${TMP_DIR}/coordinator.sock")
+set(CLUSTERS_FILE "${TMP_DIR}/clusters.tsv")
+set(ENV{DIAMOND_COORDINATOR_TOKEN} "ctest-coordinator")
+
+if(MODE STREQUAL "workers")
+  set(WORKER ./diamond linclust -d ${TEST_DIR}/nr_300.faa -p1 --approx-id 0 --parallel-tmpdir ${TMP_DIR} --coordinator ${SOCKET} -o ${CLUSTERS_FILE})
+  execute_process(COMMAND ${WORKER} COMMAND ${WORKER} RESULTS_VARIABLE WORKER_RESULTS)
+  # Stop the coordinator also if a worker failed, so that the test does not hang.
+  execute_process(COMMAND ./diamond coordinator --coordinator ${SOCKET} --shutdown RESULT_VARIABLE SHUTDOWN_RESULT)
+  if(NOT WORKER_RESULTS STREQUAL "0;0" OR NOT SHUTDOWN_RESULT EQUAL 0)
+    message(FATAL_ERROR "coordinator workers failed: ${WORKER_RESULTS}, shutdown: ${SHUTDOWN_RESULT}.")
+  endif()
+  return()
+endif()
+
+file(REMOVE_RECURSE "${TMP_DIR}")
+file(MAKE_DIRECTORY "${TMP_DIR}")
+
+execute_process(COMMAND ./diamond coordinator --coordinator ${SOCKET}
+  COMMAND ${CMAKE_COMMAND} -DMODE=workers -DTEST_DIR=${TEST_DIR} -P ${CMAKE_CURRENT_LIST_FILE}
+  RESULTS_VARIABLE RESULTS)
+if(NOT RESULTS STREQUAL "0;0")
+  message(FATAL_ERROR "coordinator test failed: ${RESULTS}.")
+endif()
+
+# Every input sequence is assigned to exactly one cluster.
+file(STRINGS "${TEST_DIR}/nr_300.faa" HEADERS REGEX "^>")
+set(EXPECTED "")
+foreach(H IN LISTS HEADERS)
+  string(REGEX REPLACE "^>([^ \t]+).*" "\\1" ID "${H}")
+  list(APPEND EXPECTED "${ID}")
+endforeach()
+file(STRINGS "${CLUSTERS_FILE}" LINES)
+set(MEMBERS "")
+foreach(LINE IN LISTS LINES)
+  string(REPLACE "\t" ";" FIELDS "${LINE}")
+  list(GET FIELDS 1 MEMBER_ID)
+  list(APPEND MEMBERS "${MEMBER_ID}")
+endforeach()
+list(SORT EXPECTED)
+list(SORT MEMBERS)
+if(NOT MEMBERS STREQUAL EXPECTED)
+  list(LENGTH EXPECTED N_EXPECTED)
+  list(LENGTH MEMBERS N_MEMBERS)
+  message(FATAL_ERROR "coordinator test expected ${N_EXPECTED} clustered sequences, got ${N_MEMBERS}.")
+endif()
+
+file(REMOVE_RECURSE "${TMP_DIR}")
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <limits>
 #include <stdexcept>
+#include <chrono>
 #include "basic/config.h"
 #include "search/hit_buffer.h"
 #include "basic/config.h"
@@ -36,19 +37,22 @@ static uint64_t hit_fp(uint32_t query, uint64_t subject, uint32_t seed_offset, u
 		 + (uint64_t)score       *  668265261ULL;
 }
 
+enum class HitBufferMode { MEMBUF, DISK, COMPRESSED };
+
 struct HitBufferTestResult {
 	bool   passed;
+	double write_seconds;
+	double load_seconds;
 	size_t expected_hits;
 	size_t actual_hits;
 	uint64_t expected_checksum;
 	uint64_t actual_checksum;
 };
 
-static HitBufferTestResult run_single_mode(bool membuf_mode)
+static HitBufferTestResult run_single_mode(HitBufferMode mode, const int QUERIES_PER_BIN)
 {
 	static constexpr int      BIN_COUNT       = 32;
-	static constexpr int      QUERIES_PER_BIN = 1000;
-	static constexpr int      QUERY_COUNT     = BIN_COUNT * QUERIES_PER_BIN;
+	const int                 QUERY_COUNT     = BIN_COUNT * QUERIES_PER_BIN;
 	static constexpr int      HITS_PER_QUERY  = 11;
 	static constexpr uint64_t TARGET_LEN      = 50000; // subject locs drawn from [1, TARGET_LEN]
 	static constexpr int      THREAD_COUNT    = BIN_COUNT; // one writer thread per bin
@@ -58,8 +62,10 @@ static HitBufferTestResult run_single_mode(bool membuf_mode)
 	const uint64_t max_target = TARGET_LEN + 1;
 	const bool saved_membuf = config.trace_pt_membuf;
 	const bool saved_swipe  = config.swipe_all;
-	config.trace_pt_membuf  = membuf_mode;
+	const std::string saved_mem = config.hit_buffer_mem;
+	config.trace_pt_membuf  = mode == HitBufferMode::MEMBUF;
 	config.swipe_all        = false;
+	config.hit_buffer_mem   = mode == HitBufferMode::COMPRESSED ? "1000G" : "";
 	std::vector<uint32_t> key_partition;
 	for (int i = 1; i <= BIN_COUNT; ++i)
 		key_partition.push_back(uint32_t(i * QUERIES_PER_BIN));
@@ -71,6 +77,7 @@ static HitBufferTestResult run_single_mode(bool membuf_mode)
 		max_query, max_target, search_pool);
 
 	std::atomic<uint64_t> expected_cs{ 0 };
+	auto t0 = std::chrono::steady_clock::now();
 	{
 		std::vector<std::thread> writers;
 		writers.reserve(THREAD_COUNT);
@@ -99,6 +106,7 @@ static HitBufferTestResult run_single_mode(bool membuf_mode)
 	}
 
 	buf.finish_writing();
+	auto t1 = std::chrono::steady_clock::now();
 	buf.alloc_buffer();
 
 	size_t   actual_total = 0;
@@ -122,29 +130,33 @@ static HitBufferTestResult run_single_mode(bool membuf_mode)
 	}
 
 	buf.free_buffer();
+	auto t2 = std::chrono::steady_clock::now();
 
 	config.trace_pt_membuf = saved_membuf;
 	config.swipe_all       = saved_swipe;
+	config.hit_buffer_mem  = saved_mem;
 
 	const size_t   expected_total = (size_t)QUERY_COUNT * HITS_PER_QUERY;
 	const uint64_t expected_sum   = expected_cs.load();
 	const bool passed = (actual_total == expected_total) && (actual_cs == expected_sum);
-	return { passed, expected_total, actual_total, expected_sum, actual_cs };
+	return { passed, std::chrono::duration<double>(t1 - t0).count(), std::chrono::duration<double>(t2 - t1).count(),
+		expected_total, actual_total, expected_sum, actual_cs };
 }
 
-int run_hit_buffer_stress_test()
+int run_hit_buffer_stress_test(int queries_per_bin)
 {
 	std::cout << "\nHitBuffer stress test" << std::endl;
 	std::cout << "=====================" << std::endl;
 	std::cout << "Threads = " << config.threads_ << std::endl;
 
 	int failures = 0;
-	for (bool membuf : { true, false }) {
-		const char* mode = membuf ? "in-memory (membuf)" : "disk";
+	const HitBufferMode modes[] = { HitBufferMode::MEMBUF, HitBufferMode::DISK, HitBufferMode::COMPRESSED };
+	for (HitBufferMode m : modes) {
+		const char* mode = m == HitBufferMode::MEMBUF ? "in-memory (membuf)" : (m == HitBufferMode::DISK ? "disk" : "compressed in-memory");
 		std::cout << "  Mode: " << mode << " ... " << std::flush;
 		HitBufferTestResult r;
 		try {
-			r = run_single_mode(membuf);
+			r = run_single_mode(m, queries_per_bin);
 		}
 		catch (const std::exception& e) {
 			std::cout << "EXCEPTION: " << e.what() << std::endl;
@@ -153,7 +165,9 @@ int run_hit_buffer_stress_test()
 		}
 		if (r.passed) {
 			std::cout << "PASSED"
-				<< " (" << r.actual_hits << " hits, checksum ok)" << std::endl;
+				<< " (" << r.actual_hits << " hits, checksum ok)"
+				<< "\n    write: " << r.actual_hits / r.write_seconds / 1e6 << " Mhits/s"
+				<< ", load: " << r.actual_hits / r.load_seconds / 1e6 << " Mhits/s" << std::endl;
 		}
 		else {
 			std::cout << "FAILED"
@@ -166,7 +180,7 @@ int run_hit_buffer_stress_test()
 	}
 
 	std::cout << "  Result: "
-		<< (2 - failures) << "/2 passed" << std::endl;
+		<< (3 - failures) << "/3 passed" << std::endl;
 	std::cout << "=====================" << std::endl;
 	return failures;
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+# Runs two query batches against a --serve process and compares them to a regular search.
+if(NOT BIN_DIR)
+  set(BIN_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+endif()
+set(TMP_DIR "${BIN_DIR}/serve_tmp")
+set(DIAMOND "${BIN_DIR}/diamond")
+set(SOCKET "${TMP_DIR}/serve.sock")
+set(OPTIONS -d ${TEST_DIR}/nr_300.faa -p1 -c1 -b0.00005 --algo 0 -f 6)
+
+if(MODE STREQUAL "client")
+  foreach(I RANGE 600)
+    if(EXISTS "${SOCKET}")
+      break()
+    endif()
+    execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 0.1)
+  endforeach()
+  execute_process(COMMAND ${DIAMOND} blastp --serve ${SOCKET} --serve-query -q ${TEST_DIR}/nr_300.faa -o ${TMP_DIR}/batch1.tsv RESULT_VARIABLE RESULT1)
+  execute_process(COMMAND ${DIAMOND} blastp --serve ${SOCKET} --serve-query -q ${TEST_DIR}/nr_300.faa -o ${TMP_DIR}/batch2.tsv RESULT_VARIABLE RESULT2)
+  # The server polls for the stop file, so no further connection is needed to shut it down.
+  file(TOUCH "${TMP_DIR}/stop")
+  if(NOT RESULT1 EQUAL 0 OR NOT RESULT2 EQUAL 0)
+    message(FATAL_ERROR "serve queries failed: ${RESULT1}, ${RESULT2}.")
+  endif()
+  return()
+endif()
+
+file(REMOVE_RECURSE "${TMP_DIR}")
+file(MAKE_DIRECTORY "${TMP_DIR}")
+
+execute_process(COMMAND ${DIAMOND} blastp ${OPTIONS} --serve ${SOCKET}
+  COMMAND ${CMAKE_COMMAND} -DMODE=client -DTEST_DIR=${TEST_DIR} -DBIN_DIR=${BIN_DIR} -P ${CMAKE_CURRENT_LIST_FILE}
+  WORKING_DIRECTORY ${TMP_DIR}
+  RESULTS_VARIABLE RESULTS)
+if(NOT RESULTS STREQUAL "0;0")
+  message(FATAL_ERROR "serve test failed: ${RESULTS}.")
+endif()
+
+execute_process(COMMAND ${DIAMOND} blastp ${OPTIONS} -q ${TEST_DIR}/nr_300.faa -o ${TMP_DIR}/expected.tsv RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "blastp failed: ${RESULT}.")
+endif()
+
+file(READ "${TMP_DIR}/expected.tsv" EXPECTED)
+foreach(BATCH batch1 batch2)
+  file(READ "${TMP_DIR}/${BATCH}.tsv" OUTPUT)
+  if(EXPECTED STREQUAL "")
+    message(FATAL_ERROR "serve test: empty reference output.")
+  endif()
+  if(NOT OUTPUT STREQUAL EXPECTED)
+    message(FATAL_ERROR "serve test: ${BATCH} differs from a regular search.")
+  endif()
+endforeach()
+
+file(REMOVE_RECURSE "${TMP_DIR}")
@@ -19,11 +19,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <stdexcept>
+#include <cstdlib>
 #include "cluster/multinode/len_sort.h"
+#include "util/algo/algo.h"
+#include "util/io/compressor.h"
+#include "util/io/temp_file.h"
+#include "util/io/file.h"
+#include "legacy/dmnd/io.h"
+#include "util/algo/external_sort.h"
+#include "data/accession_index.h"
+#include "stats/cbs.h"
+#include "stats/score_matrix.h"
 
 int run_queue_stress_test();
-int run_hit_buffer_stress_test();
+int run_hit_buffer_stress_test(int queries_per_bin = 1000);
 void filestack();
+FlatArray<Util::Algo::Edge<uint32_t>> random_cluster_graph(uint32_t node_count, int avg_degree, uint32_t seed);
 
 namespace Test {
 
@@ -51,9 +62,207 @@ static void block_combo_chunk_sizes() {
 	require(block_combo_chunk_size(1024000000000, 1109673588218) == 1110.0, "Expected generated PSC block to fit without re-chunking.");
 }
 
+static void parallel_vertex_cover() {
+	const FlatArray<Util::Algo::Edge<uint32_t>> graph = random_cluster_graph(20000, 8, 1);
+	FlatArray<Util::Algo::Edge<uint32_t>> g = graph;
+	const std::vector<uint32_t> c1 = Util::Algo::parallel_greedy_vertex_cover(g, 1, (const uint32_t*)nullptr, false, false);
+	g = graph;
+	const std::vector<uint32_t> c4 = Util::Algo::parallel_greedy_vertex_cover(g, 4, (const uint32_t*)nullptr, false, false);
+	require(c1 == c4, "Expected the parallel vertex cover to be independent of the thread count.");
+	for (uint32_t i = 0; i < graph.size(); ++i) {
+		const uint32_t rep = c1[i];
+		require(rep < graph.size() && c1[rep] == rep, "Expected every node to be assigned to a representative.");
+		if (rep != i)
+			require(std::any_of(graph.cbegin(rep), graph.cend(rep), [i](const Util::Algo::Edge<uint32_t>& e) { return e.node2 == i; }),
+				"Expected members to be neighbors of their representative.");
+	}
+}
+
+static std::vector<char> text_data(size_t size) {
+	std::vector<char> data(size);
+	uint32_t x = 1;
+	for (char& c : data) {
+		x = x * 1103515245 + 12345;
+		c = "ACGT\t\n"[(x >> 16) % 6];
+	}
+	return data;
+}
+
+static std::vector<char> read_all(Decompressor& decompressor, FILE* f, size_t size) {
+	std::rewind(f);
+	std::vector<char> out(size + 1);
+	const size_t n = decompressor.fread(out.data(), 1, out.size(), f);
+	decompressor.close();
+	fclose(f);
+	out.resize(n);
+	return out;
+}
+
+static FILE* parallel_compress(CompressionLib lib, const std::vector<char>& data) {
+	FILE* f = tmpfile();
+	require(f != nullptr, "Failed to open temporary file.");
+	ParallelCompressor compressor(lib, 4);
+	for (size_t i = 0; i < data.size(); i += 100000)
+		compressor.fwrite(data.data() + i, 1, std::min((size_t)100000, data.size() - i), f);
+	compressor.close(f);
+	return f;
+}
+
+// Writes the data as BGZF, i.e. gzip members of at most 64 KB carrying their size in the extra field.
+static FILE* bgzf_compress(const std::vector<char>& data) {
+	FILE* f = tmpfile();
+	require(f != nullptr, "Failed to open temporary file.");
+	std::vector<unsigned char> buf(1 << 17);
+	for (size_t i = 0; i < data.size(); i += 60000) {
+		const size_t n = std::min((size_t)60000, data.size() - i);
+		z_stream strm{};
+		require(deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK, "deflateInit2 failed.");
+		strm.next_in = (Bytef*)data.data() + i;
+		strm.avail_in = (uInt)n;
+		strm.next_out = buf.data() + 18;
+		strm.avail_out = (uInt)buf.size() - 26;
+		require(deflate(&strm, Z_FINISH) == Z_STREAM_END, "deflate failed.");
+		const size_t size = 18 + strm.total_out + 8;
+		deflateEnd(&strm);
+		const unsigned char header[18] = { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, (unsigned char)((size - 1) & 0xff), (unsigned char)((size - 1) >> 8) };
+		std::copy(header, header + 18, buf.begin());
+		const uint32_t crc = (uint32_t)crc32(0, (const Bytef*)data.data() + i, (uInt)n);
+		for (int j = 0; j < 4; ++j) {
+			buf[size - 8 + j] = (unsigned char)(crc >> (8 * j));
+			buf[size - 4 + j] = (unsigned char)(n >> (8 * j));
+		}
+		require(fwrite(buf.data(), 1, size, f) == size, "Failed to write temporary file.");
+	}
+	return f;
+}
+
+// Checks that each gzip member written by ParallelCompressor carries its size, which is what allows
+// ParallelDecompressor to split the stream.
+static void check_member_sizes(FILE* f) {
+	std::rewind(f);
+	std::vector<unsigned char> buf;
+	unsigned char c[4096];
+	size_t n;
+	while ((n = fread(c, 1, sizeof(c), f)) > 0)
+		buf.insert(buf.end(), c, c + n);
+	size_t members = 0;
+	for (size_t i = 0; i < buf.size(); ++members) {
+		require(i + 20 <= buf.size() && buf[i] == 0x1f && buf[i + 1] == 0x8b && buf[i + 12] == GZIP_SIZE_SI1 && buf[i + 13] == GZIP_SIZE_SI2,
+			"Expected a gzip member with a size subfield.");
+		i += buf[i + 16] | (buf[i + 17] << 8) | (buf[i + 18] << 16) | ((size_t)buf[i + 19] << 24);
+	}
+	require(members == 3, "Expected one gzip member per block.");
+}
+
+static void parallel_compressor() {
+	const std::vector<char> data = text_data(2 * ParallelCompressor::block_size + 12345);
+	ZlibDecompressor zlib;
+	require(read_all(zlib, parallel_compress(CompressionLib::ZLIB, data), data.size()) == data, "Expected parallel gzip compression to round trip.");
+	FILE* members = parallel_compress(CompressionLib::ZLIB, data);
+	check_member_sizes(members);
+	fclose(members);
+	ParallelDecompressor pzlib(CompressionLib::ZLIB, 4);
+	require(read_all(pzlib, parallel_compress(CompressionLib::ZLIB, data), data.size()) == data, "Expected parallel gzip decompression to round trip.");
+	// Members without a size are decompressed by the reader thread after the split ones.
+	FILE* mixed = parallel_compress(CompressionLib::ZLIB, data);
+	std::fseek(mixed, 0, SEEK_END);
+	ZlibCompressor plain;
+	plain.fwrite(data.data(), 1, data.size(), mixed);
+	plain.close(mixed);
+	std::vector<char> twice(data);
+	twice.insert(twice.end(), data.begin(), data.end());
+	ParallelDecompressor pmixed(CompressionLib::ZLIB, 4);
+	require(read_all(pmixed, mixed, twice.size()) == twice, "Expected parallel decompression of mixed gzip members to round trip.");
+	ParallelDecompressor plain_only(CompressionLib::ZLIB, 4);
+	ZlibCompressor plain2;
+	FILE* single = tmpfile();
+	require(single != nullptr, "Failed to open temporary file.");
+	plain2.fwrite(data.data(), 1, data.size(), single);
+	plain2.close(single);
+	require(read_all(plain_only, single, data.size()) == data, "Expected parallel decompression of a single gzip member to round trip.");
+	ParallelDecompressor bgzf(CompressionLib::ZLIB, 4);
+	require(read_all(bgzf, bgzf_compress(data), data.size()) == data, "Expected parallel BGZF decompression to round trip.");
+#ifdef WITH_ZSTD
+	ZstdDecompressor zstd;
+	require(read_all(zstd, parallel_compress(CompressionLib::ZSTD, data), data.size()) == data, "Expected parallel zstd compression to round trip.");
+	ParallelDecompressor pzstd(CompressionLib::ZSTD, 4);
+	require(read_all(pzstd, parallel_compress(CompressionLib::ZSTD, data), data.size()) == data, "Expected parallel zstd decompression to round trip.");
+#endif
+}
+
+static void accession_index() {
+	ExternalSorter<AccessionIndex::T> accessions;
+	const std::vector<AccessionIndex::T> pairs = { { "XP_3.1", 2 }, { "A1", 0 }, { "XP_3.1", 1 }, { "B2", 3 }, { "A1", 0 }, { "XP_3", 1 } };
+	for (const AccessionIndex::T& p : pairs)
+		accessions.push(p);
+	std::string file_name;
+	{
+		TempFile out(false);
+		file_name = out.file_name();
+		out.write("garbage", 7);
+		out.close();
+	}
+	bool invalid = false;
+	try {
+		AccessionIndex garbage(file_name);
+	}
+	catch (std::runtime_error&) {
+		invalid = true;
+	}
+	require(invalid, "Expected an invalid accession index file to be rejected.");
+	AccessionIndex::write(file_name, accessions, 4, 100);
+	const AccessionIndex index(file_name, true);
+	require(index.matches(4, 100) && !index.matches(4, 101), "Expected accession index to match the database size.");
+	require(index.size() == 5, "Expected duplicate accession index entries to be merged.");
+	require(index.find("A1") == std::vector<OId>{ 0 }, "Expected accession A1 to map to OId 0.");
+	require(index.find("XP_3.1") == std::vector<OId>{ 1, 2 }, "Expected accession XP_3.1 to map to OIds 1 and 2.");
+	require(index.find("XP_3") == std::vector<OId>{ 1 }, "Expected accession XP_3 to map to OId 1.");
+	require(index.find("B2") == std::vector<OId>{ 3 }, "Expected accession B2 to map to OId 3.");
+	require(index.find("A").empty() && index.find("C").empty() && index.find("").empty(), "Expected missing accessions not to be found.");
+}
+
+static void matrix_adjust_cache() {
+	using Stats::MatrixAdjustCache;
+	for (int len = 1; len < 100000; len += 7) {
+		const int bin = MatrixAdjustCache::length_bin(len);
+		require(std::abs(bin - len) * (1 << MatrixAdjustCache::LENGTH_BITS) <= len, "Expected the length bin error to be bounded.");
+	}
+	require(MatrixAdjustCache::length_bin(100) == 100 && MatrixAdjustCache::length_bin(1001) == 1000, "Unexpected length bin.");
+
+	Stats::Composition query_comp, target_comp;
+	const MatrixFloat* bg = score_matrix.background_freqs();
+	double qn = 0.0, tn = 0.0;
+	for (int i = 0; i < TRUE_AA; ++i) {
+		query_comp[i] = bg[i] * (1.0 + 0.5 * ((i % 3) - 1));
+		target_comp[i] = bg[i] * (1.0 + 0.3 * ((i % 4) - 1.5));
+		qn += query_comp[i];
+		tn += target_comp[i];
+	}
+	for (int i = 0; i < TRUE_AA; ++i) {
+		query_comp[i] /= qn;
+		target_comp[i] /= tn;
+	}
+
+	Statistics stats;
+	MatrixAdjustCache cache(1000, 10000, 1, score_matrix.ideal_lambda(), score_matrix.joint_probs(), bg);
+	MatrixAdjustCache::Matrix cached, cached2, uncached;
+	cache.get(250, 1001, query_comp, target_comp, cached, stats);
+	cache.get(250, 1002, query_comp, target_comp, cached2, stats);
+	require(stats.get(Statistics::MATRIX_ADJUST_CACHE_MISSES) == 1 && stats.get(Statistics::MATRIX_ADJUST_CACHE_HITS) == 1, "Expected one matrix adjust cache miss and hit.");
+	require(cached == cached2, "Expected a cache hit to return the cached matrix.");
+	Stats::CompositionMatrixAdjust(250, 1001, query_comp.data(), target_comp.data(), 1, score_matrix.ideal_lambda(), score_matrix.joint_probs(), bg, uncached, stats);
+	for (int i = 0; i < TRUE_AA; ++i)
+		for (int j = 0; j < TRUE_AA; ++j)
+			require(std::abs(cached[i * AMINO_ACID_COUNT + j] - uncached[i * AMINO_ACID_COUNT + j]) <= 1, "Expected cached and uncached adjusted matrices to agree.");
+}
+
 int run() {
 	len_sort_block_limits();
 	block_combo_chunk_sizes();
+	parallel_vertex_cover();
+	parallel_compressor();
+	accession_index();
+	matrix_adjust_cache();
 	std::cerr << "Unit tests passed." << std::endl;
 	return 0;
 	//filestack();	
@@ -0,0 +1,101 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <vector>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "basic/config.h"
+#include "util/algo/algo.h"
+
+using std::vector;
+using std::endl;
+using Edge = Util::Algo::Edge<uint32_t>;
+
+// Random graph with a family structure similar to a sequence similarity graph: nodes are grouped
+// into families of random size, most edges connect members of the same family.
+FlatArray<Edge> random_cluster_graph(uint32_t node_count, int avg_degree, uint32_t seed) {
+	std::mt19937 rng(seed);
+	vector<uint32_t> family_begin(node_count);
+	std::geometric_distribution<uint32_t> family_size(0.02);
+	for (uint32_t i = 0; i < node_count;) {
+		const uint32_t n = std::min(family_size(rng) + 1, node_count - i);
+		for (uint32_t j = i; j < i + n; ++j)
+			family_begin[j] = i;
+		i += n;
+	}
+	std::poisson_distribution<int> degree(avg_degree);
+	std::uniform_real_distribution<double> weight(0.0, 100.0);
+	FlatArray<Edge> graph;
+	vector<Edge> v;
+	for (uint32_t i = 0; i < node_count; ++i) {
+		const uint32_t b = family_begin[i];
+		uint32_t e = i;
+		while (e < node_count && family_begin[e] == b)
+			++e;
+		v.clear();
+		const int d = degree(rng);
+		for (int j = 0; j < d; ++j) {
+			const uint32_t k = j % 8 == 7 ? uint32_t(rng() % node_count) : b + uint32_t(rng() % (e - b));
+			if (k != i)
+				v.emplace_back(i, k, weight(rng));
+		}
+		std::sort(v.begin(), v.end());
+		v.erase(std::unique(v.begin(), v.end(), [](const Edge& x, const Edge& y) { return x.node2 == y.node2; }), v.end());
+		graph.push_back(v.begin(), v.end());
+	}
+	return graph;
+}
+
+void run_vertex_cover_benchmark(uint32_t node_count, int avg_degree) {
+	using std::chrono::high_resolution_clock;
+	const FlatArray<Edge> graph = random_cluster_graph(node_count, avg_degree, 1);
+	std::cout << "\nVertex cover scaling benchmark" << endl;
+	std::cout << "Nodes = " << graph.size() << ", edges = " << graph.data_size() << endl;
+
+	auto count_reps = [](const vector<uint32_t>& c) {
+		uint32_t n = 0;
+		for (uint32_t i = 0; i < c.size(); ++i)
+			n += c[i] == i;
+		return n;
+	};
+
+	FlatArray<Edge> g = graph;
+	auto t0 = high_resolution_clock::now();
+	const vector<uint32_t> serial = Util::Algo::greedy_vertex_cover(g);
+	const double serial_time = std::chrono::duration<double>(high_resolution_clock::now() - t0).count();
+	std::cout << "Serial:      " << serial_time << " s, clusters = " << count_reps(serial) << endl;
+
+	vector<uint32_t> reference;
+	vector<int> thread_counts;
+	for (int t = 1; t < config.threads_; t *= 2)
+		thread_counts.push_back(t);
+	thread_counts.push_back(std::max(config.threads_, 1));
+	for (int t : thread_counts) {
+		g = graph;
+		t0 = high_resolution_clock::now();
+		const vector<uint32_t> c = Util::Algo::parallel_greedy_vertex_cover(g, t);
+		const double time = std::chrono::duration<double>(high_resolution_clock::now() - t0).count();
+		if (reference.empty())
+			reference = c;
+		std::cout << "Parallel t=" << t << ": " << time << " s, speedup vs serial = " << serial_time / time
+			<< ", clusters = " << count_reps(c) << (c == reference ? "" : " (MISMATCH)") << endl;
+	}
+}
@@ -18,8 +18,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <chrono>
+#include <memory>
 #include <random>
 #include "util/memory/memory_resource.h"
+#include "util/memory/alloc_count.h"
+#include "util/memory/arena.h"
 #include "basic/sequence.h"
 #include "stats/score_matrix.h"
 #include "dp/score_vector.h"
@@ -38,13 +41,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/simd/dispatch.h"
 #include "dp/score_vector_int16.h"
 #include "search/hit_buffer.h"
+#include "search/hamming/kernel.h"
 
 using std::vector;
 using std::endl;
 using std::chrono::high_resolution_clock;
 using std::chrono::nanoseconds;
 using std::chrono::duration_cast;
-using std::list;
 using std::array;
 using namespace DISPATCH_ARCH;
 
@@ -59,49 +62,17 @@ static inline void transpose_scalar(const signed char **data, size_t n, signed c
 			out[y * WIDTH + x] = data[x + n - WIDTH][y];
 }
 
+int run_hit_buffer_stress_test(int queries_per_bin);
+void run_vertex_cover_benchmark(uint32_t node_count, int avg_degree);
+
 namespace Benchmark { namespace DISPATCH_ARCH {
 
 void hit_buffer() {
-	/*vector<uint32_t> part;
-	part.push_back(0);
-	for (int i = 0; i < 16; ++i)
-		part.push_back((i + 1) * (INT_MAX / 16));
-	Search::HitBuffer buf(part, config.tmpdir, false, 1, config.threads_);
-	TaskTimer timer("Fill");
-	size_t n = (30ll * 1024ll * 1024ll * 1024ll) / sizeof(Search::Hit);
-	auto worker = [&]() {
-		size_t m = n / config.threads_;
-		Search::HitBuffer::Writer* w = new Search::HitBuffer::Writer(buf, 0);
-		std::default_random_engine generator;
-		std::uniform_int_distribution<int> distribution(1, INT_MAX);
-		std::uniform_int_distribution<uint16_t> scored(1, std::numeric_limits<uint16_t>::max());
-		for (size_t i = 0; i < m;) {
-			w->new_query(distribution(generator), distribution(generator));
-			for (size_t j = 0; j < 100; ++j) {
-				if (i % 1000000 == 0)
-					printf("%zu/%zu\n", i, m);
-				w->write(distribution(generator), distribution(generator), scored(generator), distribution(generator));
-				++i;
-			}
-		}
-		delete w;
-		};
-	vector<std::thread> threads;
-	for(int i= 0; i < config.threads_; ++i)
-		threads.emplace_back(worker);
-	for(auto& t : threads) {
-		if (t.joinable())
-			t.join();
-	}
-	timer.go("Alloc");
-	buf.alloc_buffer();
-	timer.go("Read");
-	for (int i = 0; i < buf.bins(); ++i) {
-		//buf.load(INT64_MAX);
-		std::tuple<Search::Hit*, size_t, BlockId, BlockId> input = buf.retrieve();
-		printf("%i: %zd\n", i, std::get<1>(input));
-	}
-	buf.free_buffer();*/
+	run_hit_buffer_stress_test(20000);
+}
+
+void vertex_cover() {
+	run_vertex_cover_benchmark(1000000, 8);
 }
 
 #if defined(__SSE4_1__) && defined(EXTRA)
@@ -132,6 +103,40 @@ void benchmark_hamming(const Sequence& s1, const Sequence& s2) {
 }
 #endif*/
 
+#if defined(__SSE2__) | defined(__ARM_NEON)
+void hamming_stage1() {
+	static const uint_fast32_t n = 1024, reps = 50;
+	static const unsigned hamming_filter_id = 14;
+	std::mt19937 rng(1);
+	::Search::Container a(n), b(n);
+	for (auto& fp : a)
+		for (char& c : fp)
+			c = char(rng() % 4);
+	for (auto& fp : b)
+		for (char& c : fp)
+			c = char(rng() % 4);
+	HitField hits;
+
+	high_resolution_clock::time_point t1 = high_resolution_clock::now();
+	for (uint_fast32_t i = 0; i < reps; ++i) {
+		hits.init(n, n);
+		::Search::DISPATCH_ARCH::all_vs_all_generic(a.data(), n, b.data(), n, hits, hamming_filter_id);
+	}
+	*message_stream << "Stage 1 hamming filter:\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (reps * n * n) * 1000 << " ps/Comparison" << endl;
+
+#ifdef HAMMING_VPOPCNTDQ
+	if (::SIMD::supports(::SIMD::AVX512_VPOPCNTDQ)) {
+		t1 = high_resolution_clock::now();
+		for (uint_fast32_t i = 0; i < reps; ++i) {
+			hits.init(n, n);
+			::Search::DISPATCH_ARCH::all_vs_all_vpopcntdq(a.data(), n, b.data(), n, hits, hamming_filter_id);
+		}
+		*message_stream << "Stage 1 hamming (VPOPCNTDQ):\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (reps * n * n) * 1000 << " ps/Comparison" << endl;
+	}
+#endif
+}
+#endif
+
 void benchmark_ungapped(const Sequence& s1, const Sequence& s2)
 {
 	static const size_t n = 10000000llu;
@@ -241,7 +246,7 @@ void benchmark_transpose() {
         *message_stream << "Transpose (16x16, vectorized):\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t2).count() / (n * 16 * 16) * 1000 << " ps/Letter" << endl;
 
 
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 	{
 		static signed char in[32 * 32], out[32 * 32];
 		signed char* v[32];
@@ -287,8 +292,8 @@ void mt_swipe(const Sequence& s1, const Sequence& s2) {
 
 	auto f = [&]() {
 		for (size_t i = 0; i < n; ++i) {
-			//volatile list<Hsp> v = ::DP::BandedSwipe::ARCH_SSE4_1::swipe(targets, params);
-			volatile list<Hsp> v = ::DP::BandedSwipe::swipe(targets, params);
+			//volatile HspVector v = ::DP::BandedSwipe::ARCH_SSE4_1::swipe(targets, params);
+			volatile HspVector v = ::DP::BandedSwipe::swipe(targets, params);
 		}
 	};
 	using std::thread;
@@ -322,7 +327,7 @@ void swipe(const Sequence&s1, const Sequence&s2) {
 
 	high_resolution_clock::time_point t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(targets, params);
+		volatile HspVector v = ::DP::BandedSwipe::swipe(targets, params);
 	}
 	*message_stream << "SWIPE (int8_t):\t\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / dp_size * 1000 << " ps/Cell" << endl;
 
@@ -330,13 +335,13 @@ void swipe(const Sequence&s1, const Sequence&s2) {
 	targets[1] = targets[0];
 	targets[0].clear();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(targets, params);
+		volatile HspVector v = ::DP::BandedSwipe::swipe(targets, params);
 	}
 	*message_stream << "SWIPE (int16_t):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / dp_size * 1000 << " ps/Cell" << endl;
 
 	t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(targets, params);
+		volatile HspVector v = ::DP::BandedSwipe::swipe(targets, params);
 	}
 	*message_stream << "SWIPE (int8_t, Stats):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / dp_size * 1000 << " ps/Cell" << endl;
 
@@ -344,34 +349,38 @@ void swipe(const Sequence&s1, const Sequence&s2) {
 	for (size_t i = 0; i < 32; ++i)
 		targets[0][i].matrix = &matrix;
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(targets, params);
+		volatile HspVector v = ::DP::BandedSwipe::swipe(targets, params);
 	}
 	*message_stream << "SWIPE (int8_t, MatrixAdjust):\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / dp_size * 1000 << " ps/Cell" << endl;
 
 	t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(targets, params);
+		volatile HspVector v = ::DP::BandedSwipe::swipe(targets, params);
 	}
 	*message_stream << "SWIPE (int8_t, CBS):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / dp_size * 1000 << " ps/Cell" << endl;
 
 	t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(targets, params);
+		volatile HspVector v = ::DP::BandedSwipe::swipe(targets, params);
 	}
 	*message_stream << "SWIPE (int8_t, TB):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / dp_size * 1000 << " ps/Cell" << endl;
 }
 #endif
 
+#if defined(__SSE2__) | defined(__ARM_NEON)
+
 void banded_swipe(const Sequence &s1, const Sequence &s2) {
+	constexpr int CHANNELS = ::DISPATCH_ARCH::ScoreTraits<ScoreVector<int16_t, SHRT_MIN>>::CHANNELS;
 	DP::Targets targets;
 	//config.traceback_mode = TracebackMode::SCORE_BUFFER;
-	for (size_t i = 0; i < 8; ++i)
+	for (int i = 0; i < CHANNELS; ++i)
 		//targets[1].emplace_back(s2, s2.length(), -32, 32, Interval(), 0, 0, 0);
 		targets[1].emplace_back(s2, s2.length(), -32, 32, 0, 0);
 	static const size_t n = 10000llu;
 	//static const size_t n = 1llu;
 	Statistics stat;
 	HauserCorrection cbs(s1);
+	config.comp_based_stats = 1;
 	DP::Params params{
 		s1, "", Frame(0), s1.length(), cbs.int8.data(), DP::Flags::NONE, false, 0, 0, HspValues(), stat, nullptr
 	};
@@ -379,22 +388,38 @@ void banded_swipe(const Sequence &s1, const Sequence &s2) {
 	for (size_t i = 0; i < n; ++i) {
 		volatile auto out = ::DP::BandedSwipe::swipe(targets, params);
 	}
-	*message_stream << "Banded SWIPE (int16_t, CBS):\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * s1.length() * 65 * 16) * 1000 << " ps/Cell" << endl;
+	*message_stream << "Banded SWIPE (int16_t, CBS):\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * s1.length() * 65 * CHANNELS) * 1000 << " ps/Cell" << endl;
 	
 	t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
 		volatile auto out = ::DP::BandedSwipe::swipe(targets, params);
 	}
-	*message_stream << "Banded SWIPE (int16_t):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * s1.length() * 65 * 16) * 1000 << " ps/Cell" << endl;
+	*message_stream << "Banded SWIPE (int16_t):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * s1.length() * 65 * CHANNELS) * 1000 << " ps/Cell" << endl;
 
 	params.v = HspValues::TRANSCRIPT;
-	t1 = high_resolution_clock::now();
-	for (size_t i = 0; i < n; ++i) {
-		volatile auto out = ::DP::BandedSwipe::swipe(targets, params);
+	for (const bool arena : { false, true }) {
+		size_t hsps = 0;
+		const uint64_t allocs = Util::Memory::thread_alloc_count();
+		t1 = high_resolution_clock::now();
+		for (size_t i = 0; i < n; ++i) {
+			// One arena set per iteration, like the per-query arenas of align_worker.
+			std::unique_ptr<Util::Memory::ThreadArenas> arenas(arena ? new Util::Memory::ThreadArenas : nullptr);
+			Util::Memory::ArenaScope scope(arenas.get());
+			const HspVector out = ::DP::BandedSwipe::swipe(targets, params);
+			hsps += out.size();
+		}
+		const double t = (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count();
+		if (!arena)
+			*message_stream << "Banded SWIPE (int16_t, CBS, TB):" << t / (n * s1.length() * 65 * CHANNELS) * 1000 << " ps/Cell" << endl;
+		*message_stream << "Banded SWIPE HSPs (TB, " << (arena ? "arena):\t" : "heap):\t") << hsps / t * 1e3 << " M/s";
+		if (Util::Memory::ALLOC_COUNT)
+			*message_stream << ", " << (double)(Util::Memory::thread_alloc_count() - allocs) / std::max(hsps, (size_t)1) << " allocations/HSP";
+		*message_stream << endl;
 	}
-	*message_stream << "Banded SWIPE (int16_t, CBS, TB):" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * s1.length() * 65 * 16) * 1000 << " ps/Cell" << endl;
 }
 
+#endif
+
 #if ARCH_ID == 2
 
 void anchored_swipe(const Sequence& s1, const Sequence& s2) {
@@ -570,7 +595,6 @@ void benchmark() {
 	Sequence ss1 = Sequence(s1).subseq(34, (Loc)s1.size());
 	Sequence ss2 = Sequence(s2).subseq(33, (Loc)s2.size());
 
-	//hit_buffer();
 	matrix_adjust(s1, s2);
 #if defined(__SSE4_1__) | defined(__ARM_NEON)
 	//mt_swipe(s3, s4);
@@ -590,8 +614,13 @@ void benchmark() {
 	banded_swipe(s1, s2);
 #endif
 	evalue();
+	hit_buffer();
+	vertex_cover();
 #if defined(__SSE4_1__) | defined(__ARM_NEON)
 	//benchmark_hamming(s1, s2);
+#endif
+#if defined(__SSE2__) | defined(__ARM_NEON)
+	hamming_stage1();
 #endif
 	benchmark_ungapped(ss1, ss2);
 #if (defined(__SSSE3__) && defined(__SSE4_1__)) | defined(__aarch64__)
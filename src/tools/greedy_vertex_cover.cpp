@@ -37,6 +37,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util/memory/memory_resource.h"
 #include "tools.h"
 #include "data/fasta/parser.h"
+#include "output/output_format.h"
+#include "util/parallel/simple_thread_pool.h"
 
 namespace Util { namespace Algo {
 inline void serialize(const Edge<uint64_t>& e, CompressedBuffer& buf) {
@@ -124,6 +126,28 @@ static void greedy_vertex_cover(vector<OId>& clustering, vector<double>& weights
 	}
 }
 
+// Writes the directed edges implied by one alignment into the radix bucket of their first node.
+static void push_edges(BufferArray& buffers, int shift, bool triplets, bool symmetric, double cov, Int q, Int t, double qcov, double tcov, double weight) {
+	if (q == t)
+		return;
+	auto emit = [&](Int n1, Int n2) {
+		Edge edge(n1, n2, weight);
+		const uint64_t radix = (uint64_t)n1 >> shift;
+		buffers.write(radix, &edge, 1, 1);
+		};
+	if (triplets) {
+		emit(t, q);
+		if (symmetric)
+			emit(q, t);
+	}
+	else {
+		if (tcov >= cov)
+			emit(q, t);
+		if (qcov >= cov)
+			emit(t, q);
+	}
+}
+
 static RadixedTable edge_pass_one(const string& base_dir, const OId max_oid, bool triplets, bool symmetric, double cov, const unordered_map<Acc, OId>& acc2oid) {
 	mkdir(base_dir);
 	FileArray file_array(base_dir, RADIX_COUNT, 0, true);
@@ -136,12 +160,7 @@ static RadixedTable edge_pass_one(const string& base_dir, const OId max_oid, boo
 		Util::String::LineIterator it(begin, end);
 		thread_local BufferArray buffers(file_array, RADIX_COUNT);
 		string query, target;
-		double qcov, tcov, weight;
-		auto emit = [&](Int n1, Int n2, double w) {
-			Edge edge(n1, n2, w);
-			const uint64_t radix = (uint64_t)n1 >> shift;
-			buffers.write(radix, &edge, 1, 1);
-			};
+		double qcov = 0.0, tcov = 0.0, weight;
 		while (it.good()) {
 			++line_count;
 			string line = *it;
@@ -152,24 +171,8 @@ static RadixedTable edge_pass_one(const string& base_dir, const OId max_oid, boo
 			if (!triplets)
 				tok >> qcov >> tcov;
 			tok >> weight;
-			if (triplets || tcov >= cov || qcov >= cov) {
-				const auto q = acc2oid.at(query), t = acc2oid.at(target);
-				if (q == t) {
-					++it;
-					continue;
-				}
-				if (triplets) {
-					emit(t, q, weight);
-					if (symmetric)
-						emit(q, t, weight);
-				}
-				else {
-					if (tcov >= cov)
-						emit(q, t, weight);
-					if (qcov >= cov)
-						emit(t, q, weight);
-				}
-			}
+			if (triplets || tcov >= cov || qcov >= cov)
+				push_edges(buffers, shift, triplets, symmetric, cov, acc2oid.at(query), acc2oid.at(target), qcov, tcov, weight);
 			++it;
 		}
 		total_lines.fetch_add(line_count, std::memory_order_relaxed);
@@ -184,6 +187,114 @@ static RadixedTable edge_pass_one(const string& base_dir, const OId max_oid, boo
 	return file_array.buckets(shift);
 }
 
+// Reads the binary edge files written by the search workers. The files are split into chunks of
+// records which the threads claim one at a time, so that several files are read concurrently.
+// Sequence ids are mapped to their rank in the sorted list of node ids.
+static RadixedTable edge_pass_one(const string& base_dir, const vector<string>& edge_files, bool triplets, bool symmetric, double cov, const vector<Int>& node_ids) {
+	using Record = Output::Format::BinaryEdge::Data;
+	static const int64_t CHUNK_SIZE = 1 << 20;
+	mkdir(base_dir);
+	FileArray file_array(base_dir, RADIX_COUNT, 0, true);
+	const int shift = std::max(bit_length((OId)node_ids.size() - 1) - RADIX_BITS, 0);
+
+	TaskTimer timer("Reading input edges");
+	vector<int64_t> file_records;
+	vector<pair<size_t, int64_t>> chunks;
+	for (size_t i = 0; i < edge_files.size(); ++i) {
+		const int64_t size = file_size(edge_files[i].c_str());
+		if (size % sizeof(Record) != 0)
+			throw runtime_error("Invalid size of binary edge file: " + edge_files[i]);
+		file_records.push_back(size / sizeof(Record));
+		for (int64_t j = 0; j < file_records.back(); j += CHUNK_SIZE)
+			chunks.emplace_back(i, j);
+	}
+
+	auto node = [&node_ids](uint64_t id) {
+		const auto it = std::lower_bound(node_ids.begin(), node_ids.end(), id);
+		if (it == node_ids.end() || *it != id)
+			throw runtime_error("Sequence id of edge file not found in database file: " + std::to_string(id));
+		return Int(it - node_ids.begin());
+	};
+	atomic<size_t> next_chunk(0);
+	auto worker = [&](const atomic<bool>& stop) {
+		BufferArray buffers(file_array, RADIX_COUNT);
+		vector<Record> records;
+		size_t i;
+		while (!stop && (i = next_chunk++) < chunks.size()) {
+			const size_t f = chunks[i].first;
+			const int64_t begin = chunks[i].second, n = std::min(CHUNK_SIZE, file_records[f] - begin);
+			records.resize(n);
+			File in(edge_files[f], "rb");
+			in.seek(begin * sizeof(Record));
+			in.read(records.data(), n * sizeof(Record));
+			in.close();
+			for (const Record& r : records)
+				push_edges(buffers, shift, triplets, symmetric, cov, node(r.query), node(r.target), r.qcovhsp / Output::Format::BinaryEdge::COVERAGE_SCALE, r.scovhsp / Output::Format::BinaryEdge::COVERAGE_SCALE, r.weight);
+		}
+	};
+	{
+		SimpleThreadPool pool;
+		for (int i = 0; i < std::min(config.threads_, std::max((int)chunks.size(), 1)); ++i)
+			pool.spawn(worker);
+		pool.join_all();
+	}
+	timer.finish();
+	log_rss();
+	int64_t records = 0;
+	for (int64_t n : file_records)
+		records += n;
+	*message_stream << "#Input files: " << edge_files.size() << endl;
+	*message_stream << "#Input records: " << records << endl;
+	*message_stream << "#Input edges: " << file_array.records_total() << endl;
+	file_array.close();
+	return file_array.buckets(shift);
+}
+
+// Splits the node range buckets whose edges exceed the memory budget into narrower node ranges.
+static RadixedTable split_buckets(const RadixedTable& buckets, int shift, uint64_t max_records, const string& base_dir, vector<string>& dirs) {
+	static const OId CHUNK_SIZE = 65536;
+	RadixedTable out(0);
+	vector<pair<Bucket, int>> stack;
+	for (auto it = buckets.rbegin(); it != buckets.rend(); ++it)
+		stack.emplace_back(*it, shift);
+	vector<Edge> buf(CHUNK_SIZE);
+	while (!stack.empty()) {
+		const Bucket b = stack.back().first;
+		const int s = stack.back().second;
+		stack.pop_back();
+		if (b.records() <= max_records || s == 0) {
+			out.push_back(b);
+			continue;
+		}
+		const int bits = std::min(s, bit_length((b.records() - 1) / max_records) + 1), sub_shift = s - bits;
+		*message_stream << "Splitting bucket key_begin=" << b.key_begin() << " records=" << b.records() << " parts=" << (1 << bits) << endl;
+		const string dir = base_dir + "split_" + std::to_string(dirs.size()) + PATH_SEPARATOR;
+		dirs.push_back(dir);
+		mkdir(dir);
+		FileArray file_array(dir, 1 << bits, 0, true);
+		{
+			BufferArray buffers(file_array, 1 << bits);
+			VolumedFile f(b);
+			for (const Volume& v : f) {
+				File in(v.path, "rb", File::Flags::DETECT_COMPRESSION);
+				for (OId i = 0; i < v.record_count; i += CHUNK_SIZE) {
+					const OId n = std::min(CHUNK_SIZE, v.record_count - i);
+					in.read(buf.data(), n * sizeof(Edge));
+					for (OId j = 0; j < n; ++j)
+						buffers.write((buf[j].node1 - b.key_begin()) >> sub_shift, buf[j]);
+				}
+				in.close();
+			}
+			f.remove();
+		}
+		file_array.close();
+		const RadixedTable parts = file_array.buckets(sub_shift);
+		for (auto it = parts.rbegin(); it != parts.rend(); ++it)
+			stack.emplace_back(Bucket(it->path, it->records(), b.key_begin() + it->key_begin(), b.key_begin() + it->key_end()), sub_shift);
+	}
+	return out;
+}
+
 static OId node_degree(vector<Edge>::const_iterator begin, vector<Edge>::const_iterator end) {
 	OId count = 0;
 	for (auto j = begin; j != end; ++j) {
@@ -193,8 +304,9 @@ static OId node_degree(vector<Edge>::const_iterator begin, vector<Edge>::const_i
 	return count;
 }
 
-static DegreePartition edge_pass_two(const RadixedTable& rep_sorted) {
+static DegreePartition edge_pass_two(const RadixedTable& rep_sorted, uint64_t mem_budget) {
 	unordered_map<OId, OId> degrees;
+	uint64_t edges = 0;
 	for (RadixedTable::const_iterator it = rep_sorted.begin(); it != rep_sorted.end(); ++it) {
 		VolumedFile f(*it);
 		InputBuffer<Edge> data(f);
@@ -204,13 +316,14 @@ static DegreePartition edge_pass_two(const RadixedTable& rep_sorted) {
 		while (i.good()) {
 			const OId d = node_degree(i.begin(), i.end());
 			degrees[d] += d;
+			edges += d;
 			++i;
 		}
 	}
-	return DegreePartition(degrees, RADIX_COUNT);
+	return DegreePartition(degrees, std::max(RADIX_COUNT, edges * sizeof(Edge) / mem_budget + 1));
 }
 
-static RadixedTable edge_pass_three(const RadixedTable& rep_sorted, const DegreePartition& p, Cfg& cfg) {
+static RadixedTable edge_pass_three(const RadixedTable& rep_sorted, const vector<string>& split_dirs, const DegreePartition& p, Cfg& cfg) {
 	const string base_dir = cfg.tmp_dir + "degree_sorted";
 	mkdir(base_dir);
 	FileArray file_array(base_dir, p.size(), 0, true);
@@ -233,23 +346,43 @@ static RadixedTable edge_pass_three(const RadixedTable& rep_sorted, const Degree
 	}
 	buffers.finish();
 	file_array.close();
+	for (const string& dir : split_dirs)
+		rmdir(dir);
 	rmdir(cfg.tmp_dir + "rep_sorted");
 	return file_array.buckets(p);
 }
 
-static vector<OId> edge_pass_four(const RadixedTable& degree_sorted, OId db_size, Cfg& cfg) {
+// Writes the queued potential representatives to disk so that they can be queued again when the degree
+// bucket is processed that would have reached them in the in-memory queue.
+static RadixedTable spill_queue(RepQueue& queue, const vector<OId>& clustering, const DegreePartition& p, const string& dir) {
+	mkdir(dir);
+	FileArray file_array(dir, p.size(), 0, true);
+	{
+		BufferArray buffers(file_array, p.size());
+		while (!queue.empty()) {
+			PotentialRep r = queue.top();
+			queue.pop();
+			if (clustering[r.oid] != numeric_limits<OId>::max())
+				continue;
+			r.set_degree(clustering);
+			size_t bucket = r.degree < p.buckets().front().first_degree ? 0 : p.bucket_index(r.degree);
+			if (r.degree == p.buckets()[bucket].last_degree)
+				++bucket;
+			for (const auto& m : r.members)
+				buffers.write(bucket, Edge(r.oid, m.first, m.second));
+		}
+	}
+	file_array.close();
+	return file_array.buckets(p);
+}
+
+static vector<OId> edge_pass_four(const RadixedTable& degree_sorted, const DegreePartition& p, OId db_size, uint64_t mem_budget, Cfg& cfg) {
 	vector<OId> clustering(db_size, numeric_limits<OId>::max());
 	vector<double> weights(db_size);
 	RepQueue queue;
 	uint64_t edges_queued = 0;
-	for (int i = degree_sorted.size()  - 1; i >= 0; --i) {
-		VolumedFile f(degree_sorted[i]);
-		InputBuffer<Edge> data(f);
-		*message_stream << "Computing vertex cover bucket " << i + 1 << "/" << degree_sorted.size() << " edges=" << data.size()
-			<< " key_begin=" << degree_sorted[i].key_begin() << " key_end=" << degree_sorted[i].key_end() << endl;
-		*message_stream << "Queue nodes=" << queue.size() << " edges=" << edges_queued << " top degree=" << (queue.empty() ? 0 : queue.top().degree) << endl;
-		f.remove();
-		const OId next_degree = i > 0 ? degree_sorted[i - 1].key_end() - 1 : 0;
+	vector<RadixedTable> spilled;
+	auto push = [&](InputBuffer<Edge>& data, bool requeued) {
 		ips4o::parallel::sort(data.begin(), data.end());
 		auto it = merge_keys(data.begin(), data.end(), Edge::GetKey());
 		while (it.good()) {
@@ -261,22 +394,83 @@ static vector<OId> edge_pass_four(const RadixedTable& degree_sorted, OId db_size
 			r.members.reserve(it.count());
 			for (auto j = it.begin(); j != it.end(); ++j) {
 				const bool unassigned = clustering[j->node2] == numeric_limits<OId>::max();
-				if (!config.no_gvc_reassign || unassigned) {
+				if (!config.no_gvc_reassign || unassigned || requeued) {
 					r.members.emplace_back(j->node2, j->weight);
 					if (unassigned)
 						++r.degree;
 				}
 			}
 			edges_queued += r.members.size();
-			queue.push(std::move(r));			
+			queue.push(std::move(r));
 			++it;
 		}
+	};
+	for (int i = degree_sorted.size()  - 1; i >= 0; --i) {
+		VolumedFile f(degree_sorted[i]);
+		InputBuffer<Edge> data(f);
+		*message_stream << "Computing vertex cover bucket " << i + 1 << "/" << degree_sorted.size() << " edges=" << data.size()
+			<< " key_begin=" << degree_sorted[i].key_begin() << " key_end=" << degree_sorted[i].key_end() << endl;
+		*message_stream << "Queue nodes=" << queue.size() << " edges=" << edges_queued << " top degree=" << (queue.empty() ? 0 : queue.top().degree) << endl;
+		f.remove();
+		const OId next_degree = i > 0 ? degree_sorted[i - 1].key_end() - 1 : 0;
+		push(data, false);
+		for (const RadixedTable& t : spilled) {
+			VolumedFile g(t[i]);
+			if (t[i].records() > 0) {
+				InputBuffer<Edge> requeued(g);
+				push(requeued, true);
+			}
+			g.remove();
+		}
 		greedy_vertex_cover(clustering, weights, queue, edges_queued, next_degree);
+		if (i > 0 && edges_queued * sizeof(pair<OId, double>) > mem_budget) {
+			*message_stream << "Writing queue to disk nodes=" << queue.size() << " edges=" << edges_queued << endl;
+			spilled.push_back(spill_queue(queue, clustering, p, cfg.tmp_dir + "degree_sorted" + PATH_SEPARATOR + "spill_" + std::to_string(spilled.size()) + PATH_SEPARATOR));
+			for (size_t j = i; j < spilled.back().size(); ++j)
+				VolumedFile(spilled.back()[j]).remove();
+			edges_queued = 0;
+		}
 	}
+	for (size_t i = 0; i < spilled.size(); ++i)
+		rmdir(cfg.tmp_dir + "degree_sorted" + PATH_SEPARATOR + "spill_" + std::to_string(i));
 	rmdir(cfg.tmp_dir + "degree_sorted");
 	return clustering;
 }
 
+static vector<OId> parallel_vertex_cover(const RadixedTable& rep_sorted, const vector<string>& split_dirs, OId db_size, Cfg& cfg) {
+	vector<Edge> edges;
+	vector<uint64_t> limits;
+	limits.reserve(db_size + 1);
+	limits.push_back(0);
+	for (RadixedTable::const_iterator it = rep_sorted.begin(); it != rep_sorted.end(); ++it) {
+		VolumedFile f(*it);
+		InputBuffer<Edge> data(f);
+		*message_stream << "Loading edges bucket " << it - rep_sorted.begin() + 1 << "/" << rep_sorted.size() << " records=" << data.size() << endl;
+		ips4o::parallel::sort(data.begin(), data.end());
+		for (auto i = data.begin(); i != data.end(); ++i) {
+			if (i->node1 == i->node2)
+				continue;
+			if (!edges.empty() && edges.back().node1 == i->node1 && edges.back().node2 == i->node2) {
+				edges.back().weight = std::max(edges.back().weight, i->weight);
+				continue;
+			}
+			while (limits.size() < i->node1 + 1)
+				limits.push_back(edges.size());
+			edges.push_back(*i);
+		}
+		f.remove();
+	}
+	while (limits.size() < db_size + 1)
+		limits.push_back(edges.size());
+	for (const string& dir : split_dirs)
+		rmdir(dir);
+	rmdir(cfg.tmp_dir + "rep_sorted");
+	log_rss();
+	*message_stream << "#Unique edges: " << edges.size() << endl;
+	FlatArray<Edge> neighbors(std::move(limits), std::move(edges));
+	return Util::Algo::parallel_greedy_vertex_cover<Int>(neighbors, config.threads_, nullptr, merge_recursive, !config.no_gvc_reassign);
+}
+
 void greedy_vertex_cover(Cfg& cfg) {
 	config.database.require();
 	const double cov = std::max(config.query_or_target_cover, config.member_cover.get(Cluster::DEFAULT_MEMBER_COVER));
@@ -284,7 +478,7 @@ void greedy_vertex_cover(Cfg& cfg) {
 	if (!triplets && symmetric)
 		throw runtime_error("--symmetric requires triplet edge format");
 	*message_stream << "Coverage cutoff: " << cov << '%' << endl;
-	*message_stream << "Edge format: " << (triplets ? "triplet" : "quintuplet") << endl;
+	*message_stream << "Edge format: " << (triplets ? "triplet" : "quintuplet") << (cfg.edge_files.empty() ? "" : " (binary)") << endl;
 	*message_stream << "Symmetric: " << (symmetric ? "yes" : "no") << endl;
 	TaskTimer timer("Reading mapping file");
 	unordered_map<Acc, OId> acc2oid;
@@ -304,15 +498,46 @@ void greedy_vertex_cover(Cfg& cfg) {
 	if (acc2oid.size() > (size_t)numeric_limits<Int>::max())
 		throw runtime_error("Input count exceeds supported maximum.");
 	const OId max_oid = acc2oid.size() - 1;
+	vector<Int> node_ids;
+	if (!cfg.edge_files.empty()) {
+		node_ids.resize(acc2oid.size());
+		for (const auto& i : acc2oid) {
+			char* end;
+			node_ids[i.second] = strtoull(i.first.c_str(), &end, 10);
+			if (end == i.first.c_str() || *end != '\0')
+				throw runtime_error("Binary edge input requires numeric sequence ids in the database file: " + i.first);
+		}
+		if (!std::is_sorted(node_ids.begin(), node_ids.end()))
+			throw runtime_error("Binary edge input requires the database file to be sorted by sequence id.");
+	}
 
 	if (cfg.tmp_dir.empty())
 		cfg.tmp_dir = config.tmpdir = create_temp_directory(config.tmpdir, "diamond-tmp-") + PATH_SEPARATOR;
 	const string base_dir = cfg.tmp_dir;
 	//mkdir(base_dir);
-	RadixedTable rep_sorted = edge_pass_one(base_dir + "rep_sorted" + PATH_SEPARATOR, max_oid, triplets, symmetric, cov, acc2oid);
-	const DegreePartition p = edge_pass_two(rep_sorted);
-	RadixedTable degree_sorted = edge_pass_three(rep_sorted, p, cfg);
-	vector<OId> clustering = edge_pass_four(degree_sorted, acc2oid.size(), cfg);
+	const uint64_t mem_budget = Util::String::interpret_number(config.memory_limit.get(DEFAULT_MEMORY_LIMIT)) / 4;
+	vector<string> split_dirs;
+	const string rep_dir = base_dir + "rep_sorted" + PATH_SEPARATOR;
+	const RadixedTable rep_sorted = split_buckets(cfg.edge_files.empty() ? edge_pass_one(rep_dir, max_oid, triplets, symmetric, cov, acc2oid)
+		: edge_pass_one(rep_dir, cfg.edge_files, triplets, symmetric, cov, node_ids),
+		std::max(bit_length(max_oid) - RADIX_BITS, 0), std::max<uint64_t>(mem_budget / sizeof(Edge), 1), rep_dir, split_dirs);
+	vector<Int>().swap(node_ids);
+	uint64_t edges = 0;
+	for (const Bucket& b : rep_sorted)
+		edges += b.records();
+	vector<OId> clustering;
+	bool parallel = from_string<GraphAlgo>(config.graph_algo) == GraphAlgo::PARALLEL_GREEDY_VERTEX_COVER;
+	if (parallel && edges * sizeof(Edge) > mem_budget * 2) {
+		*message_stream << "Edges exceed the memory limit, using the sequential vertex cover algorithm." << endl;
+		parallel = false;
+	}
+	if (parallel)
+		clustering = parallel_vertex_cover(rep_sorted, split_dirs, acc2oid.size(), cfg);
+	else {
+		const DegreePartition p = edge_pass_two(rep_sorted, mem_budget);
+		RadixedTable degree_sorted = edge_pass_three(rep_sorted, split_dirs, p, cfg);
+		clustering = edge_pass_four(degree_sorted, p, acc2oid.size(), mem_budget, cfg);
+	}
 	rmdir(cfg.tmp_dir);
 
 	if (merge_recursive) {
@@ -17,10 +17,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#pragma once
+#include <string>
+#include <vector>
+
 namespace GVC {
 
 struct Cfg {
 	std::string tmp_dir;
+	// Binary edge files (Output::Format::BinaryEdge) to read instead of config.edges.
+	std::vector<std::string> edge_files;
 };
 
 void greedy_vertex_cover(Cfg& cfg);
@@ -54,6 +54,8 @@ struct Edge {
 template<typename Int>
 std::vector<Int> greedy_vertex_cover(FlatArray<Edge<Int>>& neighbors, const Int* member_counts = nullptr, bool merge_recursive = false, bool reassign = true, Int connected_component_depth = 0);
 template<typename Int>
+std::vector<Int> parallel_greedy_vertex_cover(FlatArray<Edge<Int>>& neighbors, int threads, const Int* member_counts = nullptr, bool merge_recursive = false, bool reassign = true);
+template<typename Int>
 std::vector<Int> cluster_pr(FlatArray<Edge<Int>>& neighbors);
 //template<typename Int> FlatArray<Int> mcl(FlatArray<Int>& neighbors);
 
@@ -18,6 +18,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <queue>
+#include <thread>
+#include <atomic>
 #include "algo.h"
 #include "../log_stream.h"
 
@@ -27,6 +29,8 @@ using std::pair;
 using std::numeric_limits;
 using std::swap;
 using std::queue;
+using std::atomic;
+using std::thread;
 
 namespace Util { namespace Algo {
 
@@ -120,6 +124,27 @@ void make_cluster_cc(Int rep, FlatArray<Edge<Int>>& neighbors, vector<Int>& cent
 	}
 }
 
+template<typename Int>
+static void finish_cover(FlatArray<Edge<Int>>& neighbors, vector<Int>& centroids, bool merge_recursive, bool reassign) {
+	TaskTimer timer;
+	if (reassign) {
+		timer.go("Computing reassignment");
+		vector<double> weights(neighbors.size(), numeric_limits<double>::lowest());
+		for (Int node = 0; node < neighbors.size(); ++node)
+			if (centroids[node] == node)
+				for (auto i = neighbors.cbegin(node); i != neighbors.cend(node); ++i)
+					if (centroids[i->node2] != i->node2 && i->weight > weights[i->node2]) {
+						weights[i->node2] = i->weight;
+						centroids[i->node2] = node;
+					}
+	}
+
+	if (merge_recursive) {
+		timer.go("Computing merges");
+		fix_assignment(centroids);
+	}
+}
+
 template<typename Int>
 vector<Int> greedy_vertex_cover(FlatArray<Edge<Int>>& neighbors, const Int* member_counts, bool merge_recursive, bool reassign, Int connected_component_depth) {
 	static constexpr Int NIL = std::numeric_limits<Int>::max();
@@ -151,28 +176,179 @@ vector<Int> greedy_vertex_cover(FlatArray<Edge<Int>>& neighbors, const Int* memb
 	}
 	timer.finish();
 	*message_stream << "Cluster count = " << cluster_count << std::endl;
+	finish_cover(neighbors, centroids, merge_recursive, reassign);
+	return centroids;
+}
 
-	if (reassign) {
-		timer.go("Computing reassignment");
-		vector<double> weights(neighbors.size(), numeric_limits<double>::lowest());
-		for (Int node = 0; node < neighbors.size(); ++node)
-			if (centroids[node] == node)
-				for (auto i = neighbors.cbegin(node); i != neighbors.cend(node); ++i)
-					if (centroids[i->node2] != i->node2 && i->weight > weights[i->node2]) {
-						weights[i->node2] = i->weight;
-						centroids[i->node2] = node;
-					}
-	}
+template<typename F>
+static void parallel_for(int64_t n, int threads, F f) {
+	static constexpr int64_t CHUNK_SIZE = 4096;
+	atomic<int64_t> next(0);
+	auto worker = [&]() {
+		int64_t begin;
+		while ((begin = next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed)) < n)
+			f(begin, std::min(begin + CHUNK_SIZE, n));
+	};
+	const int64_t chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	vector<thread> t;
+	for (int64_t i = 1; i < std::min((int64_t)threads, chunks); ++i)
+		t.emplace_back(worker);
+	worker();
+	for (thread& i : t)
+		i.join();
+}
 
-	if (merge_recursive) {
-		timer.go("Computing merges");
-		fix_assignment(centroids);
-	}
+// Computes a vertex cover in rounds. In each round, the unassigned nodes whose count of unassigned
+// neighbors is within a factor of 2 of the maximum become candidates. Every candidate claims itself and
+// its unassigned neighbors, and conflicts are resolved in favor of the candidate with the higher
+// (count, node id). Candidates that own all of their claims form clusters with pairwise disjoint members.
+// The result does not depend on the number of threads.
+template<typename Int>
+vector<Int> parallel_greedy_vertex_cover(FlatArray<Edge<Int>>& neighbors, int threads, const Int* member_counts, bool merge_recursive, bool reassign) {
+	static constexpr Int NIL = std::numeric_limits<Int>::max();
+	TaskTimer timer("Computing vertex cover");
+	const int64_t n = (int64_t)neighbors.size();
+	vector<Int> centroids(n, NIL), counts(n), active(n);
+	vector<char> won(n, 0);
+	vector<atomic<Int>> claims(n);
+	auto count = [&](Int node) {
+		return member_counts ? neighbor_count(node, neighbors.cbegin(node), neighbors.cend(node), centroids, member_counts) :
+			neighbor_count2(neighbors.cbegin(node), neighbors.cend(node), centroids);
+	};
+	parallel_for(n, threads, [&](int64_t begin, int64_t end) {
+		for (int64_t i = begin; i < end; ++i) {
+			active[i] = (Int)i;
+			counts[i] = count((Int)i);
+			claims[i].store(NIL, std::memory_order_relaxed);
+		}
+	});
 
+	auto better = [&counts](Int a, Int b) {
+		return counts[a] > counts[b] || (counts[a] == counts[b] && a > b);
+	};
+	auto claim = [&](Int node, Int candidate) {
+		Int current = claims[node].load(std::memory_order_relaxed);
+		while ((current == NIL || better(candidate, current)) && !claims[node].compare_exchange_weak(current, candidate, std::memory_order_relaxed));
+	};
+
+	int64_t cluster_count = 0, rounds = 0;
+	while (!active.empty()) {
+		++rounds;
+		const int64_t active_count = (int64_t)active.size();
+		// Counts only decrease, so the counts of previous rounds are upper bounds and only the nodes
+		// that may reach the threshold need to be recounted.
+		atomic<Int> max_count(0);
+		parallel_for(active_count, threads, [&](int64_t begin, int64_t end) {
+			Int m = 0;
+			for (int64_t i = begin; i < end; ++i)
+				m = std::max(m, counts[active[i]]);
+			Int current = max_count.load(std::memory_order_relaxed);
+			while (m > current && !max_count.compare_exchange_weak(current, m, std::memory_order_relaxed));
+		});
+		const Int threshold = max_count - max_count / 2;
+		atomic<int64_t> candidates(0);
+		parallel_for(active_count, threads, [&](int64_t begin, int64_t end) {
+			int64_t c = 0;
+			for (int64_t i = begin; i < end; ++i) {
+				const Int node = active[i];
+				if (counts[node] >= threshold && rounds > 1)
+					counts[node] = count(node);
+				c += counts[node] >= threshold;
+			}
+			candidates += c;
+		});
+		if (candidates == 0)
+			continue;
+
+		parallel_for(active_count, threads, [&](int64_t begin, int64_t end) {
+			for (int64_t i = begin; i < end; ++i) {
+				const Int node = active[i];
+				if (counts[node] < threshold)
+					continue;
+				claim(node, node);
+				for (auto j = neighbors.cbegin(node); j != neighbors.cend(node); ++j)
+					if (centroids[j->node2] == NIL)
+						claim(j->node2, node);
+			}
+		});
+
+		parallel_for(active_count, threads, [&](int64_t begin, int64_t end) {
+			for (int64_t i = begin; i < end; ++i) {
+				const Int node = active[i];
+				if (counts[node] < threshold || claims[node].load(std::memory_order_relaxed) != node)
+					continue;
+				bool w = true;
+				for (auto j = neighbors.cbegin(node); j != neighbors.cend(node) && w; ++j)
+					if (centroids[j->node2] == NIL && claims[j->node2].load(std::memory_order_relaxed) != node)
+						w = false;
+				won[node] = w;
+			}
+		});
+
+		atomic<int64_t> round_clusters(0);
+		parallel_for(active_count, threads, [&](int64_t begin, int64_t end) {
+			int64_t c = 0;
+			for (int64_t i = begin; i < end; ++i) {
+				const Int node = active[i];
+				if (counts[node] < threshold)
+					continue;
+				claims[node].store(NIL, std::memory_order_relaxed);
+				for (auto j = neighbors.cbegin(node); j != neighbors.cend(node); ++j)
+					claims[j->node2].store(NIL, std::memory_order_relaxed);
+				if (!won[node])
+					continue;
+				centroids[node] = node;
+				for (auto j = neighbors.cbegin(node); j != neighbors.cend(node); ++j)
+					if (centroids[j->node2] == NIL)
+						centroids[j->node2] = node;
+				++c;
+			}
+			round_clusters += c;
+		});
+		cluster_count += round_clusters;
+
+		if (merge_recursive) {
+			vector<Int> winners;
+			for (Int node : active)
+				if (won[node])
+					winners.push_back(node);
+			std::sort(winners.begin(), winners.end(), better);
+			for (Int node : winners)
+				for (auto j = neighbors.cbegin(node); j != neighbors.cend(node); ++j)
+					if (j->node2 != node && centroids[j->node2] == j->node2 && !won[j->node2])
+						centroids[j->node2] = node;
+		}
+
+		const int64_t parts = std::min((int64_t)threads * 4, active_count);
+		vector<int64_t> part_size(parts);
+		parallel_for(parts, threads, [&](int64_t begin, int64_t end) {
+			for (int64_t p = begin; p < end; ++p) {
+				const int64_t b = active_count * p / parts, e = active_count * (p + 1) / parts;
+				int64_t k = b;
+				for (int64_t i = b; i < e; ++i) {
+					won[active[i]] = 0;
+					if (centroids[active[i]] == NIL)
+						active[k++] = active[i];
+				}
+				part_size[p] = k - b;
+			}
+		});
+		int64_t size = 0;
+		for (int64_t p = 0; p < parts; ++p) {
+			std::move(active.begin() + active_count * p / parts, active.begin() + active_count * p / parts + part_size[p], active.begin() + size);
+			size += part_size[p];
+		}
+		active.resize(size);
+	}
+	timer.finish();
+	*message_stream << "Cluster count = " << cluster_count << ", rounds = " << rounds << std::endl;
+	finish_cover(neighbors, centroids, merge_recursive, reassign);
 	return centroids;
 }
 
 template vector<uint32_t> greedy_vertex_cover<uint32_t>(FlatArray<Edge<uint32_t>>&, const uint32_t*, bool, bool, uint32_t);
 template vector<uint64_t> greedy_vertex_cover<uint64_t>(FlatArray<Edge<uint64_t>>&, const uint64_t*, bool, bool, uint64_t);
+template vector<uint32_t> parallel_greedy_vertex_cover<uint32_t>(FlatArray<Edge<uint32_t>>&, int, const uint32_t*, bool, bool);
+template vector<uint64_t> parallel_greedy_vertex_cover<uint64_t>(FlatArray<Edge<uint64_t>>&, int, const uint64_t*, bool, bool);
 
 }}
\ No newline at end of file
@@ -23,7 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 template<typename T>
 struct MemBuffer {
 
-	enum { ALIGN = 32 };
+	enum { ALIGN = alignof(T) > 32 ? alignof(T) : 32 };
 
 	typedef T value_type;
 
@@ -97,6 +97,25 @@ public:
         }
     }
 
+    // non-blocking variants, returning false if the queue is full / empty
+    template <class U>
+    bool try_enqueue(U&& v) {
+        if (!spaces_.try_acquire())
+            return false;
+        emplace_acquired(std::forward<U>(v));
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        if (!items_.try_acquire())
+            return false;
+        while (!try_dequeue(out)) {
+            std::this_thread::yield();
+        }
+        spaces_.release();
+        return true;
+    }
+
     bool empty() const {
         return approx_size() == 0;
     }
@@ -158,6 +177,11 @@ private:
     template <class... Args>
     void emplace_impl(Args&&... args) {        
         spaces_.acquire();
+        emplace_acquired(std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    void emplace_acquired(Args&&... args) {
         size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
         for (;;) {
             Cell* cell = &buffer_[index(pos)];
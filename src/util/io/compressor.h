@@ -72,3 +72,38 @@ private:
 	bool closed_ = false;
 };
 #endif
+
+// Splits the stream into fixed size blocks that are compressed by worker threads into independent
+// zstd frames or gzip members and written in order.
+struct ParallelCompressor : CompressorX {
+	ParallelCompressor(CompressionLib lib, int threads);
+	size_t fwrite(const void* buffer, size_t size, size_t count, FILE* stream) override;
+	void close(FILE* stream) override;
+	virtual CompressionLib lib() const override {
+		return lib_;
+	}
+	~ParallelCompressor();
+	static const size_t block_size = 4llu << 20;
+private:
+	struct Block {
+		std::vector<char> in, out;
+		bool done = false;
+	};
+	void worker();
+	void submit();
+	void write_out(bool wait, size_t keep);
+	void stop_workers();
+	const CompressionLib lib_;
+	const int threads_;
+	const size_t max_queued_;
+	std::vector<char> buf_;
+	std::deque<std::unique_ptr<Block>> queue_;
+	std::deque<Block*> jobs_;
+	std::vector<std::thread> workers_;
+	std::mutex mtx_;
+	std::condition_variable job_cv_, done_cv_;
+	std::exception_ptr error_;
+	FILE* stream_ = nullptr;
+	bool stop_ = false;
+	bool closed_ = false;
+};
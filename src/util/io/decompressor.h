@@ -19,6 +19,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 #include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include <stdexcept>
 #include <zlib.h>
 #ifdef WITH_ZSTD
@@ -41,6 +47,8 @@ struct Decompressor {
 	virtual CompressionLib lib() const = 0;
 	virtual int ungetc(int c, FILE* stream) = 0;
 	virtual void reset() = 0;
+	virtual void close() {}
+	virtual ~Decompressor() = default;
 };
 
 template<typename ReadByte>
@@ -141,4 +149,52 @@ private:
 	bool eos_ = false;
 	int pushback_ = EOF;
 };
-#endif
\ No newline at end of file
+#endif
+
+// Id of the gzip extra subfield in which ParallelCompressor stores the compressed size of each member
+// (4 bytes, little endian).
+static const unsigned char GZIP_SIZE_SI1 = 'D', GZIP_SIZE_SI2 = 'M';
+
+// Splits multi-frame zstd input and gzip input whose members carry their size (BGZF or the output of
+// ParallelCompressor) into blocks of complete frames that are decompressed by worker threads. The
+// workers are started as blocks become available. Streams that can not be split (e.g. single member
+// gzip) are decompressed by the reader thread, which still overlaps decompression with parsing.
+struct ParallelDecompressor : Decompressor {
+	ParallelDecompressor(CompressionLib lib, int threads);
+	size_t fread(void* buffer, size_t size, size_t count, FILE* stream) override;
+	int fgetc(FILE* stream) override;
+	ssize_t getdelim(char** buf, size_t* buf_size, char delimiter, FILE* fp) override;
+	virtual CompressionLib lib() const override {
+		return lib_;
+	}
+	int ungetc(int c, FILE* stream) override;
+	virtual void reset() override;
+	virtual void close() override;
+	~ParallelDecompressor();
+private:
+	struct Unit {
+		std::vector<char> in, out;
+		bool done = false;
+	};
+	void reader(FILE* stream);
+	void stream_rest(std::vector<char>& buf, FILE* stream);
+	void worker();
+	void enqueue(std::unique_ptr<Unit>& unit);
+	bool stopped();
+	bool next_block(FILE* stream);
+	const CompressionLib lib_;
+	const int threads_;
+	const size_t max_queued_;
+	std::vector<char> cur_;
+	size_t pos_ = 0;
+	int pushback_ = EOF;
+	bool started_ = false, eos_ = false;
+	std::deque<std::unique_ptr<Unit>> queue_;
+	std::deque<Unit*> jobs_;
+	std::thread reader_;
+	std::vector<std::thread> workers_;
+	std::mutex mtx_;
+	std::condition_variable job_cv_, done_cv_, space_cv_;
+	std::exception_ptr error_;
+	bool input_done_ = false, stop_ = false;
+};
@@ -109,11 +109,17 @@ File::File(const string& name, const char* mode, Flags flags, CompressionLib com
 			if (magic.length() == 4) {
 				switch (detect_compressor(magic.c_str())) {
 				case CompressionLib::ZLIB:
-					decompressor_.reset(new ZlibDecompressor);
+					if (config.threads_ > 1)
+						decompressor_.reset(new ParallelDecompressor(CompressionLib::ZLIB, config.threads_));
+					else
+						decompressor_.reset(new ZlibDecompressor);
 					break;
 				case CompressionLib::ZSTD:
 #ifdef WITH_ZSTD
-					decompressor_.reset(new ZstdDecompressor);
+					if (config.threads_ > 1)
+						decompressor_.reset(new ParallelDecompressor(CompressionLib::ZSTD, config.threads_));
+					else
+						decompressor_.reset(new ZstdDecompressor);
 #endif
 					break;
 				default:
@@ -123,13 +129,17 @@ File::File(const string& name, const char* mode, Flags flags, CompressionLib com
 		}
 	}
 	else if (strcmp(mode, "wb") == 0 && compression != CompressionLib::NONE) {
-		switch (compression) {
+		if (config.threads_ > 1)
+			compressor_.reset(new ParallelCompressor(compression, config.threads_));
+		else switch (compression) {
 		case CompressionLib::ZLIB:
 			compressor_.reset(new ZlibCompressor);
 			break;
 		case CompressionLib::ZSTD:
 #ifdef WITH_ZSTD
 			compressor_.reset(new ZstdCompressor);
+#else
+			throw runtime_error("Executable was not compiled with ZStd support.");
 #endif
 			break;
 		default:
@@ -172,6 +182,8 @@ File& File::operator=(File&& f) noexcept {
 void File::close() {
 	if (compressor_)
 		compressor_->close(file_);
+	if (decompressor_)
+		decompressor_->close();
 	if (file_) {
 		fclose(file_);
 		if (auto_delete_ && !unlinked_)
@@ -220,11 +232,11 @@ void File::seek(int64_t p)
 
 void File::rewind()
 {
+	decompressor_->reset();
 	seek(0, SEEK_SET);
 	clearerr(file_);
 	line_buf_[0] = 0;
 	line_count = 0;
-	decompressor_->reset();
 }
 
 int64_t File::tell()
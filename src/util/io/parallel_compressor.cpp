@@ -0,0 +1,233 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <string.h>
+#include <errno.h>
+#include <limits>
+#include <algorithm>
+#include "compressor.h"
+
+using std::vector;
+using std::unique_ptr;
+using std::mutex;
+using std::unique_lock;
+using std::runtime_error;
+
+// Compresses one block into a self-contained zstd frame or gzip member. Concatenations of
+// these are valid streams for any standard decompressor. Gzip members carry their compressed
+// size in an extra subfield, which lets ParallelDecompressor split the stream.
+static void compress_block(CompressionLib lib, const vector<char>& in, vector<char>& out) {
+	switch (lib) {
+	case CompressionLib::ZLIB: {
+		static const size_t HEADER_SIZE = 20, TRAILER_SIZE = 8;
+		z_stream strm;
+		strm.zalloc = Z_NULL;
+		strm.zfree = Z_NULL;
+		strm.opaque = Z_NULL;
+		if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw runtime_error("Error initializing zlib compressor (deflateInit2)");
+		out.resize(HEADER_SIZE + deflateBound(&strm, (uLong)in.size()) + TRAILER_SIZE);
+		strm.next_in = (Bytef*)in.data();
+		strm.avail_in = (uInt)in.size();
+		strm.next_out = (Bytef*)out.data() + HEADER_SIZE;
+		strm.avail_out = (uInt)(out.size() - HEADER_SIZE - TRAILER_SIZE);
+		const int ret = deflate(&strm, Z_FINISH);
+		const size_t size = HEADER_SIZE + strm.total_out + TRAILER_SIZE;
+		deflateEnd(&strm);
+		if (ret != Z_STREAM_END)
+			throw runtime_error("Error during zlib compression (deflate)");
+		const uint32_t crc = (uint32_t)crc32(0, (const Bytef*)in.data(), (uInt)in.size());
+		const unsigned char header[HEADER_SIZE] = { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 8, 0, GZIP_SIZE_SI1, GZIP_SIZE_SI2, 4, 0,
+			(unsigned char)size, (unsigned char)(size >> 8), (unsigned char)(size >> 16), (unsigned char)(size >> 24) };
+		std::copy(header, header + HEADER_SIZE, out.begin());
+		for (int i = 0; i < 4; ++i) {
+			out[size - 8 + i] = (char)(crc >> (8 * i));
+			out[size - 4 + i] = (char)(in.size() >> (8 * i));
+		}
+		out.resize(size);
+		break;
+	}
+#ifdef WITH_ZSTD
+	case CompressionLib::ZSTD: {
+		out.resize(ZSTD_compressBound(in.size()));
+		const size_t n = ZSTD_compress(out.data(), out.size(), in.data(), in.size(), 0);
+		if (ZSTD_isError(n))
+			throw runtime_error(std::string("Error during zstd compression: ") + ZSTD_getErrorName(n));
+		out.resize(n);
+		break;
+	}
+#endif
+	default:
+		throw runtime_error("Invalid compressor in ParallelCompressor");
+	}
+}
+
+ParallelCompressor::ParallelCompressor(CompressionLib lib, int threads) :
+	lib_(lib),
+	threads_(threads),
+	max_queued_(2 * threads)
+{
+#ifndef WITH_ZSTD
+	if (lib == CompressionLib::ZSTD)
+		throw runtime_error("Executable was not compiled with ZStd support.");
+#endif
+	buf_.reserve(block_size);
+}
+
+void ParallelCompressor::worker() {
+	unique_lock<mutex> lock(mtx_);
+	for (;;) {
+		job_cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+		if (jobs_.empty())
+			return;
+		Block* block = jobs_.front();
+		jobs_.pop_front();
+		lock.unlock();
+		std::exception_ptr error;
+		try {
+			compress_block(lib_, block->in, block->out);
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		block->in.clear();
+		block->in.shrink_to_fit();
+		lock.lock();
+		if (error && !error_)
+			error_ = error;
+		block->done = true;
+		done_cv_.notify_all();
+	}
+}
+
+void ParallelCompressor::write_out(bool wait, size_t keep) {
+	unique_lock<mutex> lock(mtx_);
+	while (queue_.size() > keep) {
+		if (!queue_.front()->done) {
+			if (!wait)
+				break;
+			done_cv_.wait(lock, [this] { return queue_.front()->done; });
+		}
+		if (error_)
+			std::rethrow_exception(error_);
+		unique_ptr<Block> block = std::move(queue_.front());
+		queue_.pop_front();
+		lock.unlock();
+		const size_t n = block->out.size();
+		if (n != 0 && std::fwrite(block->out.data(), 1, n, stream_) != n)
+			throw runtime_error(std::string("Error writing compressed file: ") + strerror(errno));
+		lock.lock();
+	}
+}
+
+void ParallelCompressor::submit() {
+	if (workers_.empty())
+		for (int i = 0; i < threads_; ++i)
+			workers_.emplace_back(&ParallelCompressor::worker, this);
+	write_out(true, max_queued_ - 1);
+	unique_ptr<Block> block(new Block());
+	block->in.swap(buf_);
+	buf_.reserve(block_size);
+	{
+		std::lock_guard<mutex> lock(mtx_);
+		jobs_.push_back(block.get());
+		queue_.push_back(std::move(block));
+	}
+	job_cv_.notify_one();
+	write_out(false, 0);
+}
+
+size_t ParallelCompressor::fwrite(const void* buffer, size_t size, size_t count, FILE* stream) {
+	if (size == 0 || count == 0)
+		return 0;
+	if (closed_)
+		throw runtime_error("Cannot write to closed compressor.");
+	if (stream_ == nullptr)
+		stream_ = stream;
+	else if (stream_ != stream)
+		throw runtime_error("Cannot write one compressed stream to multiple FILE handles.");
+	if (count > std::numeric_limits<size_t>::max() / size)
+		throw runtime_error("Compressed write size overflow.");
+
+	const char* in = static_cast<const char*>(buffer);
+	size_t remaining = size * count;
+	while (remaining > 0) {
+		const size_t n = std::min(remaining, block_size - buf_.size());
+		buf_.insert(buf_.end(), in, in + n);
+		in += n;
+		remaining -= n;
+		if (buf_.size() == block_size)
+			submit();
+	}
+	return count;
+}
+
+void ParallelCompressor::stop_workers() {
+	{
+		std::lock_guard<mutex> lock(mtx_);
+		stop_ = true;
+	}
+	job_cv_.notify_all();
+	for (std::thread& t : workers_)
+		t.join();
+	workers_.clear();
+}
+
+void ParallelCompressor::close(FILE* stream) {
+	if (closed_)
+		return;
+	if (stream_ == nullptr)
+		stream_ = stream;
+	else if (stream_ != stream)
+		throw runtime_error("Cannot close compressor with a different FILE handle.");
+	closed_ = true;
+	try {
+		if (workers_.empty()) {
+			// Small outputs are compressed in the calling thread. An empty input still produces
+			// a valid empty frame.
+			vector<char> out;
+			compress_block(lib_, buf_, out);
+			if (!out.empty() && std::fwrite(out.data(), 1, out.size(), stream_) != out.size())
+				throw runtime_error(std::string("Error writing compressed file: ") + strerror(errno));
+		}
+		else {
+			if (!buf_.empty())
+				submit();
+			write_out(true, 0);
+		}
+	}
+	catch (...) {
+		stop_workers();
+		throw;
+	}
+	stop_workers();
+	buf_.clear();
+	buf_.shrink_to_fit();
+}
+
+ParallelCompressor::~ParallelCompressor() {
+	if (!closed_ && stream_) {
+		try {
+			close(stream_);
+		}
+		catch (...) {
+		}
+	}
+	stop_workers();
+}
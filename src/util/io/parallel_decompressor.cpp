@@ -0,0 +1,443 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <string.h>
+#include <errno.h>
+#include <limits>
+#include "decompressor.h"
+
+using std::vector;
+using std::unique_ptr;
+using std::mutex;
+using std::unique_lock;
+using std::lock_guard;
+using std::runtime_error;
+
+static const size_t READ_SIZE = 1llu << 20, UNIT_SIZE = 1llu << 20, MAX_FRAME_SIZE = 64llu << 20;
+
+// Returns the compressed size of the zstd frame or gzip member at the start of the buffer, 0 if
+// more input is needed to determine it, or -1 if the stream can not be split at this position.
+// Gzip members need to carry their size in a BGZF or ParallelCompressor extra subfield.
+static int64_t frame_size(CompressionLib lib, const char* ptr, size_t n) {
+	const unsigned char* p = (const unsigned char*)ptr;
+	switch (lib) {
+	case CompressionLib::ZLIB: {
+		if (n < 12)
+			return 0;
+		if (p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || (p[3] & 4) == 0)
+			return -1;
+		const size_t xlen = p[10] | (p[11] << 8);
+		if (n < 12 + xlen)
+			return 0;
+		for (size_t i = 12; i + 4 <= 12 + xlen;) {
+			const size_t slen = p[i + 2] | (p[i + 3] << 8);
+			if (p[i] == 'B' && p[i + 1] == 'C' && slen == 2 && i + 6 <= 12 + xlen)
+				return (int64_t)(p[i + 4] | (p[i + 5] << 8)) + 1;
+			if (p[i] == GZIP_SIZE_SI1 && p[i + 1] == GZIP_SIZE_SI2 && slen == 4 && i + 8 <= 12 + xlen) {
+				const int64_t size = p[i + 4] | (p[i + 5] << 8) | (p[i + 6] << 16) | ((int64_t)p[i + 7] << 24);
+				return size >= (int64_t)(12 + xlen + 8) ? size : -1;
+			}
+			i += 4 + slen;
+		}
+		return -1;
+	}
+#ifdef WITH_ZSTD
+	case CompressionLib::ZSTD: {
+		if (n < 4)
+			return 0;
+		const uint32_t magic = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+		if (magic != ZSTD_MAGICNUMBER && (magic & ZSTD_MAGIC_SKIPPABLE_MASK) != ZSTD_MAGIC_SKIPPABLE_START)
+			return -1;
+		const size_t r = ZSTD_findFrameCompressedSize(ptr, n);
+		return ZSTD_isError(r) ? 0 : (int64_t)r;
+	}
+#endif
+	default:
+		return -1;
+	}
+}
+
+// Decompresses a sequence of complete frames/members.
+static void decompress_unit(CompressionLib lib, const vector<char>& in, vector<char>& out) {
+	out.resize(std::max(in.size() * 4, (size_t)4096));
+	size_t produced = 0;
+	switch (lib) {
+	case CompressionLib::ZLIB: {
+		z_stream strm;
+		strm.zalloc = Z_NULL;
+		strm.zfree = Z_NULL;
+		strm.opaque = Z_NULL;
+		strm.next_in = (Bytef*)in.data();
+		strm.avail_in = (uInt)in.size();
+		if (inflateInit2(&strm, 15 + 32) != Z_OK)
+			throw runtime_error("Error initializing zlib decompressor (inflateInit2)");
+		bool full = false;
+		while (strm.avail_in > 0 || full) {
+			if (produced == out.size())
+				out.resize(out.size() * 2);
+			strm.next_out = (Bytef*)out.data() + produced;
+			strm.avail_out = (uInt)(out.size() - produced);
+			const int ret = inflate(&strm, Z_NO_FLUSH);
+			produced = out.size() - strm.avail_out;
+			full = strm.avail_out == 0;
+			if (ret == Z_STREAM_END)
+				inflateReset(&strm);
+			else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+				inflateEnd(&strm);
+				throw runtime_error("Error during zlib decompression. The file may be corrupted.");
+			}
+		}
+		inflateEnd(&strm);
+		break;
+	}
+#ifdef WITH_ZSTD
+	case CompressionLib::ZSTD: {
+		ZSTD_DCtx* ctx = ZSTD_createDCtx();
+		if (!ctx)
+			throw runtime_error("Error initializing zstd decompressor (ZSTD_createDCtx)");
+		ZSTD_inBuffer in_buf{ in.data(), in.size(), 0 };
+		bool full = false;
+		while (in_buf.pos < in_buf.size || full) {
+			if (produced == out.size())
+				out.resize(out.size() * 2);
+			ZSTD_outBuffer out_buf{ out.data(), out.size(), produced };
+			const size_t ret = ZSTD_decompressStream(ctx, &out_buf, &in_buf);
+			if (ZSTD_isError(ret)) {
+				ZSTD_freeDCtx(ctx);
+				throw runtime_error(std::string("Error during zstd decompression. The file may be corrupted: ") + ZSTD_getErrorName(ret));
+			}
+			produced = out_buf.pos;
+			full = produced == out.size();
+		}
+		ZSTD_freeDCtx(ctx);
+		break;
+	}
+#endif
+	default:
+		throw runtime_error("Invalid compressor in ParallelDecompressor");
+	}
+	out.resize(produced);
+}
+
+ParallelDecompressor::ParallelDecompressor(CompressionLib lib, int threads) :
+	lib_(lib),
+	threads_(threads),
+	max_queued_(2 * threads + 2)
+{
+#ifndef WITH_ZSTD
+	if (lib == CompressionLib::ZSTD)
+		throw runtime_error("Executable was not compiled with ZStd support.");
+#endif
+}
+
+void ParallelDecompressor::enqueue(unique_ptr<Unit>& unit) {
+	unique_lock<mutex> lock(mtx_);
+	space_cv_.wait(lock, [this] { return stop_ || queue_.size() < max_queued_; });
+	if (stop_)
+		return;
+	if (!unit->done) {
+		jobs_.push_back(unit.get());
+		// Only called from the reader thread, which close() joins before the workers.
+		if (workers_.size() < (size_t)threads_)
+			workers_.emplace_back(&ParallelDecompressor::worker, this);
+	}
+	queue_.push_back(std::move(unit));
+	lock.unlock();
+	job_cv_.notify_one();
+	done_cv_.notify_one();
+	unit.reset(new Unit());
+}
+
+bool ParallelDecompressor::stopped() {
+	lock_guard<mutex> lock(mtx_);
+	return stop_;
+}
+
+// Decompresses the remainder of a stream that can not be split into frames in the reader thread.
+void ParallelDecompressor::stream_rest(vector<char>& buf, FILE* stream) {
+	unique_ptr<Unit> unit(new Unit());
+	unit->done = true;
+	unit->out.resize(UNIT_SIZE);
+	size_t produced = 0, in_pos = 0;
+	bool eof = false, full = false;
+	auto fill = [&]() {
+		if (in_pos < buf.size() || eof)
+			return;
+		buf.resize(READ_SIZE);
+		const size_t n = std::fread(buf.data(), 1, READ_SIZE, stream);
+		if (n == 0 && std::ferror(stream))
+			throw runtime_error(std::string("Error reading compressed file: ") + strerror(errno));
+		buf.resize(n);
+		in_pos = 0;
+		eof = n == 0;
+	};
+	auto flush = [&](bool force) {
+		if (produced < unit->out.size() && !(force && produced > 0))
+			return;
+		unit->out.resize(produced);
+		enqueue(unit);
+		unit->done = true;
+		unit->out.resize(UNIT_SIZE);
+		produced = 0;
+	};
+	if (lib_ == CompressionLib::ZLIB) {
+		z_stream strm;
+		strm.zalloc = Z_NULL;
+		strm.zfree = Z_NULL;
+		strm.opaque = Z_NULL;
+		strm.next_in = Z_NULL;
+		strm.avail_in = 0;
+		if (inflateInit2(&strm, 15 + 32) != Z_OK)
+			throw runtime_error("Error initializing zlib decompressor (inflateInit2)");
+		try {
+			for (;;) {
+				fill();
+				if ((eof && !full) || stopped())
+					break;
+				strm.next_in = (Bytef*)buf.data() + in_pos;
+				strm.avail_in = (uInt)(buf.size() - in_pos);
+				strm.next_out = (Bytef*)unit->out.data() + produced;
+				strm.avail_out = (uInt)(unit->out.size() - produced);
+				const int ret = inflate(&strm, Z_NO_FLUSH);
+				in_pos = buf.size() - strm.avail_in;
+				produced = unit->out.size() - strm.avail_out;
+				if (ret == Z_STREAM_END)
+					inflateReset(&strm);
+				else if (ret != Z_OK && ret != Z_BUF_ERROR)
+					throw runtime_error(std::string("Error during zlib decompression. The file may be corrupted: ") + (strm.msg ? strm.msg : "unknown error"));
+				full = produced == unit->out.size();
+				flush(false);
+			}
+		}
+		catch (...) {
+			inflateEnd(&strm);
+			throw;
+		}
+		inflateEnd(&strm);
+	}
+#ifdef WITH_ZSTD
+	else {
+		ZSTD_DStream* strm = ZSTD_createDStream();
+		if (!strm)
+			throw runtime_error("Error initializing zstd decompressor (ZSTD_createDStream)");
+		try {
+			for (;;) {
+				fill();
+				if ((eof && !full) || stopped())
+					break;
+				ZSTD_inBuffer in_buf{ buf.data(), buf.size(), in_pos };
+				ZSTD_outBuffer out_buf{ unit->out.data(), unit->out.size(), produced };
+				const size_t ret = ZSTD_decompressStream(strm, &out_buf, &in_buf);
+				if (ZSTD_isError(ret))
+					throw runtime_error(std::string("Error during zstd decompression. The file may be corrupted: ") + ZSTD_getErrorName(ret));
+				in_pos = in_buf.pos;
+				produced = out_buf.pos;
+				full = produced == unit->out.size();
+				flush(false);
+			}
+		}
+		catch (...) {
+			ZSTD_freeDStream(strm);
+			throw;
+		}
+		ZSTD_freeDStream(strm);
+	}
+#endif
+	flush(true);
+}
+
+void ParallelDecompressor::reader(FILE* stream) {
+	try {
+		vector<char> buf;
+		unique_ptr<Unit> unit(new Unit());
+		bool eof = false;
+		for (;;) {
+			size_t begin = 0;
+			int64_t n;
+			while ((n = frame_size(lib_, buf.data() + begin, buf.size() - begin)) > 0 && (size_t)n <= buf.size() - begin) {
+				unit->in.insert(unit->in.end(), buf.begin() + begin, buf.begin() + begin + n);
+				begin += n;
+				if (unit->in.size() >= UNIT_SIZE)
+					enqueue(unit);
+			}
+			buf.erase(buf.begin(), buf.begin() + begin);
+			if (n < 0 || buf.size() > MAX_FRAME_SIZE || (eof && !buf.empty())) {
+				if (!unit->in.empty())
+					enqueue(unit);
+				stream_rest(buf, stream);
+				break;
+			}
+			if (eof || stopped()) {
+				if (!unit->in.empty())
+					enqueue(unit);
+				break;
+			}
+			const size_t size = buf.size();
+			buf.resize(size + READ_SIZE);
+			const size_t r = std::fread(buf.data() + size, 1, READ_SIZE, stream);
+			if (r == 0 && std::ferror(stream))
+				throw runtime_error(std::string("Error reading compressed file: ") + strerror(errno));
+			buf.resize(size + r);
+			eof = r == 0;
+		}
+	}
+	catch (...) {
+		lock_guard<mutex> lock(mtx_);
+		if (!error_)
+			error_ = std::current_exception();
+	}
+	{
+		lock_guard<mutex> lock(mtx_);
+		input_done_ = true;
+	}
+	job_cv_.notify_all();
+	done_cv_.notify_all();
+}
+
+void ParallelDecompressor::worker() {
+	unique_lock<mutex> lock(mtx_);
+	for (;;) {
+		job_cv_.wait(lock, [this] { return stop_ || input_done_ || !jobs_.empty(); });
+		if (jobs_.empty())
+			return;
+		Unit* unit = jobs_.front();
+		jobs_.pop_front();
+		lock.unlock();
+		std::exception_ptr error;
+		try {
+			decompress_unit(lib_, unit->in, unit->out);
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		vector<char>().swap(unit->in);
+		lock.lock();
+		if (error && !error_)
+			error_ = error;
+		unit->done = true;
+		done_cv_.notify_all();
+	}
+}
+
+bool ParallelDecompressor::next_block(FILE* stream) {
+	if (!started_) {
+		started_ = true;
+		reader_ = std::thread(&ParallelDecompressor::reader, this, stream);
+	}
+	for (;;) {
+		unique_lock<mutex> lock(mtx_);
+		done_cv_.wait(lock, [this] { return error_ || (!queue_.empty() && queue_.front()->done) || (queue_.empty() && input_done_); });
+		if (error_)
+			std::rethrow_exception(error_);
+		if (queue_.empty())
+			return false;
+		cur_.swap(queue_.front()->out);
+		queue_.pop_front();
+		lock.unlock();
+		space_cv_.notify_one();
+		pos_ = 0;
+		if (!cur_.empty())
+			return true;
+	}
+}
+
+size_t ParallelDecompressor::fread(void* buffer, size_t size, size_t count, FILE* stream) {
+	if (size == 0 || count == 0)
+		return 0;
+	const size_t total = size * count;
+	char* out = static_cast<char*>(buffer);
+	size_t produced = 0;
+	if (pushback_ != EOF) {
+		out[produced++] = (char)pushback_;
+		pushback_ = EOF;
+	}
+	while (produced < total) {
+		if (pos_ == cur_.size() && (eos_ || !next_block(stream))) {
+			eos_ = true;
+			break;
+		}
+		const size_t n = std::min(total - produced, cur_.size() - pos_);
+		memcpy(out + produced, cur_.data() + pos_, n);
+		pos_ += n;
+		produced += n;
+	}
+	return produced / size;
+}
+
+int ParallelDecompressor::fgetc(FILE* stream) {
+	if (pushback_ != EOF) {
+		const int c = pushback_;
+		pushback_ = EOF;
+		return c;
+	}
+	if (pos_ == cur_.size() && (eos_ || !next_block(stream))) {
+		eos_ = true;
+		return EOF;
+	}
+	return (unsigned char)cur_[pos_++];
+}
+
+ssize_t ParallelDecompressor::getdelim(char** buf, size_t* buf_size, char delimiter, FILE* fp) {
+	return getdelim_generic(buf, buf_size, delimiter, [this, fp] { return this->ParallelDecompressor::fgetc(fp); });
+}
+
+int ParallelDecompressor::ungetc(int c, FILE* stream) {
+	if (c == EOF)
+		return EOF;
+	if (pushback_ == EOF && pos_ > 0) {
+		cur_[--pos_] = (char)c;
+		return c;
+	}
+	if (pushback_ != EOF)
+		return EOF;
+	pushback_ = (unsigned char)c;
+	return c;
+}
+
+void ParallelDecompressor::close() {
+	{
+		lock_guard<mutex> lock(mtx_);
+		stop_ = true;
+	}
+	job_cv_.notify_all();
+	space_cv_.notify_all();
+	if (reader_.joinable())
+		reader_.join();
+	for (std::thread& t : workers_)
+		t.join();
+	workers_.clear();
+}
+
+void ParallelDecompressor::reset() {
+	close();
+	queue_.clear();
+	jobs_.clear();
+	cur_.clear();
+	pos_ = 0;
+	pushback_ = EOF;
+	error_ = nullptr;
+	started_ = false;
+	eos_ = false;
+	stop_ = false;
+	input_done_ = false;
+}
+
+ParallelDecompressor::~ParallelDecompressor() {
+	close();
+}
@@ -0,0 +1,290 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stdexcept>
+#include <string.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#endif
+#include "unix_socket.h"
+
+using std::runtime_error;
+using std::string;
+
+#ifdef _WIN32
+
+UnixSocket::UnixSocket(int fd, const string& path) :
+	fd_(fd),
+	path_(path)
+{}
+
+UnixSocket::UnixSocket(UnixSocket&& s) noexcept :
+	fd_(s.fd_),
+	path_(std::move(s.path_))
+{}
+
+UnixSocket::~UnixSocket() {}
+
+UnixSocket UnixSocket::listen(const string& path, int backlog) {
+	throw runtime_error("Unix domain sockets are not supported on this platform.");
+}
+
+UnixSocket UnixSocket::connect(const string& path) {
+	throw runtime_error("Unix domain sockets are not supported on this platform.");
+}
+
+UnixSocket UnixSocket::listen_tcp(const string& host, int port, int backlog) {
+	throw runtime_error("Sockets are not supported on this platform.");
+}
+
+UnixSocket UnixSocket::connect_tcp(const string& host, int port) {
+	throw runtime_error("Sockets are not supported on this platform.");
+}
+
+UnixSocket UnixSocket::accept() {
+	throw runtime_error("Unix domain sockets are not supported on this platform.");
+}
+
+bool UnixSocket::wait_readable(int timeout_ms) {
+	return false;
+}
+
+bool UnixSocket::read_exact(void* ptr, size_t n) {
+	return false;
+}
+
+size_t UnixSocket::read(void* ptr, size_t n) {
+	return 0;
+}
+
+void UnixSocket::read_all(string& dst) {}
+
+void UnixSocket::write(const void* ptr, size_t n) {}
+
+void UnixSocket::shutdown_write() {}
+
+void UnixSocket::close() {}
+
+#else
+
+static sockaddr_un address(const string& path) {
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.length() >= sizeof(addr.sun_path))
+		throw runtime_error("Socket path too long: " + path);
+	strcpy(addr.sun_path, path.c_str());
+	return addr;
+}
+
+UnixSocket::UnixSocket(int fd, const string& path) :
+	fd_(fd),
+	path_(path)
+{}
+
+UnixSocket::UnixSocket(UnixSocket&& s) noexcept :
+	fd_(s.fd_),
+	path_(std::move(s.path_))
+{
+	s.fd_ = -1;
+	s.path_.clear();
+}
+
+UnixSocket::~UnixSocket() {
+	close();
+}
+
+UnixSocket UnixSocket::listen(const string& path, int backlog) {
+	const sockaddr_un addr = address(path);
+	const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		throw runtime_error(string("Error creating socket: ") + strerror(errno));
+	unlink(path.c_str());
+	if (bind(fd, (const sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(fd, backlog) != 0) {
+		const int e = errno;
+		::close(fd);
+		throw runtime_error("Error listening on socket " + path + ": " + strerror(e));
+	}
+	return UnixSocket(fd, path);
+}
+
+UnixSocket UnixSocket::connect(const string& path) {
+	const sockaddr_un addr = address(path);
+	const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		throw runtime_error(string("Error creating socket: ") + strerror(errno));
+	if (::connect(fd, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+		const int e = errno;
+		::close(fd);
+		throw runtime_error("Error connecting to socket " + path + ": " + strerror(e));
+	}
+	return UnixSocket(fd, string());
+}
+
+// Resolves host:port, an empty host denotes all local addresses when listening.
+static addrinfo* resolve(const string& host, int port, bool passive) {
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = passive ? AI_PASSIVE : 0;
+	addrinfo* res;
+	const int e = getaddrinfo(host.empty() ? nullptr : host.c_str(), std::to_string(port).c_str(), &hints, &res);
+	if (e != 0)
+		throw runtime_error("Error resolving address " + host + ":" + std::to_string(port) + ": " + gai_strerror(e));
+	return res;
+}
+
+// Has no effect on Unix domain sockets.
+static void set_nodelay(int fd) {
+	const int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+UnixSocket UnixSocket::listen_tcp(const string& host, int port, int backlog) {
+	addrinfo* res = resolve(host, port, true);
+	int fd = -1, e = 0;
+	for (addrinfo* a = res; a != nullptr; a = a->ai_next) {
+		if ((fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol)) < 0) {
+			e = errno;
+			continue;
+		}
+		const int one = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		if (bind(fd, a->ai_addr, a->ai_addrlen) == 0 && ::listen(fd, backlog) == 0)
+			break;
+		e = errno;
+		::close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(res);
+	if (fd < 0)
+		throw runtime_error("Error listening on " + host + ":" + std::to_string(port) + ": " + strerror(e));
+	return UnixSocket(fd, string());
+}
+
+UnixSocket UnixSocket::connect_tcp(const string& host, int port) {
+	addrinfo* res = resolve(host, port, false);
+	int fd = -1, e = 0;
+	for (addrinfo* a = res; a != nullptr; a = a->ai_next) {
+		if ((fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol)) < 0) {
+			e = errno;
+			continue;
+		}
+		if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0)
+			break;
+		e = errno;
+		::close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(res);
+	if (fd < 0)
+		throw runtime_error("Error connecting to " + host + ":" + std::to_string(port) + ": " + strerror(e));
+	set_nodelay(fd);
+	return UnixSocket(fd, string());
+}
+
+UnixSocket UnixSocket::accept() {
+	int fd;
+	while ((fd = ::accept(fd_, nullptr, nullptr)) < 0)
+		if (errno != EINTR)
+			throw runtime_error(string("Error accepting connection: ") + strerror(errno));
+	set_nodelay(fd);
+	return UnixSocket(fd, string());
+}
+
+bool UnixSocket::wait_readable(int timeout_ms) {
+	pollfd p;
+	p.fd = fd_;
+	p.events = POLLIN;
+	p.revents = 0;
+	int r;
+	while ((r = ::poll(&p, 1, timeout_ms)) < 0)
+		if (errno != EINTR)
+			throw runtime_error(string("Error polling socket: ") + strerror(errno));
+	return r > 0;
+}
+
+size_t UnixSocket::read(void* ptr, size_t n) {
+	ssize_t r;
+	while ((r = ::read(fd_, ptr, n)) < 0)
+		if (errno != EINTR)
+			throw runtime_error(string("Error reading from socket: ") + strerror(errno));
+	return (size_t)r;
+}
+
+// Returns false if the connection was closed before the first byte.
+bool UnixSocket::read_exact(void* ptr, size_t n) {
+	char* p = (char*)ptr;
+	size_t total = 0;
+	while (total < n) {
+		const size_t r = read(p + total, n - total);
+		if (r == 0) {
+			if (total == 0)
+				return false;
+			throw runtime_error("Unexpected end of data on socket.");
+		}
+		total += r;
+	}
+	return true;
+}
+
+void UnixSocket::read_all(string& dst) {
+	char buf[65536];
+	size_t n;
+	while ((n = read(buf, sizeof(buf))) > 0)
+		dst.append(buf, n);
+}
+
+void UnixSocket::write(const void* ptr, size_t n) {
+	const char* p = (const char*)ptr;
+	while (n > 0) {
+		const ssize_t r = ::send(fd_, p, n, MSG_NOSIGNAL);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			throw runtime_error(string("Error writing to socket: ") + strerror(errno));
+		}
+		p += r;
+		n -= (size_t)r;
+	}
+}
+
+void UnixSocket::shutdown_write() {
+	::shutdown(fd_, SHUT_WR);
+}
+
+void UnixSocket::close() {
+	if (fd_ >= 0)
+		::close(fd_);
+	fd_ = -1;
+	if (!path_.empty())
+		unlink(path_.c_str());
+	path_.clear();
+}
+
+#endif
@@ -0,0 +1,55 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <string>
+#include <stddef.h>
+
+// Stream socket connection, on a Unix domain socket or over TCP.
+struct UnixSocket {
+
+	UnixSocket(UnixSocket&& s) noexcept;
+	UnixSocket(const UnixSocket&) = delete;
+	UnixSocket& operator=(const UnixSocket&) = delete;
+	~UnixSocket();
+	static UnixSocket listen(const std::string& path, int backlog = 16);
+	static UnixSocket connect(const std::string& path);
+	static UnixSocket listen_tcp(const std::string& host, int port, int backlog = 16);
+	static UnixSocket connect_tcp(const std::string& host, int port);
+	UnixSocket accept();
+	// Waits up to timeout_ms for data or, on a listening socket, a pending connection.
+	bool wait_readable(int timeout_ms);
+	size_t read(void* ptr, size_t n);
+	bool read_exact(void* ptr, size_t n);
+	void read_all(std::string& dst);
+	void write(const void* ptr, size_t n);
+	void write(const std::string& s) {
+		write(s.data(), s.size());
+	}
+	void shutdown_write();
+	void close();
+
+private:
+
+	UnixSocket(int fd, const std::string& path);
+
+	int fd_;
+	std::string path_;
+
+};
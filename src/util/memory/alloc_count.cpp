@@ -0,0 +1,56 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stdlib.h>
+#include <new>
+#include "alloc_count.h"
+
+#ifdef DP_STAT
+
+static thread_local uint64_t alloc_count = 0;
+
+void* operator new(size_t n) {
+	++alloc_count;
+	void* p = malloc(n == 0 ? 1 : n);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept {
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+#endif
+
+namespace Util { namespace Memory {
+
+uint64_t thread_alloc_count() {
+#ifdef DP_STAT
+	return alloc_count;
+#else
+	return 0;
+#endif
+}
+
+}}
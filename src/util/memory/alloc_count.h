@@ -0,0 +1,35 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <stdint.h>
+
+namespace Util { namespace Memory {
+
+// Heap allocations made through operator new by the calling thread. They are only counted in builds with
+// DP_STAT, since counting replaces the global operator new.
+#ifdef DP_STAT
+constexpr bool ALLOC_COUNT = true;
+#else
+constexpr bool ALLOC_COUNT = false;
+#endif
+
+uint64_t thread_alloc_count();
+
+}}
@@ -0,0 +1,65 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "arena.h"
+
+namespace Util { namespace Memory {
+
+static thread_local ThreadArenas* current_arenas = nullptr;
+
+std::atomic<uint64_t> ThreadArenas::next_id_(1);
+
+ThreadArenas::ThreadArenas():
+	id_(next_id_.fetch_add(1, std::memory_order_relaxed))
+{}
+
+std::pmr::memory_resource* ThreadArenas::local() {
+#ifdef HAVE_MEMORY_RESOURCE
+	// Ids are never reused, unlike addresses, so a cached arena of a destroyed object is never returned.
+	static thread_local uint64_t cached_id = 0;
+	static thread_local std::pmr::memory_resource* cached = nullptr;
+	if (cached_id == id_)
+		return cached;
+	std::lock_guard<std::mutex> lock(mtx_);
+	std::unique_ptr<std::pmr::monotonic_buffer_resource>& r = arenas_[std::this_thread::get_id()];
+	if (!r)
+		r.reset(new std::pmr::monotonic_buffer_resource(INITIAL_SIZE));
+	cached_id = id_;
+	cached = r.get();
+	return cached;
+#else
+	return nullptr;
+#endif
+}
+
+ThreadArenas* ThreadArenas::current() {
+	return current_arenas;
+}
+
+ArenaScope::ArenaScope(ThreadArenas* arenas):
+	prev_(current_arenas)
+{
+	current_arenas = arenas;
+}
+
+ArenaScope::~ArenaScope() {
+	current_arenas = prev_;
+}
+
+}}
@@ -0,0 +1,131 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "memory_resource.h"
+
+namespace Util { namespace Memory {
+
+/* Per-thread monotonic arenas for the objects of one alignment task (a query in align_worker).
+   Each thread allocating through an ArenaAllocator bound to this object gets its own arena, so the
+   arenas are never shared between threads. Deallocation is a no-op; all memory is released when
+   the ThreadArenas object is destroyed, which must outlive the containers allocated from it. */
+struct ThreadArenas {
+
+	ThreadArenas();
+	ThreadArenas(const ThreadArenas&) = delete;
+	ThreadArenas& operator=(const ThreadArenas&) = delete;
+
+	// The arena of the calling thread, created on first use.
+	std::pmr::memory_resource* local();
+	// The arenas made current on this thread by ArenaScope, or nullptr.
+	static ThreadArenas* current();
+
+private:
+
+	static constexpr size_t INITIAL_SIZE = 64 * 1024;
+	static std::atomic<uint64_t> next_id_;
+
+	const uint64_t id_;
+	std::mutex mtx_;
+	std::map<std::thread::id, std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas_;
+
+	friend struct ArenaScope;
+
+};
+
+// Makes arenas the default storage of ArenaAllocators constructed on this thread for the lifetime
+// of the scope. A null pointer selects the heap, e.g. to copy objects out of an arena.
+struct ArenaScope {
+	ArenaScope(ThreadArenas* arenas);
+	~ArenaScope();
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+private:
+	ThreadArenas* const prev_;
+};
+
+// Allocates from the current ThreadArenas at the time of construction, or from the heap outside
+// of an ArenaScope. Moves and swaps carry the arena along; copies select the current scope again.
+template<typename T>
+struct ArenaAllocator {
+
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	ArenaAllocator() noexcept :
+		arenas_(ThreadArenas::current())
+	{}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& a) noexcept :
+		arenas_(a.arenas())
+	{}
+
+	T* allocate(size_t n) {
+#ifdef HAVE_MEMORY_RESOURCE
+		if (arenas_)
+			return static_cast<T*>(arenas_->local()->allocate(n * sizeof(T), alignof(T)));
+#endif
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, size_t n) noexcept {
+#ifdef HAVE_MEMORY_RESOURCE
+		if (arenas_)
+			return;
+#endif
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	ArenaAllocator select_on_container_copy_construction() const {
+		return ArenaAllocator();
+	}
+
+	ThreadArenas* arenas() const noexcept {
+		return arenas_;
+	}
+
+private:
+
+	ThreadArenas* arenas_;
+
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+	return a.arenas() == b.arenas();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+	return a.arenas() != b.arenas();
+}
+
+}}
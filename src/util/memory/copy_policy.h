@@ -0,0 +1,59 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <memory>
+#include <utility>
+
+namespace Util { namespace Memory {
+
+// Member wrapper for per-object state that is not copied, such as mutexes, thread pools and buffers owned
+// through unique_ptr. A copy starts with a default constructed value, so that the enclosing struct can use
+// a defaulted copy constructor.
+template<typename T>
+struct ResetOnCopy : T {
+	using T::T;
+	ResetOnCopy() = default;
+	ResetOnCopy(const ResetOnCopy&) :
+		T()
+	{}
+	ResetOnCopy(ResetOnCopy&&) = default;
+	ResetOnCopy& operator=(const ResetOnCopy&) = delete;
+	ResetOnCopy& operator=(ResetOnCopy&&) = default;
+	template<typename U>
+	ResetOnCopy& operator=(U&& x) {
+		T::operator=(std::forward<U>(x));
+		return *this;
+	}
+};
+
+// Owning pointer whose copies hold a copy of the pointee made by its clone() member.
+template<typename T>
+struct ClonePtr : std::unique_ptr<T> {
+	using std::unique_ptr<T>::unique_ptr;
+	ClonePtr() = default;
+	ClonePtr(const ClonePtr& p) :
+		std::unique_ptr<T>(p ? p->clone() : nullptr)
+	{}
+	ClonePtr(ClonePtr&&) = default;
+	ClonePtr& operator=(const ClonePtr&) = delete;
+	ClonePtr& operator=(ClonePtr&&) = default;
+};
+
+}}
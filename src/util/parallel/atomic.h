@@ -65,6 +65,10 @@ struct Atomic {
 	}
 
 	void await(int64_t n) {
+		if (Coordinator* coordinator = Coordinator::get()) {
+			coordinator->await_count(stack_.file_name(), n);
+			return;
+		}
 		for (;;) {
 			int64_t i;
 			stack_.top(i);
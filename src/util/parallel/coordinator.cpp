@@ -0,0 +1,446 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <stdlib.h>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+#include "coordinator.h"
+#include "util/io/unix_socket.h"
+#include "util/log_stream.h"
+
+using std::string;
+using std::vector;
+using std::runtime_error;
+using std::mutex;
+using std::unique_lock;
+using std::endl;
+
+// Not destroyed, so that stacks can still be accessed from static destructors.
+Coordinator* Coordinator::instance_ = nullptr;
+
+namespace {
+
+struct RequestHeader {
+	uint8_t op, reserved[7];
+	int64_t n, timeout_ms;
+	uint64_t key_len, data_len;
+};
+
+struct ReplyHeader {
+	int64_t value;
+	uint64_t data_len;
+};
+
+// Sent by the client on each new connection, followed by the token.
+struct Handshake {
+	uint64_t magic, token_len;
+};
+
+const uint64_t HANDSHAKE_MAGIC = 0x2d8e5a1c7f3b9064;
+const uint64_t MAX_TOKEN_LENGTH = 4096;
+const int ACCEPT_POLL_MS = 200;
+const char* const STOP = "STOP";
+const int CONNECT_ATTEMPTS = 100;
+const int CONNECT_RETRY_MS = 100;
+
+// host:port denotes a TCP address, anything else the path of a Unix socket.
+bool tcp_address(const string& address, string& host, int& port) {
+	const size_t i = address.rfind(':');
+	if (i == string::npos || address.find('/') != string::npos)
+		return false;
+	const string p = address.substr(i + 1);
+	if (p.empty() || p.length() > 5 || p.find_first_not_of("0123456789") != string::npos)
+		return false;
+	host = address.substr(0, i);
+	port = std::stoi(p);
+	return true;
+}
+
+// An address without host refers to the local coordinator.
+string tcp_connect_host(const string& host) {
+	return host.empty() ? string("127.0.0.1") : host;
+}
+
+bool loopback(const string& host) {
+	return host == "localhost" || host == "::1" || host == "[::1]" || host.compare(0, 4, "127.") == 0;
+}
+
+// Compares in time independent of the position of the first mismatch.
+bool token_equal(const string& a, const string& b) {
+	if (a.length() != b.length())
+		return false;
+	unsigned char d = 0;
+	for (size_t i = 0; i < a.length(); ++i)
+		d |= (unsigned char)(a[i] ^ b[i]);
+	return d == 0;
+}
+
+string read_string(UnixSocket& socket, uint64_t n) {
+	string s(n, '\0');
+	if (n > 0 && !socket.read_exact(&s[0], n))
+		throw runtime_error("Unexpected end of data on socket.");
+	return s;
+}
+
+// Splits the text into lines as FileStack stores it, a trailing newline does not start a new line.
+void append_lines(const string& text, vector<string>& lines) {
+	size_t begin = 0;
+	while (begin < text.length()) {
+		const size_t end = std::min(text.find('\n', begin), text.length());
+		lines.emplace_back(text, begin, end - begin);
+		begin = end + 1;
+	}
+}
+
+struct Server {
+
+	Server(const string& token):
+		token_(token),
+		stopped_(false)
+	{}
+
+	bool stopped() const {
+		return stopped_.load();
+	}
+
+	Coordinator::Reply handle(const Coordinator::Request& r) {
+		using Op = Coordinator::Op;
+		Coordinator::Reply reply{ 0, string() };
+		unique_lock<mutex> lock(mtx_);
+		switch (r.op) {
+		case Op::PUSH: {
+			vector<string>& s = stacks_[r.key];
+			if (r.data.empty())
+				s.emplace_back();
+			else
+				append_lines(r.data, s);
+			reply.value = (int64_t)s.size();
+			break;
+		}
+		case Op::POP: {
+			auto it = stacks_.find(r.key);
+			if (it == stacks_.end() || it->second.empty()) {
+				reply.value = -1;
+				break;
+			}
+			reply.data = std::move(it->second.back());
+			it->second.pop_back();
+			reply.value = (int64_t)it->second.size();
+			break;
+		}
+		case Op::TOP: {
+			const vector<string>* s = find(r.key);
+			if (s == nullptr || s->empty())
+				reply.value = -1;
+			else
+				reply.data = s->back();
+			break;
+		}
+		case Op::SIZE: {
+			const vector<string>* s = find(r.key);
+			reply.value = s ? (int64_t)s->size() : 0;
+			break;
+		}
+		case Op::CLEAR:
+			stacks_[r.key].clear();
+			break;
+		case Op::REMOVE_LINE: {
+			auto it = stacks_.find(r.key);
+			if (it != stacks_.end())
+				it->second.erase(std::remove(it->second.begin(), it->second.end(), r.data), it->second.end());
+			break;
+		}
+		case Op::ERASE:
+			stacks_.erase(r.key);
+			break;
+		case Op::FETCH_ADD: {
+			vector<string>& s = stacks_[r.key];
+			const int64_t i = std::max(counter(&s), (int64_t)0);
+			if (!s.empty())
+				s.pop_back();
+			s.push_back(std::to_string(i + r.n));
+			reply.value = i;
+			break;
+		}
+		case Op::LOAD:
+			if (stacks_.find(r.key) == stacks_.end()) {
+				append_lines(r.data, stacks_[r.key]);
+				reply.value = 1;
+			}
+			break;
+		case Op::AWAIT_COUNT:
+			reply.value = wait(lock, r.timeout_ms, [&]() { return counter(find(r.key)) >= r.n; });
+			break;
+		case Op::AWAIT_SIZE:
+			reply.value = wait(lock, r.timeout_ms, [&]() {
+				const vector<string>* s = find(r.key);
+				return (int64_t)(s ? s->size() : 0) == r.n;
+				});
+			break;
+		case Op::SHUTDOWN:
+			stopped_ = true;
+			break;
+		case Op::AWAIT_TOP: {
+			const auto top = [&]() {
+				const vector<string>* s = find(r.key);
+				return (s == nullptr || s->empty()) ? string() : s->back();
+			};
+			reply.value = wait(lock, r.timeout_ms, [&]() {
+				const string t = top();
+				return t.find(r.data) != string::npos || t.find(STOP) != string::npos;
+				});
+			reply.data = top();
+			break;
+		}
+		default:
+			throw runtime_error("Invalid coordinator request.");
+		}
+		lock.unlock();
+		if (r.op != Op::POP || reply.value >= 0)
+			cv_.notify_all();
+		return reply;
+	}
+
+	void serve(UnixSocket socket) {
+		try {
+			Handshake hs;
+			if (!socket.read_exact(&hs, sizeof(hs)))
+				return;
+			if (hs.magic != HANDSHAKE_MAGIC || hs.token_len > MAX_TOKEN_LENGTH)
+				throw runtime_error("Invalid handshake.");
+			const bool accepted = token_equal(read_string(socket, hs.token_len), token_);
+			const ReplyHeader hr{ accepted ? 1 : 0, 0 };
+			socket.write(&hr, sizeof(hr));
+			if (!accepted)
+				throw runtime_error("Client rejected, invalid token.");
+			RequestHeader h;
+			while (socket.read_exact(&h, sizeof(h))) {
+				Coordinator::Request r{ (Coordinator::Op)h.op, h.n, h.timeout_ms, read_string(socket, h.key_len), read_string(socket, h.data_len) };
+				const Coordinator::Reply reply = handle(r);
+				const ReplyHeader rh{ reply.value, reply.data.length() };
+				socket.write(&rh, sizeof(rh));
+				socket.write(reply.data);
+			}
+		}
+		catch (std::exception& e) {
+			std::cerr << "Coordinator connection error: " << e.what() << endl;
+		}
+	}
+
+private:
+
+	const vector<string>* find(const string& key) const {
+		auto it = stacks_.find(key);
+		return it == stacks_.end() ? nullptr : &it->second;
+	}
+
+	static int64_t counter(const vector<string>* s) {
+		return (s == nullptr || s->empty()) ? -1 : std::stoll(s->back());
+	}
+
+	template<typename Pred>
+	bool wait(unique_lock<mutex>& lock, int64_t timeout_ms, Pred pred) {
+		if (timeout_ms <= 0) {
+			cv_.wait(lock, pred);
+			return true;
+		}
+		return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), pred);
+	}
+
+	const string token_;
+	std::atomic<bool> stopped_;
+	mutex mtx_;
+	std::condition_variable cv_;
+	std::unordered_map<string, vector<string>> stacks_;
+
+};
+
+}
+
+Coordinator::Coordinator(const string& address, const string& token):
+	address_(address),
+	token_(token)
+{}
+
+Coordinator::~Coordinator() {}
+
+Coordinator* Coordinator::get() {
+	return instance_;
+}
+
+void Coordinator::init(const string& address, const string& token) {
+	if (instance_ != nullptr)
+		throw runtime_error("Coordinator is already initialized.");
+	instance_ = new Coordinator(address, token);
+}
+
+string Coordinator::token(const string& option) {
+	if (!option.empty())
+		return option;
+	const char* env = getenv("DIAMOND_COORDINATOR_TOKEN");
+	return env ? string(env) : string();
+}
+
+// Retries for a while so that workers may be started together with the coordinator.
+UnixSocket Coordinator::connect() const {
+	string host;
+	int port;
+	const bool tcp = tcp_address(address_, host, port);
+	std::unique_ptr<UnixSocket> socket;
+	for (int i = 1; !socket; ++i) {
+		try {
+			socket.reset(new UnixSocket(tcp ? UnixSocket::connect_tcp(tcp_connect_host(host), port) : UnixSocket::connect(address_)));
+		}
+		catch (std::runtime_error&) {
+			if (i == CONNECT_ATTEMPTS)
+				throw;
+			std::this_thread::sleep_for(std::chrono::milliseconds(CONNECT_RETRY_MS));
+		}
+	}
+	const Handshake h{ HANDSHAKE_MAGIC, token_.length() };
+	socket->write(&h, sizeof(h));
+	socket->write(token_);
+	ReplyHeader r;
+	if (!socket->read_exact(&r, sizeof(r)) || r.value != 1)
+		throw runtime_error("The coordinator rejected the connection, invalid token (--coordinator-token): " + address_);
+	return std::move(*socket);
+}
+
+Coordinator::Reply Coordinator::request(UnixSocket& socket, const Request& r) {
+	RequestHeader h;
+	h.op = (uint8_t)r.op;
+	std::fill(h.reserved, h.reserved + sizeof(h.reserved), 0);
+	h.n = r.n;
+	h.timeout_ms = r.timeout_ms;
+	h.key_len = r.key.length();
+	h.data_len = r.data.length();
+	socket.write(&h, sizeof(h));
+	socket.write(r.key);
+	socket.write(r.data);
+	ReplyHeader rh;
+	if (!socket.read_exact(&rh, sizeof(rh)))
+		throw runtime_error("Connection to the coordinator was closed: " + address_);
+	return Reply{ rh.value, read_string(socket, rh.data_len) };
+}
+
+// Requests that may block are sent on a connection of their own, so that other threads of this
+// process can still use the shared one.
+Coordinator::Reply Coordinator::request(const Request& r) {
+	if (r.op == Op::AWAIT_COUNT || r.op == Op::AWAIT_SIZE || r.op == Op::AWAIT_TOP) {
+		UnixSocket socket = connect();
+		return request(socket, r);
+	}
+	std::lock_guard<mutex> lock(mtx_);
+	if (!socket_)
+		socket_.reset(new UnixSocket(connect()));
+	return request(*socket_, r);
+}
+
+size_t Coordinator::push(const string& key, const string& line) {
+	return (size_t)request({ Op::PUSH, 0, 0, key, line }).value;
+}
+
+bool Coordinator::pop(const string& key, string& line, size_t& size_after_pop) {
+	Reply r = request({ Op::POP, 0, 0, key, string() });
+	line = std::move(r.data);
+	size_after_pop = r.value >= 0 ? (size_t)r.value : 0;
+	return r.value >= 0;
+}
+
+bool Coordinator::top(const string& key, string& line) {
+	Reply r = request({ Op::TOP, 0, 0, key, string() });
+	line = std::move(r.data);
+	return r.value >= 0;
+}
+
+size_t Coordinator::size(const string& key) {
+	return (size_t)request({ Op::SIZE, 0, 0, key, string() }).value;
+}
+
+void Coordinator::clear(const string& key) {
+	request({ Op::CLEAR, 0, 0, key, string() });
+}
+
+void Coordinator::remove(const string& key, const string& line) {
+	request({ Op::REMOVE_LINE, 0, 0, key, line });
+}
+
+void Coordinator::erase(const string& key) {
+	request({ Op::ERASE, 0, 0, key, string() });
+}
+
+int64_t Coordinator::fetch_add(const string& key, int64_t n) {
+	return request({ Op::FETCH_ADD, n, 0, key, string() }).value;
+}
+
+void Coordinator::load(const string& key, const string& file_name) {
+	std::ifstream f(file_name, std::ios::binary);
+	std::ostringstream ss;
+	if (f)
+		ss << f.rdbuf();
+	request({ Op::LOAD, 0, 0, key, ss.str() });
+}
+
+void Coordinator::await_count(const string& key, int64_t n) {
+	request({ Op::AWAIT_COUNT, n, 0, key, string() });
+}
+
+bool Coordinator::await_size(const string& key, size_t n, double timeout_s) {
+	return request({ Op::AWAIT_SIZE, (int64_t)n, std::max((int64_t)(timeout_s * 1000), (int64_t)1), key, string() }).value != 0;
+}
+
+bool Coordinator::await_top(const string& key, const string& query, string& line, double timeout_s) {
+	Reply r = request({ Op::AWAIT_TOP, 0, std::max((int64_t)(timeout_s * 1000), (int64_t)1), key, query });
+	line = std::move(r.data);
+	return r.value != 0;
+}
+
+void Coordinator::shutdown() {
+	request({ Op::SHUTDOWN, 0, 0, string(), string() });
+}
+
+void run_coordinator(const string& address, const string& token) {
+	string host;
+	int port;
+	const bool tcp = tcp_address(address, host, port);
+	if (tcp && host.empty())
+		host = "127.0.0.1";
+	if (tcp && !loopback(host) && token.empty())
+		throw runtime_error("Listening on a non-loopback address requires a token (--coordinator-token or DIAMOND_COORDINATOR_TOKEN).");
+	UnixSocket listener = tcp ? UnixSocket::listen_tcp(host, port) : UnixSocket::listen(address);
+	*message_stream << "Coordinator listening on " << (tcp ? host + ':' + std::to_string(port) : address) << endl;
+	// Not destroyed, detached connection threads may still use it at exit.
+	Server* server = new Server(token);
+	while (!server->stopped()) {
+		if (!listener.wait_readable(ACCEPT_POLL_MS))
+			continue;
+		UnixSocket conn = listener.accept();
+		std::thread(&Server::serve, server, std::move(conn)).detach();
+	}
+	*message_stream << "Coordinator shutting down." << endl;
+}
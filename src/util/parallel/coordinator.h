@@ -0,0 +1,93 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <memory>
+#include <mutex>
+
+struct UnixSocket;
+
+/* Coordination backend for multi-process runs (--multiprocessing, multinode clustering) that keeps the
+   shared stacks of FileStack in the memory of a coordinator process (diamond coordinator) instead of in
+   locked files on a shared filesystem. Stacks are identified by their file names and have the same line
+   semantics, counters are stacks whose top line is an integer. Waiting operations block on the
+   coordinator instead of polling. The address is host:port for TCP or the path of a Unix socket. Clients
+   authenticate with a shared token (--coordinator-token or $DIAMOND_COORDINATOR_TOKEN) when connecting. */
+struct Coordinator {
+
+	enum class Op : uint8_t { PUSH, POP, TOP, SIZE, CLEAR, REMOVE_LINE, ERASE, FETCH_ADD, LOAD, AWAIT_COUNT, AWAIT_SIZE, AWAIT_TOP, SHUTDOWN };
+
+	struct Request {
+		Op op;
+		int64_t n, timeout_ms;
+		std::string key, data;
+	};
+
+	struct Reply {
+		int64_t value;
+		std::string data;
+	};
+
+	Coordinator(const std::string& address, const std::string& token);
+	~Coordinator();
+
+	// Returns the number of lines of the stack after the push.
+	size_t push(const std::string& key, const std::string& line);
+	bool pop(const std::string& key, std::string& line, size_t& size_after_pop);
+	bool top(const std::string& key, std::string& line);
+	size_t size(const std::string& key);
+	void clear(const std::string& key);
+	void remove(const std::string& key, const std::string& line);
+	void erase(const std::string& key);
+	int64_t fetch_add(const std::string& key, int64_t n);
+	// Initializes the stack from the lines of a file unless it already exists on the coordinator.
+	void load(const std::string& key, const std::string& file_name);
+	// Blocks until the integer on top of the stack is at least n.
+	void await_count(const std::string& key, int64_t n);
+	// Returns false on timeout.
+	bool await_size(const std::string& key, size_t n, double timeout_s);
+	// Blocks until the top line contains the query or STOP and returns the top line, false on timeout.
+	bool await_top(const std::string& key, const std::string& query, std::string& line, double timeout_s);
+	// Stops the coordinator process.
+	void shutdown();
+
+	// The coordinator set by --coordinator, or nullptr for the shared filesystem backend.
+	static Coordinator* get();
+	static void init(const std::string& address, const std::string& token);
+	// The token given by --coordinator-token, or by $DIAMOND_COORDINATOR_TOKEN if the option is not set.
+	static std::string token(const std::string& option);
+
+private:
+
+	Reply request(const Request& request);
+	Reply request(UnixSocket& socket, const Request& request);
+	UnixSocket connect() const;
+
+	const std::string address_, token_;
+	std::unique_ptr<UnixSocket> socket_;
+	std::mutex mtx_;
+
+	static Coordinator* instance_;
+
+};
+
+// Listens on loopback for a TCP address without host. Other hosts require a token.
+void run_coordinator(const std::string& address, const std::string& token);
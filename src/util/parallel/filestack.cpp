@@ -59,7 +59,10 @@ FileStack::FileStack() : FileStack::FileStack(default_file_name) {
 
 void FileStack::remove() {
     close();
-	remove_tmp_file(file_name_);
+    if (coordinator_)
+        coordinator_->erase(file_name_);
+    else
+        remove_tmp_file(file_name_);
 }
 
 FileStack::FileStack(const string & file_name) : FileStack::FileStack(file_name, default_max_line_length) {
@@ -80,15 +83,36 @@ void FileStack::close() {
 }
 
 FileStack::FileStack(const string & file_name, int maximum_line_length):
-    file_name_(file_name)
+    file_name_(file_name),
+    coordinator_(nullptr)
 {
+    open(maximum_line_length);
+}
+
+FileStack::FileStack(const string & file_name, Coordinator* coordinator):
+    file_name_(file_name),
+    coordinator_(coordinator)
+{
+    if (coordinator_) {
+#ifdef _WIN32
+        hFile = INVALID_HANDLE_VALUE;
+#else
+        fd = -1;
+#endif
+        set_max_line_length(default_max_line_length);
+    }
+    else
+        open(default_max_line_length);
+}
+
+void FileStack::open(int maximum_line_length) {
 #ifdef _WIN32
-    hFile = CreateFile(TEXT(file_name.c_str()), FILE_GENERIC_WRITE | FILE_GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    hFile = CreateFile(TEXT(file_name_.c_str()), FILE_GENERIC_WRITE | FILE_GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
     if (hFile == INVALID_HANDLE_VALUE)
         throw std::runtime_error("Error opening file " + file_name_);
 #else
     DBG("");
-    fd = open(file_name.c_str(), O_RDWR | O_CREAT, 00664);
+    fd = ::open(file_name_.c_str(), O_RDWR | O_CREAT, 00664);
     if (fd == -1) {
         throw(std::runtime_error("could not open file " + file_name_));
     }
@@ -102,6 +126,8 @@ FileStack::~FileStack() {
 
 int FileStack::lock() {
     mtx_.lock();
+    if (coordinator_)
+        return 0;
 #ifdef _WIN32
     OVERLAPPED overlapvar;
     overlapvar.Offset = 0;
@@ -130,6 +156,10 @@ int FileStack::lock() {
 }
 
 int FileStack::unlock() {
+    if (coordinator_) {
+        mtx_.unlock();
+        return 0;
+    }
 #ifdef _WIN32
     OVERLAPPED overlapvar;
     overlapvar.Offset = 0;
@@ -205,6 +235,20 @@ int FileStack::truncate(size_t size) {
 int64_t FileStack::pop_non_locked(string & buf, const bool keep_flag, size_t & size_after_pop) {
     DBG("");
     buf.clear();
+    if (coordinator_) {
+        size_t n = 0;
+        if (keep_flag) {
+            coordinator_->top(file_name_, buf);
+            if (size_after_pop != numeric_limits<size_t>::max())
+                size_after_pop = coordinator_->size(file_name_);
+        }
+        else {
+            coordinator_->pop(file_name_, buf, n);
+            if (size_after_pop != numeric_limits<size_t>::max())
+                size_after_pop = n;
+        }
+        return buf.size();
+    }
     int stat = 0;
     const int64_t size = seek(0, SEEK_END);
     if (size > 0) {
@@ -312,6 +356,10 @@ int64_t FileStack::top(int64_t& i) {
 
 void FileStack::remove(const string & line) {
     DBG("");
+    if (coordinator_) {
+        coordinator_->remove(file_name_, line);
+        return;
+    }
     lock();
     const int64_t size = seek(0, SEEK_END);
     seek(0, SEEK_SET);
@@ -340,6 +388,10 @@ void FileStack::remove(const string & line) {
 int64_t FileStack::push_exclusive(const string & buf) {
     DBG("");
     static const string nl("\n");
+    if (coordinator_) {
+        coordinator_->push(file_name_, buf);
+        return buf.size() + (buf.back() != nl.back() ? 1 : 0);
+    }
     seek(0, SEEK_END);
     size_t n = write(buf.c_str(), buf.size());
     if (buf.back() != nl.back()) {
@@ -350,6 +402,12 @@ int64_t FileStack::push_exclusive(const string & buf) {
 
 int64_t FileStack::push(const string & buf, size_t & size_after_push) {
     DBG("");
+    if (coordinator_) {
+        const size_t n = coordinator_->push(file_name_, buf);
+        if (size_after_push != numeric_limits<size_t>::max())
+            size_after_push = n;
+        return buf.size() + (buf.back() != '\n' ? 1 : 0);
+    }
     lock();
     int64_t n = push_exclusive(buf);
     if (size_after_push != numeric_limits<size_t>::max()) {
@@ -392,6 +450,8 @@ size_t FileStack::size() {
 
 size_t FileStack::size_unlocked() {
     DBG("");
+    if (coordinator_)
+        return coordinator_->size(file_name_);
     size_t c = 0;
     const size_t chunk_size = default_max_line_length;
     char * raw = new char[chunk_size * sizeof(char)];
@@ -412,6 +472,10 @@ size_t FileStack::size_unlocked() {
 
 int FileStack::clear() {
     DBG("");
+    if (coordinator_) {
+        coordinator_->clear(file_name_);
+        return 0;
+    }
     lock();
     seek(0, SEEK_SET);
     int stat = truncate(0);
@@ -422,6 +486,14 @@ int FileStack::clear() {
 bool FileStack::poll_query(const string & query, const double sleep_s, const size_t max_iter) {
     DBG("");
     string buf;
+    if (coordinator_) {
+        if (!coordinator_->await_top(file_name_, query, buf, double(max_iter) * sleep_s))
+            throw(runtime_error("Could not discover keyword " + query + " on FileStack " + file_name_
+                + " within " + to_string(double(max_iter) * sleep_s) + " seconds."));
+        if (buf.find(query) == string::npos && buf.find("STOP") != string::npos)
+            throw(runtime_error("STOP on FileStack " + file_name_));
+        return true;
+    }
     const std::chrono::duration<double> sleep_time(sleep_s);
     for (size_t i=0; i < max_iter; ++i) {
         top(buf);
@@ -444,8 +516,10 @@ bool FileStack::poll_query(const string & query, const double sleep_s, const siz
 bool FileStack::poll_size(const size_t size, const double sleep_s, const size_t max_iter) {
     DBG("");
     string buf;
+    if (coordinator_ && coordinator_->await_size(file_name_, size, double(max_iter) * sleep_s))
+        return true;
     const std::chrono::duration<double> sleep_time(sleep_s);
-    for (size_t i=0; i < max_iter; ++i) {
+    for (size_t i=0; i < max_iter && !coordinator_; ++i) {
         if (this->size() == size) {
             return true;
         }
@@ -475,6 +549,8 @@ int FileStack::get_max_line_length() {
 
 
 int64_t FileStack::fetch_add(int64_t n) {
+    if (coordinator_)
+        return coordinator_->fetch_add(file_name_, n);
     string s;
     lock();
     int64_t i;
@@ -31,6 +31,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <fcntl.h>
 #endif
 
+#include "coordinator.h"
+
 #ifdef DEBUG
 #define DBG(x) (std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << " " << x << std::endl)
 #else
@@ -42,13 +44,15 @@ class FileStack {
         FileStack();
         FileStack(const std::string & file_name);
         FileStack(const std::string & file_name, int maximum_line_length);
+        // Keeps the stack on the coordinator if one is given, otherwise in the file.
+        FileStack(const std::string & file_name, Coordinator* coordinator);
         ~FileStack();
         void close();
         template<typename Job>
         FileStack(const std::string& file_name, Job& job):
-            FileStack(file_name)
+            FileStack(file_name, Coordinator::get())
         {
-            job.register_sync_file(file_name);
+            job.register_sync_file(file_name, coordinator_ != nullptr);
 		}
 
         size_t size();
@@ -87,6 +91,7 @@ class FileStack {
 
     private:
         
+        void open(int maximum_line_length);
         int lock();
         int unlock();
         size_t size_unlocked();
@@ -99,6 +104,7 @@ class FileStack {
 #endif
         std::string file_name_;
         off_t max_line_length;
+        Coordinator* coordinator_;
 
         int pop(std::string &, const bool, size_t &);
         int64_t pop_non_locked(std::string &, const bool, size_t &);
@@ -143,10 +143,10 @@ bool Parallelizer::barrier(const string & tag) {
 
     auto cmd_file_name = get_barrier_file_name("cmd", tag, i_barrier);
     DBG(cmd_file_name);
-    FileStack cmd_fs(cmd_file_name);
+    FileStack cmd_fs(cmd_file_name, Coordinator::get());
     auto ack_file_name = get_barrier_file_name("ack", tag, i_barrier);
     DBG(ack_file_name);
-    FileStack ack_fs(ack_file_name);
+    FileStack ack_fs(ack_file_name, Coordinator::get());
 
     static const string msg = "WAIT";
     if (is_master()) {
@@ -211,7 +211,11 @@ bool Parallelizer::create_stack(const std::string & tag, std::string sfx) {
 
 bool Parallelizer::create_stack_from_file(const std::string & tag, const std::string & file_name) {
     delete_stack(tag);
-    fs_map.emplace(tag, shared_ptr<FileStack>(new FileStack(file_name)));
+    // The log of each process stays in its file.
+    Coordinator* coordinator = tag == LOG ? nullptr : Coordinator::get();
+    if (coordinator)
+        coordinator->load(file_name, file_name);
+    fs_map.emplace(tag, shared_ptr<FileStack>(new FileStack(file_name, coordinator)));
     DBG(file_name);
     return true;
 }
@@ -241,6 +245,8 @@ void Parallelizer::sleep(const double sleep_s) {
 
 bool Parallelizer::clean(vector<string> & file_list) {
     for (auto s : file_list) {
+        if (Coordinator::get())
+            Coordinator::get()->erase(s);
         errno = 0;
         UNLINK(s.c_str());
     }
@@ -107,6 +107,19 @@ public:
 #endif
     }
 
+    bool try_acquire() {
+#if defined(__APPLE__)
+        return dispatch_semaphore_wait(sem, DISPATCH_TIME_NOW) == 0;
+#else
+        int32_t old = count.load(std::memory_order_relaxed);
+        while (old > 0) {
+            if (count.compare_exchange_weak(old, old - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+#endif
+    }
+
 private:
 
 #if defined(_WIN32)
@@ -172,6 +185,14 @@ public:
         cv.wait(lock, [this] { return counter > 0; });
         --counter;
     }
+
+    bool try_acquire() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (counter <= 0)
+            return false;
+        --counter;
+        return true;
+    }
     
     static constexpr std::ptrdiff_t max() noexcept {
         return LeastMaxValue;
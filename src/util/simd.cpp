@@ -30,6 +30,7 @@ using std::string;
 
 #ifdef _WIN32
 #define cpuid(info,x)    __cpuidex(info,x,0)
+#define xgetbv(x)        _xgetbv(x)
 #else
 #ifdef __SSE2__
 inline void cpuid(int CPUInfo[4], int InfoType) {
@@ -42,6 +43,12 @@ inline void cpuid(int CPUInfo[4], int InfoType) {
 		"a" (InfoType), "c" (0)
 		);
 }
+
+inline unsigned long long xgetbv(unsigned index) {
+	unsigned eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a" (eax), "=d" (edx) : "c" (index));
+	return ((unsigned long long)edx << 32) | eax;
+}
 #endif
 #endif
 
@@ -81,13 +88,20 @@ Arch init_arch() {
 		flags |= POPCNT;
 	if ((info[2] & (1 << 19)) != 0)
 		flags |= SSE4_1;
+#ifdef WITH_AVX512
+	// The OS has to save the opmask and ZMM registers on context switches (XCR0 bits 1, 2, 5-7).
+	const bool os_avx512 = (info[2] & (1 << 27)) != 0 && (xgetbv(0) & 0xe6) == 0xe6;
+#endif
 	if (nids >= 7) {
 		cpuid(info, 7);
 		if ((info[1] & (1 << 5)) != 0)
 			flags |= AVX2;
 #ifdef WITH_AVX512
-		if ((info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0)
+		if ((info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0 && os_avx512) {
 			flags |= AVX512;
+			if ((info[2] & (1 << 14)) != 0)
+				flags |= AVX512_VPOPCNTDQ;
+		}
 #endif
 	}
 #endif
@@ -109,7 +123,7 @@ Arch init_arch() {
 		throw std::runtime_error("CPU does not support AVX2. Please compile the software from source.");
 #endif
 
-	if (flags & AVX512)
+	if ((flags & AVX512) && (flags & SSSE3) && (flags & POPCNT) && (flags & SSE4_1) && (flags & AVX2))
 		return Arch::AVX512;
 	if ((flags & SSSE3) && (flags & POPCNT) && (flags & SSE4_1) && (flags & AVX2))
 		return Arch::AVX2;
@@ -124,6 +138,11 @@ Arch arch() {
 	return a == Arch::None ? (a = init_arch()) : a;
 }
 
+bool supports(Flags flag) {
+	arch();
+	return (flags & flag) != 0;
+}
+
 string features() {
 	init_arch();
 	std::vector<string> r;
@@ -137,6 +156,10 @@ string features() {
 		r.push_back("sse4.1");
 	if (flags & AVX2)
 		r.push_back("avx2");
+	if (flags & AVX512)
+		r.push_back("avx512f avx512bw");
+	if (flags & AVX512_VPOPCNTDQ)
+		r.push_back("avx512vpopcntdq");
 	return r.empty() ? "None" : join(" ", r.begin(), r.end());
 }
 
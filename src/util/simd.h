@@ -49,8 +49,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace SIMD {
 
 enum class Arch { None, Generic, SSE4_1, AVX2, AVX512, NEON };
-enum Flags { SSSE3 = 1, POPCNT = 2, SSE4_1 = 4, AVX2 = 8, AVX512 = 16, NEON = 32 };
+enum Flags { SSSE3 = 1, POPCNT = 2, SSE4_1 = 4, AVX2 = 8, AVX512 = 16, NEON = 32, AVX512_VPOPCNTDQ = 64 };
 Arch arch();
+bool supports(Flags flag);
 
 std::string features();
 
@@ -24,10 +24,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "transpose16x16.h"
 #endif
 
-#if ARCH_ID == 2
+#if ARCH_ID == 2 || ARCH_ID == 3
 #include "transpose32x32.h"
 #endif
 
 #if ARCH_ID == 3
-static inline void transpose(const signed char** data, size_t n, signed char* out, const __m512i&) {}
-#endif
\ No newline at end of file
+#include "transpose64x64.h"
+#endif
@@ -343,4 +343,80 @@ static inline void transpose_offset(const signed char** data, size_t n, ptrdiff_
 	_mm256_store_si256(ptr++, r27);
 	_mm256_store_si256(ptr++, r23);
 	_mm256_store_si256(ptr++, r31);
-}
\ No newline at end of file
+}
+#ifdef __AVX512BW__
+
+#define UNPACK512_LO_HI_EPI16(a, b) t = r##a; r##a = _mm512_unpacklo_epi16(t, r##b); r##b = _mm512_unpackhi_epi16(t, r##b);
+#define UNPACK512_LO_HI_EPI32(a, b) t = r##a; r##a = _mm512_unpacklo_epi32(t, r##b); r##b = _mm512_unpackhi_epi32(t, r##b);
+#define UNPACK512_LO_HI_EPI64(a, b) t = r##a; r##a = _mm512_unpacklo_epi64(t, r##b); r##b = _mm512_unpackhi_epi64(t, r##b);
+// Transposes the 4x4 blocks of 128 bit lanes held in the registers a, b, c, d.
+#define TRANSPOSE512_4X4_I128(a, b, c, d) \
+	t0 = _mm512_shuffle_i64x2(a, b, 0x88); t1 = _mm512_shuffle_i64x2(a, b, 0xdd); \
+	t2 = _mm512_shuffle_i64x2(c, d, 0x88); t3 = _mm512_shuffle_i64x2(c, d, 0xdd); \
+	a = _mm512_shuffle_i64x2(t0, t2, 0x88); b = _mm512_shuffle_i64x2(t1, t3, 0x88); \
+	c = _mm512_shuffle_i64x2(t0, t2, 0xdd); d = _mm512_shuffle_i64x2(t1, t3, 0xdd);
+#define LOAD512(r) r = _mm512_loadu_si512((const __m512i*) * (data++) + offset);
+#define UNPACK512_GROUP8(a0, a1, a2, a3, a4, a5, a6, a7) \
+	UNPACK512_LO_HI_EPI16(a0, a1) UNPACK512_LO_HI_EPI16(a2, a3) UNPACK512_LO_HI_EPI16(a4, a5) UNPACK512_LO_HI_EPI16(a6, a7) \
+	UNPACK512_LO_HI_EPI32(a0, a2) UNPACK512_LO_HI_EPI32(a1, a3) UNPACK512_LO_HI_EPI32(a4, a6) UNPACK512_LO_HI_EPI32(a5, a7) \
+	UNPACK512_LO_HI_EPI64(a0, a4) UNPACK512_LO_HI_EPI64(a2, a6) UNPACK512_LO_HI_EPI64(a1, a5) UNPACK512_LO_HI_EPI64(a3, a7)
+
+// Transposes 32 rows of 32 16 bit scores: the 8x8 blocks within each 128 bit lane first, then the 4x4 blocks of lanes.
+static inline void transpose_offset(const int16_t** data, size_t n, ptrdiff_t offset, int16_t* out, __m512i) {
+	__m512i r0, r1, r2, r3, r4, r5, r6, r7, r8, r9, r10, r11, r12, r13, r14, r15, r16, r17, r18, r19, r20, r21, r22, r23, r24, r25, r26, r27, r28, r29, r30, r31, t, t0, t1, t2, t3;
+
+	LOAD512(r0) LOAD512(r1) LOAD512(r2) LOAD512(r3) LOAD512(r4) LOAD512(r5) LOAD512(r6) LOAD512(r7)
+	LOAD512(r8) LOAD512(r9) LOAD512(r10) LOAD512(r11) LOAD512(r12) LOAD512(r13) LOAD512(r14) LOAD512(r15)
+	LOAD512(r16) LOAD512(r17) LOAD512(r18) LOAD512(r19) LOAD512(r20) LOAD512(r21) LOAD512(r22) LOAD512(r23)
+	LOAD512(r24) LOAD512(r25) LOAD512(r26) LOAD512(r27) LOAD512(r28) LOAD512(r29) LOAD512(r30) LOAD512(r31)
+
+	UNPACK512_GROUP8(0, 1, 2, 3, 4, 5, 6, 7)
+	UNPACK512_GROUP8(8, 9, 10, 11, 12, 13, 14, 15)
+	UNPACK512_GROUP8(16, 17, 18, 19, 20, 21, 22, 23)
+	UNPACK512_GROUP8(24, 25, 26, 27, 28, 29, 30, 31)
+
+	TRANSPOSE512_4X4_I128(r0, r8, r16, r24)
+	TRANSPOSE512_4X4_I128(r1, r9, r17, r25)
+	TRANSPOSE512_4X4_I128(r2, r10, r18, r26)
+	TRANSPOSE512_4X4_I128(r3, r11, r19, r27)
+	TRANSPOSE512_4X4_I128(r4, r12, r20, r28)
+	TRANSPOSE512_4X4_I128(r5, r13, r21, r29)
+	TRANSPOSE512_4X4_I128(r6, r14, r22, r30)
+	TRANSPOSE512_4X4_I128(r7, r15, r23, r31)
+
+	__m512i* ptr = (__m512i*)out;
+	_mm512_store_si512(ptr++, r0);
+	_mm512_store_si512(ptr++, r4);
+	_mm512_store_si512(ptr++, r2);
+	_mm512_store_si512(ptr++, r6);
+	_mm512_store_si512(ptr++, r1);
+	_mm512_store_si512(ptr++, r5);
+	_mm512_store_si512(ptr++, r3);
+	_mm512_store_si512(ptr++, r7);
+	_mm512_store_si512(ptr++, r8);
+	_mm512_store_si512(ptr++, r12);
+	_mm512_store_si512(ptr++, r10);
+	_mm512_store_si512(ptr++, r14);
+	_mm512_store_si512(ptr++, r9);
+	_mm512_store_si512(ptr++, r13);
+	_mm512_store_si512(ptr++, r11);
+	_mm512_store_si512(ptr++, r15);
+	_mm512_store_si512(ptr++, r16);
+	_mm512_store_si512(ptr++, r20);
+	_mm512_store_si512(ptr++, r18);
+	_mm512_store_si512(ptr++, r22);
+	_mm512_store_si512(ptr++, r17);
+	_mm512_store_si512(ptr++, r21);
+	_mm512_store_si512(ptr++, r19);
+	_mm512_store_si512(ptr++, r23);
+	_mm512_store_si512(ptr++, r24);
+	_mm512_store_si512(ptr++, r28);
+	_mm512_store_si512(ptr++, r26);
+	_mm512_store_si512(ptr++, r30);
+	_mm512_store_si512(ptr++, r25);
+	_mm512_store_si512(ptr++, r29);
+	_mm512_store_si512(ptr++, r27);
+	_mm512_store_si512(ptr++, r31);
+}
+
+#endif
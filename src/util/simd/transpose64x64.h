@@ -0,0 +1,61 @@
+/****
+DIAMOND protein sequence aligner
+Copyright (C) 2012-2026 Benjamin J. Buchfink
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+#include <stddef.h>
+#include "../simd.h"
+#include "transpose32x32.h"
+
+#ifdef __AVX512BW__
+
+static inline void transpose(const signed char** data, size_t n, signed char* out, const __m512i&) {
+	static constexpr int REV4[16] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+	__m512i r[64], t, t0, t1, t2, t3;
+	const size_t d = 64 - n;
+	for (size_t i = 0; i < d; ++i)
+		r[i] = _mm512_setzero_si512();
+	for (size_t i = d; i < 64; ++i)
+		r[i] = _mm512_loadu_si512((const __m512i*)*(data++));
+
+	for (int i = 0; i < 64; i += 2) {
+		t = r[i]; r[i] = _mm512_unpacklo_epi8(t, r[i + 1]); r[i + 1] = _mm512_unpackhi_epi8(t, r[i + 1]);
+	}
+	for (int i = 0; i < 64; ++i)
+		if ((i & 2) == 0) {
+			t = r[i]; r[i] = _mm512_unpacklo_epi16(t, r[i + 2]); r[i + 2] = _mm512_unpackhi_epi16(t, r[i + 2]);
+		}
+	for (int i = 0; i < 64; ++i)
+		if ((i & 4) == 0) {
+			t = r[i]; r[i] = _mm512_unpacklo_epi32(t, r[i + 4]); r[i + 4] = _mm512_unpackhi_epi32(t, r[i + 4]);
+		}
+	for (int i = 0; i < 64; ++i)
+		if ((i & 8) == 0) {
+			t = r[i]; r[i] = _mm512_unpacklo_epi64(t, r[i + 8]); r[i + 8] = _mm512_unpackhi_epi64(t, r[i + 8]);
+		}
+	// Register 16 * g + k now holds column REV4[k] of each lane for the rows 16 * g ... 16 * g + 15.
+	for (int k = 0; k < 16; ++k) {
+		TRANSPOSE512_4X4_I128(r[k], r[16 + k], r[32 + k], r[48 + k])
+	}
+
+	__m512i* ptr = (__m512i*)out;
+	for (int i = 0; i < 64; ++i)
+		_mm512_store_si512(ptr++, r[(i & ~15) + REV4[i & 15]]);
+}
+
+#endif
@@ -26,7 +26,7 @@ namespace DISPATCH_ARCH { namespace SIMD {
 template<>
 struct Vector<int8_t> {
 
-	static constexpr size_t CHANNELS = 32;
+	static constexpr size_t LANES = 64;
 
 	Vector()
 	{}
@@ -46,27 +46,27 @@ struct Vector<int8_t> {
 template<>
 struct Vector<int16_t> {
 
-	static constexpr size_t CHANNELS = 16;
+	static constexpr size_t LANES = 32;
 
 	Vector()
 	{}
 
 	Vector(const int16_t* p) :
-		v(_mm256_loadu_si256((const __m256i*)p))
+		v(_mm512_loadu_si512((const __m512i*)p))
 	{}
 
-	operator __m256i() const {
+	operator __m512i() const {
 		return v;
 	}
 
-	__m256i v;
+	__m512i v;
 
 };
 
 template<>
 struct Vector<int32_t> {
 
-	static constexpr size_t CHANNELS = 1;
+	static constexpr size_t LANES = 1;
 
 	Vector()
 	{}
@@ -83,4 +83,50 @@ struct Vector<int32_t> {
 
 };
 
+template<>
+struct Traits<float> {
+	static constexpr size_t LANES = 16;
+	using Register = __m512;
+};
+
+static inline __m512 add(__m512 a, __m512 b) {
+	return _mm512_add_ps(a, b);
+}
+
+static inline __m512 zero(__m512) {
+	return _mm512_setzero_ps();
+}
+
+static inline __m512 set(float x, __m512) {
+	return _mm512_set1_ps(x);
+}
+
+static inline __m512 unaligned_load(const float* p, __m512) {
+	return _mm512_loadu_ps(p);
+}
+
+static inline __m512 load(const float* p, __m512) {
+	return _mm512_load_ps(p);
+}
+
+static inline void unaligned_store(__m512 v, float* p) {
+	_mm512_storeu_ps(p, v);
+}
+
+static inline void store(__m512 v, float* p) {
+	_mm512_store_ps(p, v);
+}
+
+static inline __m512 mul(__m512 a, __m512 b) {
+	return _mm512_mul_ps(a, b);
+}
+
+static inline __m512 fmadd(__m512 a, __m512 b, __m512 c) {
+	return _mm512_fmadd_ps(a, b, c);
+}
+
+static inline float hsum(__m512 a) {
+	return _mm512_reduce_add_ps(a);
+}
+
 }}
\ No newline at end of file
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <system_error>
 #include <random>
 #include <cstdint>
+#include <fstream>
 
 #include "system.h"
 #include "../string/string.h"
@@ -245,6 +246,45 @@ double total_ram() {
 #endif
 }
 
+size_t l2_cache_size() {
+#if defined(_WIN32)
+	DWORD len = 0;
+	GetLogicalProcessorInformation(nullptr, &len);
+	std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+	if (info.empty() || !GetLogicalProcessorInformation(info.data(), &len))
+		return 0;
+	for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& i : info)
+		if (i.Relationship == RelationCache && i.Cache.Level == 2 && i.Cache.Type != CacheInstruction)
+			return i.Cache.Size;
+	return 0;
+#elif defined(__APPLE__)
+	uint64_t size = 0;
+	size_t len = sizeof(size);
+	return sysctlbyname("hw.l2cachesize", &size, &len, nullptr, 0) == 0 ? (size_t)size : 0;
+#else
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	if (size > 0)
+		return (size_t)size;
+#endif
+	for (int i = 0; i < 8; ++i) {
+		const string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i) + '/';
+		std::ifstream level_file(dir + "level"), type_file(dir + "type"), size_file(dir + "size");
+		int level = 0;
+		string type;
+		size_t size = 0;
+		char unit = 0;
+		if (!(level_file >> level) || !(type_file >> type) || !(size_file >> size))
+			break;
+		if (level != 2 || type == "Instruction")
+			continue;
+		size_file >> unit;
+		return unit == 'K' ? size << 10 : (unit == 'M' ? size << 20 : size);
+	}
+	return 0;
+#endif
+}
+
 tuple<char*, size_t, int> mmap_file(const char* filename) {
 #ifdef WIN32
 	throw std::runtime_error("Memory mapping not supported on Windows.");
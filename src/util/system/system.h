@@ -46,6 +46,7 @@ size_t getPeakRSS();
 void log_rss();
 size_t file_size(const char* name);
 double total_ram();
+size_t l2_cache_size();
 std::tuple<char*, size_t, int> mmap_file(const char* filename);
 void unmap_file(char* ptr, size_t size, int fd);
 void mkdir(const std::string& dir);
@@ -264,8 +264,8 @@ struct TextBuffer
 		return *this;
 	}
 
-	template<typename T>
-	TextBuffer& operator<<(const std::vector<T> &v)
+	template<typename T, typename Alloc>
+	TextBuffer& operator<<(const std::vector<T, Alloc> &v)
 	{
 		const size_t l = v.size() * sizeof(T);
 		reserve(l);